@@ -16,9 +16,20 @@
 #ifndef QC_REPOSITORY_CCDBDATABASE_H
 #define QC_REPOSITORY_CCDBDATABASE_H
 
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <vector>
+
 #include <CCDB/CcdbApi.h>
+#include <curl/curl.h>
 
+#include "QualityControl/ContentDeduplicator.h"
 #include "QualityControl/DatabaseInterface.h"
+#include "QualityControl/Spool.h"
+#include "QualityControl/ThreadPool.h"
+#include "QualityControl/VersionCache.h"
 
 namespace o2::quality_control::repository
 {
@@ -50,14 +61,65 @@ namespace o2::quality_control::repository
 class CcdbDatabase : public DatabaseInterface
 {
  public:
-  CcdbDatabase() = default;
+  CcdbDatabase();
   virtual ~CcdbDatabase();
 
   void connect(std::string host, std::string database, std::string username, std::string password) override;
   void connect(const std::unordered_map<std::string, std::string>& config) override;
+  /// \brief Stores the object, unless it is identical to the previous version stored by this client (see
+  /// setDeduplicationPeriod()).
   void store(std::shared_ptr<o2::quality_control::core::MonitorObject> mo) override;
+  /// \brief Serializes the object right away and uploads it in the background, together with the other objects.
+  ///
+  /// At most maxConcurrentUploads uploads run at the same time, each on a connection which is kept open for the
+  /// next ones. If many uploads are pending, the call waits for the oldest one. When the spool is enabled, the
+  /// object is appended to it instead of waiting, and the objects which could not be uploaded because the CCDB could
+  /// not be reached or was overloaded are appended to it too.
+  void storeAsync(std::shared_ptr<o2::quality_control::core::MonitorObject> mo) override;
+  void flush() override;
+  /// \brief Sets the number of uploads of storeAsync() running concurrently. Also set with "maxConcurrentUploads"
+  /// in the configuration given to connect().
+  void setMaxConcurrentUploads(size_t uploads);
+  /// \brief Sets the period (s) during which an object identical to the previous version of its path is not stored
+  /// again, 0 by default, which stores all the objects. Also set with "deduplicationPeriod" in the configuration given
+  /// to connect().
+  ///
+  /// The previous version, valid for years, stays the one valid at the time of the skipped objects. Identical means
+  /// the same streamed object and metadata, which is decided with their hash, without asking the CCDB. When it is
+  /// enabled, each object is streamed once more to be hashed.
+  void setDeduplicationPeriod(long seconds);
+  /// \brief Enables the local spool of the objects which cannot be uploaded, replayed to the CCDB in the background.
+  ///
+  /// Also enabled with "spoolDirectory" in the configuration given to connect(), with "spoolMaxSize" (MB) and
+  /// "spoolReplayRate" (objects per second), raised to twice the rate at which the objects are spooled. The objects
+  /// left in the directory by a previous process are replayed. The ones refused by the CCDB, and the ones which
+  /// could not be uploaded after 100 attempts, are moved to the quarantine file of the directory.
+  void enableSpool(const std::string& directory, uint64_t maxSize, double replayRate);
+  /// \brief Returns the hit ratio and memory use (bytes) of the caches and the number, size (bytes) and age (s) of
+  /// the spooled objects, if the spool is enabled.
+  std::unordered_map<std::string, double> getMetrics() override;
+  /// \brief Retrieves the object valid at the timestamp, in one request.
+  ///
+  /// The retrieved versions are kept in a cache, limited by "cacheMaxSize" (MB, default 256) in the configuration
+  /// given to connect(). A cached version is not sent again by the CCDB if it is still the one valid at the timestamp.
   core::MonitorObject* retrieve(std::string path, std::string objectName, long timestamp = 0) override;
+  /// \brief Retrieves the objects with at most maxConcurrentRetrievals requests running at the same time.
+  void retrieveMany(std::string taskName, const std::vector<std::string>& objectNames, long timestamp,
+                    const RetrieveCallback& callback) override;
+  /// \brief Sets the number of requests of retrieveMany() running concurrently, 8 by default. Also set with
+  /// "maxConcurrentRetrievals" in the configuration given to connect().
+  void setMaxConcurrentRetrievals(size_t retrievals);
+  /// \brief Lists the versions with one request, filtered by metadata by the CCDB, and retrieves their objects
+  /// one by one when asked, through the cache.
+  std::unique_ptr<VersionIterator> retrieveVersions(std::string taskName, std::string objectName, long from, long to,
+                                                    const std::map<std::string, std::string>& metadataFilter = {}) override;
+  /// \brief Retrieves the current version of the object as JSON.
+  ///
+  /// The JSON of each version is computed once and kept in a cache, limited by "jsonCacheMaxSize" (MB, default 64).
   std::string retrieveJson(std::string path, std::string objectName) override;
+  /// \brief Sets the memory limits (bytes) of the cache of the retrieved objects and of the one of their JSON. 0
+  /// disables a cache.
+  void setCacheSizes(size_t objects, size_t json);
   void disconnect() override;
   void prepareTaskDataContainer(std::string taskName) override;
   std::vector<std::string> getPublishedObjectNames(std::string taskName) override;
@@ -80,8 +142,29 @@ class CcdbDatabase : public DatabaseInterface
    * here.
    */
   static void loadDeprecatedStreamerInfos();
+  /// \brief Loads the deprecated StreamerInfos, once per process. The objects stored as TFiles, which contain their
+  /// StreamerInfos, do not need them, thus only the retrieval of the older objects calls it.
+  static void ensureDeprecatedStreamerInfos();
   void init();
 
+  /// \brief Sends a GET request and returns the response code, 0 if the request failed.
+  long get(const std::string& url, const std::vector<std::string>& requestHeaders, std::string& content,
+           std::map<std::string, std::string>& headers);
+  /// \brief Returns the version of the object valid at the timestamp, from the cache if it is still the current one.
+  std::shared_ptr<const CachedVersion> retrieveVersion(const std::string& fullPath, long timestamp);
+  /// \brief Returns the version of the object with the id given by a listing, from the cache if it is there.
+  std::shared_ptr<const CachedVersion> retrieveVersionById(const std::string& fullPath, const ObjectVersion& objectVersion,
+                                                           const std::string& id);
+  static core::MonitorObject* deserialize(const CachedVersion& version, const std::string& fullPath);
+  /// \brief Returns the hash of the streamed object and of its metadata, 0 if the deduplication is disabled.
+  size_t contentHash(const core::MonitorObject& mo, const std::map<std::string, std::string>& metadata);
+  /// \brief Uploads the serialized object on one of the connections. Throws DatabaseException if it fails.
+  void upload(const SerializedObject& object);
+  /// \brief Waits for the oldest upload of storeAsync() and reports its failure, if any.
+  bool waitForOldestUpload();
+  CURL* acquireConnection();
+  void releaseConnection(CURL* connection);
+
   /**
    * Return the listing of folder and/or objects in the subpath.
    * @param subpath The folder we want to list the children of.
@@ -91,6 +174,22 @@ class CcdbDatabase : public DatabaseInterface
   std::string getListingAsString(std::string subpath = "", std::string accept = "text/plain");
   o2::ccdb::CcdbApi ccdbApi;
   std::string mUrl = "";
+
+  // asynchronous storage
+  size_t mMaxConcurrentUploads = 4;
+  std::unique_ptr<core::ThreadPool> mUploadPool;
+  std::deque<std::pair<std::string /*path*/, std::future<void>>> mPendingUploads;
+  std::mutex mConnectionsMutex;
+  std::vector<CURL*> mConnections; // idle connections, kept open between the uploads
+  std::unique_ptr<Spool> mSpool;
+
+  ContentDeduplicator mDeduplicator;
+
+  size_t mMaxConcurrentRetrievals = 8;
+  std::unique_ptr<core::ThreadPool> mRetrievalPool;
+
+  VersionCache mObjectCache{ 256 * 1024 * 1024 };
+  VersionCache mJsonCache{ 64 * 1024 * 1024 };
 };
 
 } // namespace o2::quality_control::repository
@@ -16,13 +16,29 @@
 #ifndef QC_CHECKER_CHECKINTERFACE_H
 #define QC_CHECKER_CHECKINTERFACE_H
 
+#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 #include <Rtypes.h>
 
+#include "QualityControl/Activity.h"
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/Quality.h"
 
+namespace o2::ccdb
+{
+class CcdbApi;
+}
+
+namespace o2::quality_control::repository
+{
+class DatabaseInterface;
+}
+
+class TClass;
+
 using namespace o2::quality_control::core;
 
 namespace o2::quality_control::checker
@@ -81,10 +97,35 @@ class CheckInterface
 
   bool isObjectCheckable(const MonitorObject* mo);
 
-  //  private:
-  //    std::string mName;
-
-  ClassDef(CheckInterface, 1)
+  // Setters and getters, the Checker calls the setters before configure()
+  /// \brief Sets the URL of the conditions database. The connection is only made when a condition is retrieved.
+  void setCcdbUrl(const std::string& url);
+  /// \brief Sets the repository where QC stores the objects, to retrieve the ones stored earlier.
+  void setDatabase(std::shared_ptr<o2::quality_control::repository::DatabaseInterface> database);
+  void setActivity(const Activity& activity);
+  const Activity& getActivity() const;
+  void setCustomParameters(const std::unordered_map<std::string, std::string>& parameters);
+
+ protected:
+  TObject* retrieveCondition(std::string path, std::map<std::string, std::string> metadata = {}, long timestamp = -1);
+  /// \brief Retrieves the object stored by QC at the path (e.g. "qc/<detector>/<task>/<object>") with all the metadata
+  /// given, the version valid at the timestamp (ms since epoch, 0 for now). With metadata, it is the latest version
+  /// started at the timestamp, if it has not expired, found with one listing of the versions. nullptr if there is
+  /// none or no database.
+  std::unique_ptr<MonitorObject> retrieveObject(const std::string& path,
+                                                const std::map<std::string, std::string>& metadata = {},
+                                                long timestamp = 0);
+
+  std::unordered_map<std::string, std::string> mCustomParameters; //!
+
+ private:
+  std::string mCcdbUrl;                                                          //!
+  std::shared_ptr<o2::ccdb::CcdbApi> mCcdbApi;                                   //!
+  std::shared_ptr<o2::quality_control::repository::DatabaseInterface> mDatabase; //!
+  Activity mActivity;                                                            //!
+  TClass* mAcceptedClass = nullptr;                                              //!
+
+  ClassDef(CheckInterface, 2)
 };
 
 } // namespace o2::quality_control::checker
@@ -0,0 +1,90 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CheckProfiler.h
+///
+
+#ifndef QC_CHECKER_CHECKPROFILER_H
+#define QC_CHECKER_CHECKPROFILER_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace o2::quality_control::checker
+{
+
+/// \brief Statistics of the durations of one kind of call (e.g. check() of a given check).
+///
+/// The count, the total and the maximum cover the whole lifetime of the object, while the percentiles are computed
+/// over a window of the most recent calls, so that the memory footprint stays constant during a long run.
+class CallStatistics
+{
+ public:
+  explicit CallStatistics(size_t windowSize = 1000);
+  ~CallStatistics() = default;
+
+  void add(double durationUs);
+
+  uint64_t getCount() const { return mCount; }
+  double getTotal() const { return mTotal; }
+  double getMax() const { return mMax; }
+  double getMean() const { return mCount ? mTotal / mCount : 0; }
+
+  /// \brief Returns the requested percentile (0-100) of the durations in the window of the most recent calls.
+  double getPercentile(double percentile) const;
+
+ private:
+  uint64_t mCount = 0;
+  double mTotal = 0;
+  double mMax = 0;
+  size_t mWindowSize;
+  size_t mWindowPosition = 0;
+  std::vector<double> mWindow;
+};
+
+/// \brief Accumulates the durations of check() and beautify() calls made by a Checker.
+///
+/// Durations are aggregated both per check name and per check class, the latter giving a view on the cost of a check
+/// implementation regardless of how many times it is configured.
+class CheckProfiler
+{
+ public:
+  enum class Call {
+    Check,
+    Beautify
+  };
+
+  CheckProfiler() = default;
+  ~CheckProfiler() = default;
+
+  /// \brief Records the duration of one call of a check.
+  void record(const std::string& checkName, const std::string& className, Call call, double durationUs);
+
+  /// Statistics keyed by "<check name>/<call>"
+  const std::map<std::string, CallStatistics>& getChecksStatistics() const { return mChecksStatistics; }
+  /// Statistics keyed by "<class name>/<call>"
+  const std::map<std::string, CallStatistics>& getClassesStatistics() const { return mClassesStatistics; }
+
+  /// \brief Returns a human readable table with all the statistics.
+  std::string dump() const;
+
+  static std::string callToString(Call call);
+
+ private:
+  std::map<std::string, CallStatistics> mChecksStatistics;
+  std::map<std::string, CallStatistics> mClassesStatistics;
+};
+
+} // namespace o2::quality_control::checker
+
+#endif // QC_CHECKER_CHECKPROFILER_H
@@ -25,13 +25,17 @@
 #include <vector>
 // O2
 #include <Common/Timer.h>
+#include <Framework/CompletionPolicy.h>
 #include <Framework/Task.h>
 #include <Headers/DataHeader.h>
 // QC
 #include "QualityControl/CheckInterface.h"
+#include "QualityControl/CheckProfiler.h"
 #include "QualityControl/DatabaseInterface.h"
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/QcInfoLogger.h"
+#include "QualityControl/TrendingExtractor.h"
+#include "QualityControl/TrendingStore.h"
 
 namespace o2::framework
 {
@@ -65,6 +69,13 @@ class Checker : public framework::Task
   /// Constructor
   Checker(std::string checkerName, std::string taskName, std::string configurationSource);
 
+  /// \brief Constructor of a Checker serving several tasks at once.
+  ///
+  /// The Checker gets one input and one output per task. Incoming MonitorObject arrays are routed to the
+  /// output of their task by the DataDescription of the input. All the tasks share the database connection,
+  /// the monitoring collector and the cache of loaded checks of this Checker.
+  Checker(std::string checkerName, std::vector<std::string> taskNames, std::string configurationSource);
+
   /// Destructor
   ~Checker() override;
 
@@ -74,13 +85,32 @@ class Checker : public framework::Task
   /// \brief Checker process callback
   void run(framework::ProcessingContext& ctx) override;
 
-  framework::InputSpec getInputSpec() { return mInputSpec; };
+  /// \brief Checks, trends and stores the MonitorObject, as run() does for each received object. The qualities of
+  /// its checks are set in the object.
+  void process(std::shared_ptr<MonitorObject> mo);
+
+  /// \brief Sets the database where the objects are stored, otherwise created by init() out of the configuration.
+  void setDatabase(std::shared_ptr<o2::quality_control::repository::DatabaseInterface> database) { mDatabase = database; }
+
+  framework::InputSpec getInputSpec() { return mInputSpecs.front(); };
+  std::vector<framework::InputSpec> getInputSpecs() { return mInputSpecs; };
 
-  framework::OutputSpec getOutputSpec() { return mOutputSpec; };
+  framework::OutputSpec getOutputSpec() { return mOutputSpecs.front(); };
+  std::vector<framework::OutputSpec> getOutputSpecs() { return mOutputSpecs; };
+
+  std::string getName() { return mCheckerName; };
 
   /// \brief Unified DataDescription naming scheme for all checkers
   static o2::header::DataDescription createCheckerDataDescription(const std::string taskName);
 
+  /// \brief Prefix of the names of Checkers which serve many tasks.
+  static std::string createCheckerIdString();
+
+  /// \brief Completion policy callback of Checkers serving many tasks.
+  ///
+  /// Inputs of different tasks arrive independently, so the Checker consumes as soon as any of them is present.
+  static framework::CompletionPolicy::CompletionOp completionPolicyCallback(gsl::span<framework::PartRef const> const& inputs);
+
  private:
   /**
    * \brief Evaluate the quality of a MonitorObject.
@@ -101,10 +131,21 @@ class Checker : public framework::Task
    */
   void store(std::shared_ptr<MonitorObject> mo);
 
+  /**
+   * \brief Append the quantities declared for trending of this MonitorObject to the trending store.
+   */
+  void trend(const MonitorObject& mo);
+
   /**
    * \brief Send the MonitorObject on FairMQ to whoever is listening.
    */
-  void send(std::unique_ptr<TObjArray>& mo, framework::DataAllocator& allocator);
+  void send(std::unique_ptr<TObjArray>& mo, const framework::OutputSpec& outputSpec, framework::DataAllocator& allocator);
+
+  /**
+   * \brief Find the output which corresponds to the input with the given DataDescription.
+   * @return Index of the matching input and output or -1 if the description is not served by this Checker.
+   */
+  int findRoute(const o2::header::DataDescription& description) const;
 
   /**
    * \brief Load a library.
@@ -124,20 +165,39 @@ class Checker : public framework::Task
    */
   CheckInterface* getCheck(std::string checkName, std::string className);
 
+  /**
+   * \brief Tells if the check accepts the class of the object. The answer is cached for each check and class.
+   */
+  bool isBound(const std::string& checkName, CheckInterface* checkInstance, const MonitorObject* mo);
+
+  /**
+   * \brief Send the durations of check() and beautify() calls to the monitoring.
+   */
+  void sendCheckTimings();
+
   // General state
   std::string mCheckerName;
+  std::vector<std::string> mTaskNames;
   std::string mConfigurationSource;
   o2::quality_control::core::QcInfoLogger& mLogger;
   std::shared_ptr<o2::quality_control::repository::DatabaseInterface> mDatabase;
 
   // DPL
-  o2::framework::InputSpec mInputSpec;
-  o2::framework::OutputSpec mOutputSpec;
+  std::vector<o2::framework::InputSpec> mInputSpecs;
+  std::vector<o2::framework::OutputSpec> mOutputSpecs;
+
+  // Trending
+  std::unique_ptr<o2::quality_control::core::TrendingStore> mTrendingStore;
+  std::map<std::string /*taskName*/, std::vector<o2::quality_control::core::TrendingExtractor>> mTrendingExtractors;
 
   // Checks cache
   std::vector<std::string> mLibrariesLoaded;
   std::map<std::string, CheckInterface*> mChecksLoaded;
   std::map<std::string, TClass*> mClassesLoaded;
+  std::map<std::pair<std::string /*checkName*/, TClass*>, bool> mChecksBindings;
+  std::map<std::string /*checkName*/, std::unordered_map<std::string, std::string>> mChecksParameters;
+  o2::quality_control::core::Activity mActivity;
+  std::string mConditionUrl;
 
   // monitoring
   std::shared_ptr<o2::monitoring::Monitoring> mCollector;
@@ -145,6 +205,9 @@ class Checker : public framework::Task
   std::chrono::system_clock::time_point endLastObject;
   int mTotalNumberHistosReceived;
   AliceO2::Common::Timer timer;
+  CheckProfiler mProfiler;
+  bool mDumpCheckTimings = false;
+  bool mStripDecorations = false;
 };
 
 } // namespace o2::quality_control::checker
@@ -17,11 +17,13 @@
 #define QC_CHECKERFACTORY_H
 
 #include <string>
+#include <vector>
 
 namespace o2::framework
 {
 struct DataProcessorSpec;
-}
+struct CompletionPolicy;
+} // namespace o2::framework
 
 namespace o2::quality_control::checker
 {
@@ -34,6 +36,18 @@ class CheckerFactory
   virtual ~CheckerFactory() = default;
 
   framework::DataProcessorSpec create(std::string checkerName, std::string taskName, std::string configurationSource);
+
+  /// \brief Creates a Checker which serves several tasks.
+  ///
+  /// \param checkerName - name of the Checker, it should start with Checker::createCheckerIdString() to have the
+  ///                      right completion policy applied by customizeInfrastructure()
+  /// \param taskNames - names of the tasks, whose MonitorObjects should be checked by this Checker
+  /// \param configurationSource - absolute path to configuration file, preceded with backend (f.e. "json://")
+  framework::DataProcessorSpec create(std::string checkerName, std::vector<std::string> taskNames, std::string configurationSource);
+
+  /// \brief Provides necessary customization of the Checkers serving many tasks.
+  /// \param policies - completion policies vector
+  static void customizeInfrastructure(std::vector<framework::CompletionPolicy>& policies);
 };
 
 } // namespace o2::quality_control::checker
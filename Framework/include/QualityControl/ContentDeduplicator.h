@@ -0,0 +1,66 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ContentDeduplicator.h
+///
+
+#ifndef QC_REPOSITORY_CONTENTDEDUPLICATOR_H
+#define QC_REPOSITORY_CONTENTDEDUPLICATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace o2::quality_control::repository
+{
+
+/// \brief Remembers the hash of the latest content stored in each path, to skip the identical ones for a period.
+///
+/// It is thread-safe. The content is only known by its hash, the identical contents are not compared.
+class ContentDeduplicator
+{
+ public:
+  /// \param period - the period (s) during which an identical content is skipped, 0 disables the deduplication
+  explicit ContentDeduplicator(long period = 0);
+
+  /// \brief Sets the period (s), negative values are 0, and forgets the contents.
+  void setPeriod(long seconds);
+  long getPeriod() const;
+  /// \brief Returns true if the content was stored in the path less than the period before the timestamp (ms),
+  /// otherwise remembers it as the latest one of the path.
+  bool isDuplicate(const std::string& path, size_t hash, long timestamp);
+  /// \brief Forgets the content of the path, if it is still the latest one, after it could not be stored.
+  void forget(const std::string& path, size_t hash);
+  /// \brief Returns the number of contents found duplicate.
+  uint64_t getSkipped() const { return mSkipped; }
+
+  /// \brief Returns the hash of the serialized content and of its metadata.
+  static size_t hash(std::string_view content, const std::map<std::string, std::string>& metadata);
+
+ private:
+  struct StoredContent {
+    size_t hash = 0;
+    long timestamp = 0; // ms since epoch
+  };
+
+  mutable std::mutex mMutex;
+  long mPeriod; // s
+  std::unordered_map<std::string /*path*/, StoredContent> mContents;
+  std::atomic<uint64_t> mSkipped = 0;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_CONTENTDEDUPLICATOR_H
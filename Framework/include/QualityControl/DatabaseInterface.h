@@ -16,6 +16,8 @@
 #ifndef QC_REPOSITORY_DATABASEINTERFACE_H
 #define QC_REPOSITORY_DATABASEINTERFACE_H
 
+#include <functional>
+#include <map>
 #include <string>
 #include <memory>
 #include <vector>
@@ -26,6 +28,45 @@
 namespace o2::quality_control::repository
 {
 
+/// \brief The metadata key of the run number of the stored objects, written and filtered on by all the backends.
+constexpr const char* runMetadataKey = "RunNumber";
+
+/// \brief A version of an object in the repository.
+struct ObjectVersion {
+  long validFrom = 0;  // ms since epoch
+  long validUntil = 0; // ms since epoch
+  std::map<std::string, std::string> metadata;
+
+  /// \brief Returns true if the version has all the metadata of the filter, with the same values.
+  bool matches(const std::map<std::string, std::string>& filter) const
+  {
+    for (const auto& [key, value] : filter) {
+      auto found = metadata.find(key);
+      if (found == metadata.end() || found->second != value) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+/// \brief Iterates over versions of an object, in the order of their validity start.
+///
+/// The object of a version is only retrieved if object() is called, e.g. the metadata of all the versions can be
+/// browsed without transferring any object.
+class VersionIterator
+{
+ public:
+  virtual ~VersionIterator() = default;
+  /// \brief Moves to the next version, the first one when called for the first time. Returns false if there is none,
+  /// the last version then stays the current one.
+  virtual bool next() = 0;
+  /// \brief Returns the current version.
+  virtual const ObjectVersion& version() const = 0;
+  /// \brief Retrieves the object of the current version, nullptr if it cannot be read.
+  virtual std::unique_ptr<o2::quality_control::core::MonitorObject> object() = 0;
+};
+
 /// \brief The interface to the MonitorObject's repository.
 ///
 /// \author Barthélémy von Haller
@@ -60,15 +101,60 @@ class DatabaseInterface
    */
   virtual void store(std::shared_ptr<o2::quality_control::core::MonitorObject> mo) = 0;
 
+  /**
+   * Stores the MonitorObject in the database, possibly later and concurrently with other objects.
+   * The object must not be modified until flush() returns. By default, it is stored right away with store().
+   * @param mo The MonitorObject to serialize and store.
+   */
+  virtual void storeAsync(std::shared_ptr<o2::quality_control::core::MonitorObject> mo) { store(mo); }
+
+  /**
+   * Waits until the objects given to storeAsync() are stored. The objects which could not be stored are reported in
+   * the logs.
+   */
+  virtual void flush() {}
+
+  /**
+   * Returns the metrics of the database client, by name, e.g. the state of its local buffers.
+   */
+  virtual std::unordered_map<std::string, double> getMetrics() { return {}; }
+
   /**
    * Look up an object of a task and return it.
    * \details It returns the object if found or nullptr if not.
    * TODO evaluate whether we should have more methods to retrieve objects of different types (with or without
    * templates)
-   * TODO evaluate whether we should have a method to retrieve a list of objects (optimization)
+   * @see retrieveMany to retrieve several objects at once
    */
   virtual o2::quality_control::core::MonitorObject* retrieve(std::string taskName, std::string objectName, long timestamp = 0) = 0;
 
+  using RetrieveCallback =
+    std::function<void(const std::string& objectName, std::unique_ptr<o2::quality_control::core::MonitorObject> mo)>;
+  /**
+   * Look up several objects of a task, as retrieve() would, and give each of them to the callback as soon as it is
+   * retrieved.
+   * \details The callback is called once per object name, in the order the objects arrive, with nullptr if the object
+   * is not found. It is called by the calling thread, before the method returns. By default, the objects are retrieved
+   * one by one with retrieve().
+   */
+  virtual void retrieveMany(std::string taskName, const std::vector<std::string>& objectNames, long timestamp,
+                            const RetrieveCallback& callback)
+  {
+    for (const auto& objectName : objectNames) {
+      callback(objectName, std::unique_ptr<o2::quality_control::core::MonitorObject>(retrieve(taskName, objectName, timestamp)));
+    }
+  }
+
+  /**
+   * Look up the versions of an object of a task whose validity starts within [from, to] (ms since epoch).
+   * \details Only the versions having all the metadata of the filter, with the same values, are given, e.g.
+   * {{"quality", "3"}} or {{runMetadataKey, "1234"}}. The backends filter on the server side wherever they can. The
+   * iterator must not outlive the database.
+   */
+  virtual std::unique_ptr<VersionIterator> retrieveVersions(std::string taskName, std::string objectName, long from,
+                                                            long to,
+                                                            const std::map<std::string, std::string>& metadataFilter = {}) = 0;
+
   /**
    * Returns JSON encoded object
    */
@@ -0,0 +1,96 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   Decorations.h
+///
+
+#ifndef QC_CHECKER_DECORATIONS_H
+#define QC_CHECKER_DECORATIONS_H
+
+#include <string>
+#include <utility>
+
+#include <TList.h>
+
+#include "QualityControl/MonitorObject.h"
+
+/// \brief Named decorations (TPaveText, TLine, ...) attached to the objects by the checks.
+///
+/// A decoration is stored in the list of functions of the histogram or graph, like any primitive, but it is
+/// tagged with an id derived from its name (in TObject::fUniqueID). beautify() can then get the decoration it
+/// created during the previous cycle and update it in place instead of appending a new primitive each time.
+/// The objects which are kept across cycles thus carry one instance of each decoration and not one per cycle.
+///
+/// Example:
+/// \code
+/// auto* msg = getDecoration<TPaveText>(mo, "msg", 0.5, 0.5, 0.9, 0.75, "NDC");
+/// msg->Clear();
+/// msg->AddText("OK");
+/// \endcode
+namespace o2::quality_control::checker::decorations
+{
+
+/// \brief Returns the list holding the decorations of the object (TH1 and TGraph), nullptr if it has none.
+TList* getList(TObject* object);
+
+/// \brief Returns the id stored in TObject::fUniqueID to tag the decoration of this name.
+/// The highest bit is always set, it is the one used to recognise decorations.
+unsigned int getId(const std::string& name);
+
+/// \brief Returns true if the object is tagged as a decoration.
+bool isDecoration(const TObject* object);
+
+/// \brief Returns the decoration of this name attached to the object, nullptr if there is none.
+TObject* find(TObject* object, const std::string& name);
+
+/// \brief Attaches the decoration to the object under this name, replacing (and deleting) the previous one.
+/// The object takes the ownership of the decoration. If it cannot hold decorations, the decoration is deleted
+/// and nullptr is returned.
+TObject* set(TObject* object, const std::string& name, TObject* decoration);
+
+/// \brief Removes and deletes the decoration of this name. Returns false if there was none.
+bool remove(TObject* object, const std::string& name);
+
+/// \brief Removes and deletes all the decorations of the object. Returns how many were removed.
+size_t strip(TObject* object);
+
+} // namespace o2::quality_control::checker::decorations
+
+namespace o2::quality_control::checker
+{
+
+/// \brief Returns the decoration of this name, creating it with the arguments if it does not exist yet.
+///
+/// The decoration is reused as it is if it exists, it is up to the caller to reset its content. If the existing
+/// decoration is not a T, it is replaced by a new one. Returns nullptr if the object cannot hold decorations.
+template <typename T, typename... Args>
+T* getDecoration(MonitorObject* mo, const std::string& name, Args&&... args)
+{
+  TObject* object = mo->getObject();
+  if (auto* existing = dynamic_cast<T*>(decorations::find(object, name))) {
+    return existing;
+  }
+  if (decorations::getList(object) == nullptr) {
+    return nullptr;
+  }
+  return static_cast<T*>(decorations::set(object, name, new T(std::forward<Args>(args)...)));
+}
+
+/// \brief Replaces the decoration of this name by a new one, e.g. when it is easier to recreate it than to update it.
+template <typename T>
+T* setDecoration(MonitorObject* mo, const std::string& name, T* decoration)
+{
+  return static_cast<T*>(decorations::set(mo->getObject(), name, decoration));
+}
+
+} // namespace o2::quality_control::checker
+
+#endif // QC_CHECKER_DECORATIONS_H
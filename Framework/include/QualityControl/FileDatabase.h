@@ -0,0 +1,62 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FileDatabase.h
+///
+
+#ifndef QC_REPOSITORY_FILEDATABASE_H
+#define QC_REPOSITORY_FILEDATABASE_H
+
+#include <memory>
+
+#include "QualityControl/DatabaseInterface.h"
+#include "QualityControl/FileStore.h"
+
+namespace o2::quality_control::repository
+{
+
+/// \brief Implementation of the DatabaseInterface in local files, see FileStore.
+///
+/// The objects are stored as the CCDB stores them, a ROOT file in "qc/<detector>/<task>/<object>" with the same
+/// metadata, valid for 10 years from the time they are stored. Thus the same task and object names are given to
+/// retrieve them. The "host" given to connect() is the directory of the repository, used by one process at a time.
+class FileDatabase : public DatabaseInterface
+{
+ public:
+  FileDatabase() = default;
+  ~FileDatabase() override;
+
+  void connect(std::string host, std::string database, std::string username, std::string password) override;
+  void connect(const std::unordered_map<std::string, std::string>& config) override;
+  void store(std::shared_ptr<o2::quality_control::core::MonitorObject> mo) override;
+  /// \brief Writes the stored objects to the disk.
+  void flush() override;
+  std::unordered_map<std::string, double> getMetrics() override;
+  o2::quality_control::core::MonitorObject* retrieve(std::string taskName, std::string objectName, long timestamp = 0) override;
+  /// \brief Lists the versions in the index, reading only their metadata, and reads their objects when asked.
+  std::unique_ptr<VersionIterator> retrieveVersions(std::string taskName, std::string objectName, long from, long to,
+                                                    const std::map<std::string, std::string>& metadataFilter = {}) override;
+  std::string retrieveJson(std::string taskName, std::string objectName) override;
+  void disconnect() override;
+  void prepareTaskDataContainer(std::string taskName) override;
+  std::vector<std::string> getPublishedObjectNames(std::string taskName) override;
+  void truncate(std::string taskName, std::string objectName) override;
+
+ private:
+  /// \brief Returns the store, throws DatabaseException if the database is not connected.
+  FileStore& getStore();
+
+  std::unique_ptr<FileStore> mStore;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_FILEDATABASE_H
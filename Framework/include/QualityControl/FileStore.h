@@ -0,0 +1,174 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FileStore.h
+///
+
+#ifndef QC_REPOSITORY_FILESTORE_H
+#define QC_REPOSITORY_FILESTORE_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "QualityControl/SerializedObject.h"
+
+namespace o2::quality_control::repository
+{
+
+/// \brief A version in the FileStore, without its content.
+struct StoredVersion {
+  std::string path;
+  long validFrom = 0; // ms since epoch
+  long validTo = 0;   // ms since epoch, excluded
+  std::map<std::string, std::string> metadata;
+  uint32_t segment = 0;
+  uint64_t offset = 0;
+};
+
+/// \brief A repository of serialized objects in local files, versioned by validity.
+///
+/// The objects are appended to segment files and never modified. The versions are found with an index sorted by
+/// path and validity start, memory-mapped, and with the versions appended since it was written, kept in memory.
+/// Finding the version of a path valid at a time is thus a binary search, without reading any segment but the
+/// found record. The index is rewritten when it lacks too many versions and when the store is closed, after a crash
+/// the versions it lacks are read again from the segments.
+///
+/// The store can be used by many threads at once, the lookups run concurrently with each other and with the
+/// appends. It is used by one process at a time, which holds a lock on the directory. The removed and replaced
+/// versions take space until the directory is compacted, by a process while no other one uses it.
+///
+/// Directory layout: "CURRENT" names the generation in use, e.g. "g1", a directory with the segments
+/// ("00000001.seg", ...) and the "index". The compaction writes the next generation and then switches to it.
+class FileStore
+{
+ public:
+  /// \param directory - created if needed, the versions in it are loaded
+  /// \param segmentSize - the size (bytes) after which the next segment is started
+  /// \param maxUnindexed - the number of versions after which the index is rewritten
+  /// Throws std::runtime_error if the directory cannot be used.
+  explicit FileStore(std::string directory, uint64_t segmentSize = 256 * 1024 * 1024, size_t maxUnindexed = 10000);
+  ~FileStore();
+  FileStore(const FileStore&) = delete;
+  FileStore& operator=(const FileStore&) = delete;
+
+  /// \brief Appends a version of the object. Returns false if it could not be written.
+  bool append(const SerializedObject& object);
+  /// \brief Removes all the versions of the path stored so far. Returns false if it could not be written.
+  bool remove(const std::string& path);
+  /// \brief Reads the version of the path valid at the timestamp, the one starting the latest if several are.
+  /// Returns false if there is none or it cannot be read.
+  bool find(const std::string& path, long timestamp, SerializedObject& object) const;
+  /// \brief Returns the versions of the path whose validity starts within [from, to], in the order of their start.
+  std::vector<StoredVersion> list(const std::string& path, long from, long to) const;
+  /// \brief Reads the object of a listed version. Returns false if it cannot be read.
+  bool read(const StoredVersion& version, SerializedObject& object) const;
+  /// \brief Returns the paths with at least one version, starting with the prefix, in alphabetical order.
+  std::vector<std::string> paths(const std::string& prefix = "") const;
+  /// \brief Writes the appended versions to the disk. The index is not rewritten, it is when it lacks maxUnindexed
+  /// versions or when the store is closed.
+  bool flush();
+
+  /// \brief Returns the number of versions in the index, the removed ones are dropped when it is rewritten.
+  size_t getNumberOfVersions() const;
+  /// \brief Returns the size (bytes) of the segments.
+  uint64_t getSize() const;
+
+  /// \brief Keeps only the versions of each path which are among its keepVersions latest ones or which start after
+  /// keepSince (ms since epoch), and drops the removed ones. 0 keeps any number of versions.
+  /// Returns false if the compaction failed, the directory is left as it was.
+  static bool compact(const std::string& directory, size_t keepVersions, long keepSince);
+
+ private:
+  using Position = std::pair<uint32_t /*segment*/, uint64_t /*offset*/>;
+
+  // as written in the index file
+  struct Entry {
+    uint32_t pathId;
+    uint32_t segment;
+    int64_t validFrom;
+    int64_t validTo;
+    uint64_t offset;
+
+    bool operator<(const Entry& other) const
+    {
+      if (pathId != other.pathId) {
+        return pathId < other.pathId;
+      }
+      if (validFrom != other.validFrom) {
+        return validFrom < other.validFrom;
+      }
+      return segment != other.segment ? segment < other.segment : offset < other.offset;
+    }
+  };
+  static_assert(sizeof(Entry) == 32);
+
+  FileStore(std::string directory, std::string generation, uint64_t segmentSize, size_t maxUnindexed);
+
+  std::string segmentPath(uint32_t segment) const;
+  void load();
+  /// \brief Maps the index and returns the position up to which the records are in it.
+  Position loadIndex();
+  void unmapIndex();
+  /// \brief Adds the records after the indexed position to the index. The corrupted records are skipped, the
+  /// incomplete one at the end of the last segment is truncated.
+  void recover(const std::vector<uint32_t>& segments, Position indexed);
+  bool openNewSegment();
+  bool writeRecord(const std::vector<char>& record, Position& position);
+  /// \brief Writes the merged index to a new file and maps it, if it changed. Called with the write mutex.
+  bool writeIndex();
+  /// \brief Writes the index if it changed and closes the files, except the lock.
+  void closeFiles();
+  /// \brief Returns the id of the path, a new one if it is not known. Called with the index mutex.
+  uint32_t pathId(const std::string& path);
+  void addEntry(uint32_t flags, const std::string& path, int64_t validFrom, int64_t validTo, Position position);
+  bool isRemoved(const Entry& entry) const;
+  /// \brief Returns the versions of the path starting within [from, to], in both parts of the index.
+  std::vector<Entry> entries(uint32_t pathId, int64_t from, int64_t to) const;
+  int segmentFd(uint32_t segment) const;
+
+  std::string mDirectory;
+  std::string mGeneration;
+  uint64_t mSegmentSize;
+  size_t mMaxUnindexed;
+  int mLockFd = -1;
+
+  // the writer
+  std::mutex mWriteMutex;
+  int mWriteFd = -1;
+  uint32_t mWriteSegment = 0;
+  uint64_t mWriteOffset = 0;
+
+  // the index, the mapped file and the versions appended since it was written
+  mutable std::shared_mutex mIndexMutex;
+  const char* mMapped = nullptr;
+  size_t mMappedSize = 0;
+  const Entry* mIndexed = nullptr;
+  size_t mNumberOfIndexed = 0;
+  std::set<Entry> mUnindexed;
+  std::vector<std::string> mPaths; // by id
+  std::unordered_map<std::string, uint32_t> mPathIds;
+  std::vector<Position> mRemovedBefore; // by path id, the position of its latest removal
+  std::vector<Position> mLatest;        // by path id, the position of its latest version
+  bool mIndexChanged = false;
+  std::vector<int> mSegmentFds; // by segment, to read the records
+  std::atomic<uint64_t> mSize = 0;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_FILESTORE_H
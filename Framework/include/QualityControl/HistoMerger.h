@@ -16,10 +16,17 @@
 #ifndef QC_CORE_HISTOMERGER_H
 #define QC_CORE_HISTOMERGER_H
 
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <Common/Timer.h>
+#include <Framework/CompletionPolicy.h>
+#include <Framework/ConfigParamSpec.h>
 #include <Framework/Task.h>
 #include <Headers/DataHeader.h>
 
@@ -29,27 +36,41 @@ struct InputSpec;
 struct OutputSpec;
 } // namespace o2::framework
 
-class TH1;
+class TClass;
 class TObjArray;
 
+#include "QualityControl/MergeRegistry.h"
 #include "QualityControl/MonitorObject.h"
 
 namespace o2::quality_control::core
 {
 
+class ThreadPool;
+
 /// \brief A crude histogram merger for development purposes.
 ///
 /// A crude histogram merger for development purposes - at some point, it will be substituted with more fine solution.
-/// As inputs, it expects updates of MonitorObjects with one TH1 histogram each, which are accumulated into one
-/// MonitorObject. The joined MO is published on regular basis with a period specified in the constructor. All inputs
-/// should have the same DataOrigin and DataDescription and non-zero SubSpecification. Output has the same origin and
-/// description as inputs, but SubSpec is fixed 0.
+/// As inputs, it expects arrays of MonitorObjects, whose objects are accumulated into one array of MonitorObjects.
+/// The objects are matched by name, the producers do not have to publish the same objects: an object published by
+/// only some of them is merged among those, an object not received anymore is removed after the objects lifetime
+/// (if set). The objects are merged with the strategy of their class (see MergeRegistry): histograms of any dimension,
+/// THnSparse, graphs, trees and custom classes implementing Mergeable. The strategy is resolved once for each object.
+/// The objects which cannot be merged keep the version received first. The joined MOs are published on regular
+/// basis with a period specified in the constructor, or once per cycle with a deadline (see setCycleDeadline()).
+/// The published MOs carry the producers which contributed to them since the previous publication, in the metadata
+/// "contributors" (their SubSpecifications, or the ones of the original producers when merged by several layers)
+/// and "numberOfContributors". All inputs should have the same DataOrigin and DataDescription
+/// and non-zero SubSpecification. Output has the same origin and description as inputs, its SubSpec is 0 unless
+/// specified otherwise (mergers of the intermediate layers of a merger tree, see InfrastructureGenerator).
 class HistoMerger : public framework::Task
 {
  public:
   /// Constructor
   explicit HistoMerger(std::string mergerName, double publicationPeriodSeconds = 10);
 
+  /// Move constructor
+  HistoMerger(HistoMerger&&);
+
   /// Destructor
   ~HistoMerger() override;
 
@@ -61,21 +82,102 @@ class HistoMerger : public framework::Task
 
   void configureInputsOutputs(
     o2::header::DataOrigin origin, o2::header::DataDescription description,
-    std::pair<o2::header::DataHeader::SubSpecificationType, o2::header::DataHeader::SubSpecificationType> subSpecRange);
+    std::pair<o2::header::DataHeader::SubSpecificationType, o2::header::DataHeader::SubSpecificationType> subSpecRange,
+    o2::header::DataHeader::SubSpecificationType outputSubSpec = 0);
+
+  /// \brief Forget the merged objects once they are published, so that only what was received since the previous
+  /// publication is published. Used by the mergers whose output is merged again by another merger. The published
+  /// objects are then handed over to DPL rather than serialized from a snapshot.
+  void setResetAfterPublication(bool reset) { mResetAfterPublication = reset; };
+
+  /// \brief Publish only the objects which were received since the previous publication, not the unchanged ones.
+  void setPublishOnlyUpdated(bool onlyUpdated) { mPublishOnlyUpdated = onlyUpdated; };
+
+  /// \brief Remove the decorations added by the checks (see Decorations.h) from the objects before merging them.
+  void setStripDecorations(bool strip) { mStripDecorations = strip; };
+
+  /// \brief Remove the merged objects which were not received for this time. 0 (default) keeps them forever.
+  void setObjectsLifetime(double seconds) { mObjectsLifetime = std::chrono::duration<double>(seconds); };
+
+  /// \brief Publish when all the producers contributed to the current cycle, or when the deadline is over.
+  ///
+  /// A cycle starts with the first input received after a publication. Once the deadline is over, what arrived is
+  /// published and the contributions arriving later go to the next publication, so that a late producer does not hold
+  /// back the others. The merger is woken up by a timer to respect the deadline even when nothing arrives. 0 (default)
+  /// publishes with the period given in the constructor instead. To be set before configureInputsOutputs().
+  void setCycleDeadline(double seconds) { mCycleDeadline = std::chrono::duration<double>(seconds); };
+
+  /// \brief Merge the objects with this number of threads, including the one of the merger. Each merged object is
+  /// updated by one thread at a time, in the order of the inputs. 1 (default) merges sequentially.
+  void setNumberOfThreads(size_t threads) { mNumberOfThreads = std::max<size_t>(threads, 1); };
+
+  /// \brief Registers a merge strategy for the objects of this class and of its derived classes.
+  void addMergeFunction(const std::string& className, MergeRegistry::MergeFunction function);
+
+  /// \brief Consumes the inputs as soon as any of them is there, rather than waiting for all the producers.
+  static framework::CompletionPolicy::CompletionOp completionPolicyCallback(gsl::span<framework::PartRef const> const& inputs);
+
+  /// \brief Queues the MonitorObjects of the array received from the producer, until mergeReceived(). The array keeps
+  /// what is not a MonitorObject.
+  void receive(TObjArray& moArray, o2::header::DataHeader::SubSpecificationType producer);
+  /// \brief Merges the objects received since the previous call into the merged ones.
+  void mergeReceived();
+  /// \brief Returns true if the merged objects should be published now, starts the next cycle if so.
+  bool isPublicationTime();
+  /// \brief Removes the expired objects and returns the ones to publish, tagged with their contributors since the
+  /// previous publication. The array owns the objects if the merger resets after publication (they are then not
+  /// merged anymore), otherwise it only points to the merged objects.
+  std::unique_ptr<TObjArray> preparePublication();
+
+  /// \brief Reads the comma-separated list of producers in the metadata "contributors", skips the malformed ones.
+  static std::set<o2::header::DataHeader::SubSpecificationType> parseContributors(const std::string& list);
 
   std::string getName() { return mMergerName; };
   std::vector<o2::framework::InputSpec> getInputSpecs() { return mInputSpecs; };
+  std::vector<o2::framework::ConfigParamSpec> getOptions() { return mOptions; };
   framework::OutputSpec getOutputSpec() { return mOutputSpec; };
 
  private:
+  struct MergedObject {
+    std::unique_ptr<MonitorObject> mo;
+    // objects received in the current run(), to be merged into mo
+    std::vector<std::unique_ptr<MonitorObject>> pending;
+    // the merge function is resolved for the class of the object, once
+    TClass* objectClass = nullptr;
+    const MergeRegistry::MergeFunction* mergeFunction = nullptr;
+    std::chrono::steady_clock::time_point lastUpdate;
+    // producers which contributed since the previous publication
+    std::set<o2::header::DataHeader::SubSpecificationType> contributors;
+  };
+
+  void queueObject(std::unique_ptr<MonitorObject> mo, o2::header::DataHeader::SubSpecificationType producer);
+  void mergePending(MergedObject& merged);
+  void removeExpiredObjects();
+  void publish(framework::ProcessingContext& ctx);
+
   // General state
   std::string mMergerName;
-  TObjArray mMergedArray;
+  std::vector<MergedObject> mMergedObjects;
+  std::unordered_map<std::string, size_t> mMergedObjectsIndex; // name -> position in mMergedObjects
+  std::vector<size_t> mUpdatedObjects;                         // positions of the objects with pending updates
   AliceO2::Common::Timer mPublicationTimer;
+  std::chrono::duration<double> mObjectsLifetime{ 0 };
+  bool mStripDecorations = false;
+  bool mResetAfterPublication = false;
+  bool mPublishOnlyUpdated = false;
+  std::chrono::steady_clock::time_point mLastPublication;
+  std::chrono::duration<double> mCycleDeadline{ 0 };
+  std::chrono::steady_clock::time_point mCycleStart;
+  std::set<o2::header::DataHeader::SubSpecificationType> mCycleProducers;
+  size_t mNumberOfProducers = 0;
+  size_t mNumberOfThreads = 1;
+  std::unique_ptr<ThreadPool> mThreadPool;
+  MergeRegistry mMergeRegistry;
 
   // DPL
   std::vector<o2::framework::InputSpec> mInputSpecs;
   o2::framework::OutputSpec mOutputSpec;
+  std::vector<o2::framework::ConfigParamSpec> mOptions;
 };
 
 } // namespace o2::quality_control::core
@@ -0,0 +1,46 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   HistogramAdd.h
+///
+
+#ifndef QC_CORE_HISTOGRAMADD_H
+#define QC_CORE_HISTOGRAMADD_H
+
+class TClass;
+class TH1;
+
+/// \brief Addition of histograms with the same layout, directly on their arrays.
+///
+/// The histograms merged by the mergers usually come from the same definition in the tasks and have the same binning.
+/// TH1::Add checks the compatibility of the axes, the labels and the errors bin by bin through virtual calls. These
+/// functions check the layout once per call and then add the bin arrays, the sums of squares of weights and the
+/// statistics in loops which the compiler vectorises.
+namespace o2::quality_control::core::histograms
+{
+
+/// \brief Returns true for the histograms whose content is entirely in their bin array, their sums of squares of
+/// weights and their statistics: TH1, TH2 and TH3 with I, F or D bins.
+bool isPlainHistogram(const TClass* histoClass);
+
+/// \brief Returns true if the histograms have the same class, the same binning and no alphanumeric labels, i.e. if
+/// addSameLayout() can add them.
+bool haveSameLayout(const TH1& target, const TH1& other);
+
+/// \brief Adds other to target if they have the same layout, otherwise returns false and leaves target untouched.
+///
+/// The result is the one of TH1::Add(&other). Only the plain histograms (TH1, TH2 and TH3 with I, F or D bins) are
+/// supported, not the profiles, nor the histograms with a fill buffer or averaged bins.
+bool addSameLayout(TH1& target, const TH1& other);
+
+} // namespace o2::quality_control::core::histograms
+
+#endif // QC_CORE_HISTOGRAMADD_H
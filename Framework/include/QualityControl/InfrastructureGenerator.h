@@ -16,6 +16,7 @@
 #ifndef QC_CORE_INFRASTRUCTUREGENERATOR_H
 #define QC_CORE_INFRASTRUCTUREGENERATOR_H
 
+#include <functional>
 #include <vector>
 #include <string>
 
@@ -24,12 +25,15 @@ namespace o2::framework
 struct CompletionPolicy;
 }
 #include <Framework/WorkflowSpec.h>
+#include <Headers/DataHeader.h>
 
 namespace o2::quality_control
 {
 namespace core
 {
 
+class HistoMerger;
+
 /// \brief A factory class which can generate QC topologies given a configuration file.
 ///
 /// A factory class which can generate QC topologies given a configuration file (example in Framework/basic.json and
@@ -97,6 +101,50 @@ class InfrastructureGenerator
   /// \endcode
   /// \param policies - completion policies vector
   static void customizeInfrastructure(std::vector<framework::CompletionPolicy>& policies);
+
+  /// \brief Computes the number of mergers in each layer of a merger tree.
+  ///
+  /// If layers is positive, the tree has at most this number of layers, with the same fan-in on each of them.
+  /// Otherwise, if fanIn is larger than 1, each merger has at most fanIn inputs and layers are added until one merger
+  /// remains. Otherwise, there is one merger.
+  ///
+  /// \param numberOfInputs - number of producers of the objects to merge
+  /// \param fanIn - maximum number of inputs of a merger, 0 for no limit
+  /// \param layers - number of layers, 0 to derive it from fanIn
+  /// \return number of mergers in each layer, the last one always contains one merger
+  static std::vector<size_t> computeMergersTopology(size_t numberOfInputs, size_t fanIn, size_t layers);
+
+  /// \brief Generates a tree of mergers for the objects of numberOfInputs producers.
+  ///
+  /// The producers publish with subspecs from 1 to numberOfInputs. Each merger of a layer receives a contiguous range
+  /// of the outputs of the previous layer. The mergers of the intermediate layers publish with subspecs following the
+  /// ones of the producers and forget the objects they published, so that they are not merged twice. The merger of the
+  /// last layer is called mergerName and publishes with the subspec 0.
+  ///
+  /// \param workflow - workflow where the mergers should be placed
+  /// \param mergerName - name of the last merger, the other ones are named after it
+  /// \param origin - data origin of the merged objects
+  /// \param description - data description of the merged objects
+  /// \param numberOfInputs - number of producers
+  /// \param mergersPerLayer - number of mergers in each layer, see computeMergersTopology()
+  /// \param configure - applied to each merger, e.g. to set its options
+  static void generateMergers(framework::WorkflowSpec& workflow, const std::string& mergerName,
+                              header::DataOrigin origin, header::DataDescription description, size_t numberOfInputs,
+                              const std::vector<size_t>& mergersPerLayer,
+                              const std::function<void(HistoMerger&)>& configure = {});
+
+ private:
+  /// \brief Generates the Checkers for the given tasks.
+  ///
+  /// By default, each task gets its own Checker. If numberOfCheckers is positive, the tasks are distributed among
+  /// that many Checkers, each of them serving a group of tasks with one database connection and one checks cache.
+  ///
+  /// \param workflow - workflow where the Checkers should be placed
+  /// \param taskNames - names of the tasks whose MonitorObjects should be checked
+  /// \param configurationSource - full path to configuration file, preceded with the backend (f.e. "json://")
+  /// \param numberOfCheckers - number of Checkers to generate, 0 or less means one Checker per task
+  static void generateCheckers(framework::WorkflowSpec& workflow, const std::vector<std::string>& taskNames,
+                               std::string configurationSource, int numberOfCheckers);
 };
 
 } // namespace core
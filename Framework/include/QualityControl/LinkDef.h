@@ -7,6 +7,11 @@
 #pragma link C++ namespace o2::quality_control::checker;
 
 #pragma link C++ class o2::quality_control::checker::CheckInterface+;
+#pragma link C++ class o2::quality_control::checker::TypedCheck<TH1>+;
+#pragma link C++ class o2::quality_control::checker::TypedCheck<TH1F>+;
+#pragma link C++ class o2::quality_control::checker::TypedCheck<TH1I>+;
 #pragma link C++ class o2::quality_control::core::TaskInterface+;
+#pragma link C++ class o2::quality_control::core::Mergeable+;
+#pragma link C++ class o2::quality_control::core::SparseHistogram+;
 
 #endif
@@ -0,0 +1,77 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   MergeRegistry.h
+///
+
+#ifndef QC_CORE_MERGEREGISTRY_H
+#define QC_CORE_MERGEREGISTRY_H
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+class TClass;
+class TObject;
+
+namespace o2::quality_control::core
+{
+
+/// \brief Strategies to merge the objects of each class.
+///
+/// A merge function merges an object into another one of the same class. The functions are registered for a class
+/// and are used for the classes inheriting from it, the function registered for the nearest base class wins.
+/// The following strategies are registered by default:
+/// - TH1 and derived classes (TH2, TH3, TProfile...): histograms::addSameLayout if they have the same binning,
+///   TH1::Add otherwise
+/// - THnBase (THn, THnSparse): THnBase::Add
+/// - TGraph and derived classes: TGraph::Merge, the points are appended
+/// - TTree: TTree::Merge, the entries are appended
+/// - classes implementing Mergeable: Mergeable::merge
+/// - any other class with a Merge(TCollection*) method known by ROOT, e.g. TEfficiency
+///
+/// The strategy of a class is resolved once and cached, resolve() is then a single lookup.
+class MergeRegistry
+{
+ public:
+  /// \brief Merges the second object into the first one. Returns false if it failed.
+  using MergeFunction = std::function<bool(TObject* target, TObject* other)>;
+
+  /// Constructor, registers the default strategies
+  MergeRegistry();
+
+  /// \brief Registers the merge function of the class and the classes derived from it.
+  /// It replaces a function already registered for this class.
+  void add(TClass* objectClass, MergeFunction function);
+  /// \brief Registers the merge function of the class given by name, if ROOT knows it.
+  void add(const std::string& className, MergeFunction function);
+
+  /// \brief Returns the merge function of the objects of this class, nullptr if they cannot be merged.
+  /// The returned pointer is valid until the next call to add().
+  const MergeFunction* resolve(TClass* objectClass);
+  /// \brief Returns the merge function of this object, nullptr if it cannot be merged.
+  const MergeFunction* resolve(const TObject* object);
+
+  /// \brief Merges the other object into the target one, with the strategy of the target class.
+  bool merge(TObject* target, TObject* other);
+
+ private:
+  const MergeFunction* findForClass(TClass* objectClass);
+
+  std::unordered_map<TClass*, MergeFunction> mFunctions;        // registered
+  std::unordered_map<TClass*, MergeFunction> mGenericFunctions; // calling the Merge() method of the class
+  std::unordered_map<TClass*, const MergeFunction*> mResolved;  // cache, nullptr for the classes not mergeable
+  MergeFunction mMergeableFunction;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_MERGEREGISTRY_H
@@ -0,0 +1,48 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   Mergeable.h
+///
+
+#ifndef QC_CORE_MERGEABLE_H
+#define QC_CORE_MERGEABLE_H
+
+class TObject;
+
+namespace o2::quality_control::core
+{
+
+/// \brief Interface of the custom objects which can be merged by the mergers.
+///
+/// The objects published by the tasks running on several machines are merged by the mergers (see MergeRegistry).
+/// ROOT histograms, graphs and trees are merged out of the box. A custom class can be merged too if it inherits
+/// from TObject and from this interface:
+/// \code
+/// class MyObject : public TObject, public o2::quality_control::core::Mergeable
+/// {
+///  public:
+///   bool merge(const TObject* other) override { ... }
+///   ClassDefOverride(MyObject, 1);
+/// };
+/// \endcode
+class Mergeable
+{
+ public:
+  virtual ~Mergeable() = default;
+
+  /// \brief Merges the other object, which has the same class, into this one.
+  /// \return false if the objects could not be merged.
+  virtual bool merge(const TObject* other) = 0;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_MERGEABLE_H
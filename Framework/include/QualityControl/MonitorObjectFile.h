@@ -0,0 +1,50 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   MonitorObjectFile.h
+///
+
+#ifndef QC_REPOSITORY_MONITOROBJECTFILE_H
+#define QC_REPOSITORY_MONITOROBJECTFILE_H
+
+#include <map>
+#include <string>
+
+#include "QualityControl/SerializedObject.h"
+
+namespace o2::quality_control::core
+{
+class MonitorObject;
+}
+
+/// \brief The storage of the MonitorObjects as the CCDB stores them, in a ROOT file with their path and metadata,
+/// shared by the backends which store the files themselves.
+namespace o2::quality_control::repository::objectfiles
+{
+
+/// \brief The key of the object in the ROOT file, CcdbApi::retrieveFromTFile looks for it.
+constexpr const char* objectKey = "ccdb_object";
+
+/// \brief Checks the names of the object and returns its path, "qc/<detector>/<task>/<object>", and adds its metadata
+/// and its quality to the metadata. Throws DatabaseException if the names cannot be stored.
+std::string prepareStorage(const core::MonitorObject& mo, std::map<std::string, std::string>& metadata);
+
+/// \brief Writes the object in a ROOT file in memory, the content of the serialized object, named after the object
+/// and the validity start of the serialized object.
+void write(const core::MonitorObject& mo, SerializedObject& object);
+
+/// \brief Reads the MonitorObject in the ROOT file, the path is only reported in the logs. Returns nullptr if it
+/// cannot. The histograms do not belong to any directory.
+core::MonitorObject* read(const char* content, size_t size, const std::string& path);
+
+} // namespace o2::quality_control::repository::objectfiles
+
+#endif // QC_REPOSITORY_MONITOROBJECTFILE_H
@@ -22,6 +22,7 @@
 
 class TMySQLResult;
 class TMySQLServer;
+class TMySQLStatement;
 
 namespace o2::quality_control::repository
 {
@@ -40,11 +41,26 @@ class MySqlDatabase : public DatabaseInterface
   void connect(std::string host, std::string database, std::string username, std::string password) override;
   void connect(const std::unordered_map<std::string, std::string>& config) override;
   void store(std::shared_ptr<o2::quality_control::core::MonitorObject> mo) override;
+  /// \brief Stores the objects grouped by store() so far.
+  void flush() override { storeQueue(); }
+  /// \brief Retrieves the version stored last before the timestamp, the latest one if it is 0. There is one version
+  /// per run, replaced at each storage for the run, thus if the version of the timestamp was replaced since, the
+  /// version stored first after the timestamp is retrieved.
   o2::quality_control::core::MonitorObject* retrieve(std::string taskName, std::string objectName, long timestamp = 0) override;
+  /// \brief Retrieves the objects with one query, each one as retrieve() does.
+  void retrieveMany(std::string taskName, const std::vector<std::string>& objectNames, long timestamp,
+                    const RetrieveCallback& callback) override;
+  /// \brief Retrieves the versions stored in the time range with one query, without their objects. Their metadata are
+  /// the run (runMetadataKey) and the fill columns, filtered by the query, a filter on any other metadata throws
+  /// DatabaseException. The object of a version is retrieved with another query when asked for.
+  std::unique_ptr<VersionIterator> retrieveVersions(std::string taskName, std::string objectName, long from, long to,
+                                                    const std::map<std::string, std::string>& metadataFilter = {}) override;
   std::string retrieveJson(std::string taskName, std::string objectName) override;
   void disconnect() override;
   std::vector<std::string> getPublishedObjectNames(std::string taskName) override;
   std::vector<std::string> getListOfTasksWithPublications();
+  /// \brief Reads the MonitorObject in the column of the current row of the statement.
+  static o2::quality_control::core::MonitorObject* readObject(TMySQLStatement* statement, int column);
   void truncate(std::string taskName, std::string objectName) override;
 
  private:
@@ -68,6 +84,14 @@ class MySqlDatabase : public DatabaseInterface
 
   void prepareTaskDataContainer(std::string taskName) override;
 
+  /// \brief Prepares the statement of the query, throws DatabaseException if it fails.
+  TMySQLStatement* prepareStatement(const std::string& query);
+  /// \brief Retrieves the version of the object stored for the run, nullptr if there is none.
+  o2::quality_control::core::MonitorObject* retrieveRun(const std::string& taskName, const std::string& objectName,
+                                                        int run);
+  /// \brief Processes the statement and stores its results, deletes it and throws DatabaseException if it fails.
+  void processStatement(TMySQLStatement* statement);
+
   void storeQueue();
   void storeForTask(std::string taskName);
 
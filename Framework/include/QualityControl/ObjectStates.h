@@ -0,0 +1,65 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ObjectStates.h
+///
+
+#ifndef QC_CHECKER_OBJECTSTATES_H
+#define QC_CHECKER_OBJECTSTATES_H
+
+#include <string>
+#include <unordered_map>
+
+#include "QualityControl/MonitorObject.h"
+
+namespace o2::quality_control::checker
+{
+
+/// \brief State kept by a check for each object it checks, from one cycle to the next.
+///
+/// A check instance is shared by all the objects it is applied to, within a Checker. Incremental checks, which only
+/// look at what changed since the previous cycle, use this container to remember where they stopped for each
+/// object. The states are identified by the task and the name of the objects. They live as long as the check, they
+/// are not stored in the repository.
+///
+/// \code
+/// struct MyState { int lastIndex = 0; };
+/// ObjectStates<MyState> mStates; //! in a check
+/// ...
+/// MyState& state = mStates.get(mo);
+/// \endcode
+template <typename State>
+class ObjectStates
+{
+ public:
+  /// \brief Returns the state of this object, default-constructed the first time.
+  State& get(const MonitorObject* mo) { return mStates[key(mo)]; }
+
+  /// \brief Returns true if a state exists for this object.
+  bool contains(const MonitorObject* mo) const { return mStates.count(key(mo)) > 0; }
+
+  /// \brief Forgets the state of this object, e.g. when it was reset.
+  void reset(const MonitorObject* mo) { mStates.erase(key(mo)); }
+
+  /// \brief Forgets the states of all the objects, e.g. at the start of a new run.
+  void clear() { mStates.clear(); }
+
+  size_t size() const { return mStates.size(); }
+
+ private:
+  static std::string key(const MonitorObject* mo) { return mo->getTaskName() + "/" + mo->getName(); }
+
+  std::unordered_map<std::string, State> mStates;
+};
+
+} // namespace o2::quality_control::checker
+
+#endif // QC_CHECKER_OBJECTSTATES_H
@@ -23,6 +23,8 @@
 // stl
 #include <string>
 #include <memory>
+#include <set>
+#include <vector>
 
 class TObject;
 class TObjArray;
@@ -90,7 +92,20 @@ class ObjectsManager
 
   TObject* getObject(std::string objectName);
 
-  TObjArray* getNonOwningArray() const;
+  /// \brief Returns the array of the MonitorObjects to publish. It does not own the objects, which stay valid until the
+  /// next call. The histograms published as sparse (see setSparse()) are converted to SparseHistogram here.
+  TObjArray* getNonOwningArray();
+
+  /**
+   * \brief Publish the histogram in its sparse form.
+   * The histogram is converted to a SparseHistogram, which contains only its non-empty bins, at each publication.
+   * It is meant for large maps which are mostly empty. The mergers and the database handle it as it is, the checks
+   * which do not accept it receive the dense histogram.
+   * @param objectName Name of the histogram.
+   * @param sparse Whether the histogram is published in its sparse form.
+   * @throw ObjectNotFoundError if object is not found.
+   */
+  void setSparse(const std::string& objectName, bool sparse = true);
 
   /**
    * \brief Add metadata to a MonitorObject.
@@ -115,6 +130,8 @@ class ObjectsManager
 
  private:
   std::unique_ptr<TObjArray> mMonitorObjects;
+  std::set<std::string> mSparseObjects;
+  std::vector<std::unique_ptr<MonitorObject>> mSparseMonitorObjects; // published in the last array
   TaskConfig& mTaskConfig;
   std::unique_ptr<ServiceDiscovery> mServiceDiscovery;
   bool mUpdateServiceDiscovery;
@@ -0,0 +1,105 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   QualityAggregator.h
+///
+
+#ifndef QC_CHECKER_QUALITYAGGREGATOR_H
+#define QC_CHECKER_QUALITYAGGREGATOR_H
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <Framework/CompletionPolicy.h>
+#include <Framework/Task.h>
+#include <Headers/DataHeader.h>
+
+#include "QualityControl/DatabaseInterface.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/QualityTree.h"
+
+class TObjArray;
+
+namespace o2::framework
+{
+struct InputSpec;
+struct OutputSpec;
+} // namespace o2::framework
+
+namespace o2::quality_control::checker
+{
+
+/// \brief Aggregates the qualities of checked MonitorObjects into qualities of tasks, detectors and a global one.
+///
+/// The QualityAggregator receives the outputs of Checkers and keeps a QualityTree, which by default has the
+/// hierarchy object -> task -> detector -> global. The hierarchy can be reduced in the configuration, e.g. to skip
+/// the detector level. Only the branches affected by updated objects are recomputed. Aggregated qualities which
+/// changed are stored in the repository, under the task name "QualityAggregator", and published on the output as
+/// an array of MonitorObjects encapsulating TNamed objects (name: node path, title: quality name).
+class QualityAggregator : public framework::Task
+{
+ public:
+  /// Constructor
+  QualityAggregator(std::string aggregatorName, std::vector<std::string> taskNames, std::string configurationSource);
+
+  /// Destructor
+  ~QualityAggregator() override = default;
+
+  /// \brief QualityAggregator init callback
+  void init(framework::InitContext& ctx) override;
+
+  /// \brief QualityAggregator process callback
+  void run(framework::ProcessingContext& ctx) override;
+
+  std::string getName() { return mAggregatorName; };
+  std::vector<framework::InputSpec> getInputSpecs() { return mInputSpecs; };
+  framework::OutputSpec getOutputSpec() { return mOutputSpec; };
+
+  /// \brief Prefix of the names of QualityAggregators.
+  static std::string createAggregatorIdString();
+
+  /// \brief Completion policy callback, which lets the aggregator consume any input as soon as it arrives.
+  static framework::CompletionPolicy::CompletionOp completionPolicyCallback(gsl::span<framework::PartRef const> const& inputs);
+
+  /// \brief Updates the tree with the qualities of the checked MonitorObjects, as run() does for each input.
+  /// \return Paths of the nodes whose aggregated quality changed.
+  std::set<std::string> aggregate(const TObjArray& checkedObjects);
+
+  /// \brief Returns the aggregated quality of a node, e.g. "global/TPC".
+  /// \throw AliceO2::Common::ObjectNotFoundError if there is no such node.
+  core::Quality getQuality(const std::string& nodePath) const { return mTree.getQuality(nodePath); }
+
+  /// \brief Builds the path of a leaf in the tree for a given MonitorObject.
+  std::vector<std::string> createPath(const core::MonitorObject& mo) const;
+
+  static constexpr char TaskName[] = "QualityAggregator";
+
+ private:
+  /// \brief Creates a new MonitorObject with the aggregated quality of a node, owned by the caller.
+  core::MonitorObject* createAggregatedObject(const std::string& nodePath);
+
+  std::string mAggregatorName;
+  std::string mConfigurationSource;
+  std::shared_ptr<o2::quality_control::repository::DatabaseInterface> mDatabase;
+  core::QualityTree mTree;
+  bool mUseDetectorLevel = true;
+  bool mUseTaskLevel = true;
+
+  // DPL
+  std::vector<o2::framework::InputSpec> mInputSpecs;
+  o2::framework::OutputSpec mOutputSpec;
+};
+
+} // namespace o2::quality_control::checker
+
+#endif // QC_CHECKER_QUALITYAGGREGATOR_H
@@ -0,0 +1,83 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   QualityTree.h
+///
+
+#ifndef QC_CORE_QUALITYTREE_H
+#define QC_CORE_QUALITYTREE_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "QualityControl/Quality.h"
+
+namespace o2::quality_control::core
+{
+
+/// \brief A hierarchy of qualities, where each node has the worst quality of its children.
+///
+/// Leaves of the tree are given their qualities directly, usually the qualities of MonitorObjects. Each inner node
+/// (e.g. task, detector and the root) aggregates the qualities of its children by taking the worst one, the same way
+/// as MonitorObject::getQuality() does for checks: Quality::Null is only returned if all children are Null.
+/// Each node keeps a count of its children per quality level, so an update of a leaf costs O(depth) and stops
+/// propagating as soon as an ancestor's quality is not affected.
+///
+/// Nodes are identified by their path from the root, joined with slashes, e.g. "global/TPC/clusters/histo".
+class QualityTree
+{
+ public:
+  explicit QualityTree(std::string rootName = "global");
+  ~QualityTree() = default;
+
+  /// \brief Sets the quality of a leaf and updates its ancestors.
+  ///
+  /// Missing nodes are created on the way.
+  /// \param path Names of the nodes from the root (excluded) to the leaf, e.g. { "TPC", "clusters", "histo" }.
+  /// \param quality New quality of the leaf.
+  /// \return Paths of the inner nodes whose aggregated quality changed, starting from the closest to the leaf.
+  std::vector<std::string> update(const std::vector<std::string>& path, const Quality& quality);
+
+  /// \brief Returns the quality of the node with the given path, e.g. "global/TPC".
+  /// \throw AliceO2::Common::ObjectNotFoundError if there is no such node.
+  Quality getQuality(const std::string& nodePath) const;
+
+  const std::string& getRootName() const { return mRoot->path; }
+
+  /// \brief Returns the number of nodes, including the root.
+  size_t size() const { return mIndex.size(); }
+
+ private:
+  struct Node {
+    std::string path;
+    Node* parent = nullptr;
+    Quality quality = Quality::Null;
+    std::unordered_map<std::string, std::unique_ptr<Node>> children;
+    /// number of children and their quality, per quality level
+    std::map<unsigned int, std::pair<size_t, Quality>> childrenLevels;
+
+    void addChildQuality(const Quality& q);
+    void removeChildQuality(const Quality& q);
+    Quality aggregate() const;
+  };
+
+  Node* getOrCreateChild(Node* node, const std::string& name);
+
+  std::unique_ptr<Node> mRoot;
+  std::unordered_map<std::string, Node*> mIndex;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_QUALITYTREE_H
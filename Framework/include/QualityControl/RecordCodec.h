@@ -0,0 +1,57 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   RecordCodec.h
+///
+
+#ifndef QC_REPOSITORY_RECORDCODEC_H
+#define QC_REPOSITORY_RECORDCODEC_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "QualityControl/SerializedObject.h"
+
+/// \brief The encoding of the serialized objects in the records of the files of the Spool and of the FileStore.
+///
+/// The body of a record is: valid from (i64), valid to (i64), path, file name, number of metadata (u32), metadata keys
+/// and values, content, where the strings and the content are preceded by their size (u32, u64 for the content). The
+/// values are in the byte order of the machine. Each user puts its own header before the body.
+namespace o2::quality_control::repository::records
+{
+
+template <typename T>
+void put(std::vector<char>& buffer, T value)
+{
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+/// \brief Appends the string preceded by its size (u32).
+void putString(std::vector<char>& buffer, const std::string& string);
+
+/// \brief Appends the body of the record of the object. Returns the size of the body before the content.
+uint32_t putBody(std::vector<char>& buffer, const SerializedObject& object);
+
+/// \brief Reads the body of a record. Without the content, the body can end before it and the content is left empty.
+/// Returns false if the body is too short.
+bool getBody(const char* body, size_t size, bool withContent, SerializedObject& object);
+
+/// \brief Returns the CRC32 of the data.
+uint32_t checksum(const char* data, size_t size);
+
+/// \brief Reads the bytes at the offset of the file, returns false if they cannot all be read.
+bool readAt(int fd, uint64_t offset, char* buffer, size_t size);
+
+} // namespace o2::quality_control::repository::records
+
+#endif // QC_REPOSITORY_RECORDCODEC_H
@@ -0,0 +1,37 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   SerializedObject.h
+///
+
+#ifndef QC_REPOSITORY_SERIALIZEDOBJECT_H
+#define QC_REPOSITORY_SERIALIZEDOBJECT_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace o2::quality_control::repository
+{
+
+/// \brief An object serialized for the repository, with its path, metadata and validity.
+struct SerializedObject {
+  std::string path;
+  std::map<std::string, std::string> metadata;
+  long validFrom = 0;
+  long validTo = 0;
+  std::string fileName;
+  std::vector<char> content;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_SERIALIZEDOBJECT_H
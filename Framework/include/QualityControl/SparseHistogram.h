@@ -0,0 +1,87 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   SparseHistogram.h
+///
+
+#ifndef QC_CORE_SPARSEHISTOGRAM_H
+#define QC_CORE_SPARSEHISTOGRAM_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <TAxis.h>
+#include <TNamed.h>
+
+#include "QualityControl/Mergeable.h"
+
+class TH1;
+
+namespace o2::quality_control::core
+{
+
+class MonitorObject;
+
+/// \brief The non-empty bins of a histogram, to publish, merge and store large maps which are mostly empty.
+///
+/// A dense histogram of 1000 x 20000 float bins takes 80 MB whatever its content. This class keeps its axes, its
+/// statistics and only the bins which are not empty, so that its size follows the number of filled bins. It is
+/// merged without being densified, the dense histogram being created only by the consumers which need it (see
+/// densify()). Only the plain histograms are supported (see histograms::isPlainHistogram()), the functions attached
+/// to the histogram are not kept.
+class SparseHistogram : public TNamed, public Mergeable
+{
+ public:
+  SparseHistogram() = default;
+  ~SparseHistogram() override = default;
+
+  /// \brief Returns the sparse form of the histogram, or nullptr if its class is not supported, if it has a buffer or
+  /// alphanumeric bins.
+  static std::unique_ptr<SparseHistogram> fromHistogram(const TH1& histogram);
+
+  /// \brief Creates the dense histogram, with the class, the binning, the content and the statistics of the original
+  /// one. The caller owns it.
+  TH1* densify() const;
+
+  /// \brief Replaces the SparseHistogram of the MonitorObject by its dense histogram, which the MonitorObject owns.
+  /// \return false if the MonitorObject does not contain a SparseHistogram, or if it could not be densified.
+  static bool densify(MonitorObject& mo);
+
+  /// \brief Adds another SparseHistogram with the same class and binning, as TH1::Add would do with dense histograms.
+  bool merge(const TObject* other) override;
+
+  const std::string& getHistogramClass() const { return mHistogramClass; }
+  size_t getNumberOfFilledBins() const { return mBins.size(); }
+  Double_t getEntries() const { return mEntries; }
+
+ private:
+  bool hasSameLayout(const SparseHistogram& other) const;
+
+  std::string mHistogramClass;
+  TAxis mXaxis;
+  TAxis mYaxis;
+  TAxis mZaxis;
+  std::vector<Int_t> mBins; // global bin numbers, in increasing order
+  std::vector<Double_t> mContents;
+  std::vector<Double_t> mSumw2; // for each bin in mBins if mHasSumw2
+  bool mHasSumw2 = false;
+  std::vector<Double_t> mStats;
+  Double_t mEntries = 0;
+  Double_t mMinimum = -1111;
+  Double_t mMaximum = -1111;
+
+  ClassDefOverride(SparseHistogram, 1);
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_SPARSEHISTOGRAM_H
@@ -0,0 +1,129 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   Spool.h
+///
+
+#ifndef QC_REPOSITORY_SPOOL_H
+#define QC_REPOSITORY_SPOOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "QualityControl/SerializedObject.h"
+
+namespace o2::quality_control::repository
+{
+
+/// \brief A durable local queue of the objects which could not be stored in the repository yet.
+///
+/// The objects are appended to a log on disk, split into segments of limited size, and sent in order by a
+/// background thread (see startReplay()) once the repository is available again. The progress of the replay is
+/// saved in a cursor file after each object, so that a restarted process continues where the previous one stopped.
+/// An object can be sent twice if the process stops between sending it and saving the cursor, never lost. A record
+/// which was not entirely written because of a crash is detected with its checksum and skipped. The objects which the
+/// repository refuses are moved to a quarantine file, so that they do not hold the ones after them forever.
+class Spool
+{
+ public:
+  /// \brief The outcome of sending a spooled object.
+  enum class SendResult {
+    Sent,
+    Retry,   ///< the repository could not be reached or is overloaded, the object is sent again later
+    Rejected ///< the repository refused the object, it would refuse it again
+  };
+
+  /// \brief Opens the spool in the directory, creating it if needed, and finds the objects left by a previous process.
+  /// \param directory - directory of the segments and of the cursor, used by only one Spool at a time
+  /// \param maxSize - the objects which would make the spool exceed this size (bytes) are rejected
+  /// \param segmentSize - a new segment is started when the current one reaches this size (bytes)
+  Spool(std::string directory, uint64_t maxSize, uint64_t segmentSize = 64 * 1024 * 1024);
+  /// \brief Stops the replay. The objects not sent yet stay on disk for the next process.
+  ~Spool();
+
+  Spool(const Spool&) = delete;
+  Spool& operator=(const Spool&) = delete;
+
+  /// \brief Appends the object to the spool. Thread-safe.
+  /// \return false if the object was not written, because the spool is full or the disk could not be written.
+  bool append(const SerializedObject& object);
+
+  /// \brief Starts a thread which sends the spooled objects in order with the function, at most maxRate per second.
+  ///
+  /// The rate is raised to twice the rate at which the objects are appended, measured each minute, so that the spool
+  /// drains even if they arrive faster than maxRate. When the function returns Retry, the object is sent again after
+  /// retryDelay, doubled after each failure up to 32 times retryDelay. When it returns Rejected, or Retry for the
+  /// maxAttempts-th time (0 for no limit), the object is moved to the file "quarantine" of the directory, in the
+  /// format of the segments, and the replay goes on with the next one.
+  void startReplay(std::function<SendResult(const SerializedObject&)> send, double maxRate,
+                   std::chrono::milliseconds retryDelay = std::chrono::seconds(1), size_t maxAttempts = 100);
+  /// \brief Stops the replay thread, after the object being sent, if any.
+  void stopReplay();
+
+  /// \brief Returns the number of the objects waiting to be sent.
+  size_t getNumberOfObjects() const;
+  /// \brief Returns the size of the objects waiting to be sent, in bytes.
+  uint64_t getSize() const;
+  /// \brief Returns the time since the oldest object waiting to be sent was spooled, 0 if there is none.
+  std::chrono::duration<double> getOldestAge() const;
+  bool empty() const { return getNumberOfObjects() == 0; }
+
+ private:
+  struct Pending {
+    uint64_t segment;
+    uint64_t offset;
+    uint64_t size;
+    int64_t spoolTime; // ms since epoch
+  };
+
+  std::string segmentPath(uint64_t segment) const;
+  void recover();
+  void openNewSegment();
+  void saveCursor(uint64_t segment, uint64_t offset);
+  /// \brief Reads the header of the record at the offset. Returns false if there is no complete record there.
+  static bool readHeader(int fd, uint64_t offset, uint64_t fileSize, Pending& pending);
+  /// \brief Reads the record at the offset. Returns false if it is incomplete or corrupted.
+  static bool readRecord(int fd, const Pending& pending, SerializedObject& object);
+  /// \brief Appends the record to the quarantine file.
+  void quarantine(int fd, const Pending& pending);
+  void replay(std::function<SendResult(const SerializedObject&)> send, double maxRate, std::chrono::milliseconds retryDelay,
+              size_t maxAttempts);
+  /// \brief Waits for the duration, returns false if the replay is stopped meanwhile.
+  bool waitFor(std::chrono::steady_clock::duration duration);
+
+  std::string mDirectory;
+  uint64_t mMaxSize;
+  uint64_t mSegmentSize;
+
+  mutable std::mutex mMutex;
+  std::deque<Pending> mPending; // the objects not sent, in the order of the spool
+  uint64_t mPendingSize = 0;
+  uint64_t mNumberOfAppended = 0; // since the spool was opened, to measure the rate of the appends
+  uint64_t mWriteSegment = 0;
+  uint64_t mWriteOffset = 0;
+  int mWriteFd = -1;
+
+  std::thread mReplayThread;
+  std::mutex mReplayMutex;
+  std::condition_variable mReplayCondition;
+  bool mStopReplay = false;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_SPOOL_H
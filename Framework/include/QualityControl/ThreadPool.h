@@ -0,0 +1,68 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ThreadPool.h
+///
+
+#ifndef QC_CORE_THREADPOOL_H
+#define QC_CORE_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o2::quality_control::core
+{
+
+/// \brief A fixed number of threads executing the tasks submitted to them.
+///
+/// The threads are started in the constructor and joined in the destructor, after the pending tasks are done.
+class ThreadPool
+{
+ public:
+  /// \brief Starts the threads.
+  /// \param numberOfThreads - number of worker threads, at least one is started
+  explicit ThreadPool(size_t numberOfThreads);
+  /// \brief Executes the pending tasks and joins the threads.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// \brief Queues a task. The future tells when it is done and gives the exception it threw, if any.
+  std::future<void> submit(std::function<void()> task);
+
+  /// \brief Calls function(i) for each i in [0, count), in parallel, and returns when all the calls are done.
+  ///
+  /// The calling thread takes part in the work. Each index is processed once, in no particular order.
+  /// If a call throws, the remaining indices are skipped and the exception is rethrown once the calls in progress
+  /// are done.
+  void parallelFor(size_t count, const std::function<void(size_t)>& function);
+
+  size_t size() const { return mThreads.size(); }
+
+ private:
+  void work();
+
+  std::vector<std::thread> mThreads;
+  std::deque<std::function<void()>> mTasks;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  bool mStopping = false;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_THREADPOOL_H
@@ -0,0 +1,78 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   TrendingExtractor.h
+///
+
+#ifndef QC_CORE_TRENDINGEXTRACTOR_H
+#define QC_CORE_TRENDINGEXTRACTOR_H
+
+#include <string>
+
+#include <boost/property_tree/ptree_fwd.hpp>
+
+namespace o2::quality_control::core
+{
+
+class MonitorObject;
+
+/// \brief Extracts a scalar quantity from a MonitorObject, to be trended.
+///
+/// Extractors are declared in the configuration of a task, e.g.:
+/// \code{.json}
+/// "trending": [
+///   { "object": "example", "extractor": "mean" },
+///   { "object": "example", "extractor": "integral", "from": "0", "to": "10" },
+///   { "object": "example", "extractor": "quality" }
+/// ]
+/// \endcode
+/// The range of "integral" is given in axis units and includes the bins containing the limits.
+class TrendingExtractor
+{
+ public:
+  enum class Type {
+    Entries,
+    Mean,
+    RMS,
+    Integral,
+    Quality
+  };
+
+  TrendingExtractor(std::string objectName, Type type, double from = 0, double to = 0);
+  ~TrendingExtractor() = default;
+
+  /// \brief Creates an extractor out of its configuration.
+  /// \throw AliceO2::Common::FatalException if the extractor type is unknown.
+  static TrendingExtractor fromConfiguration(const boost::property_tree::ptree& config);
+
+  static Type typeFromString(const std::string& type);
+  static std::string typeToString(Type type);
+
+  const std::string& getObjectName() const { return mObjectName; }
+  Type getType() const { return mType; }
+
+  /// \brief Name of the series in the TrendingStore, "<task>/<object>/<extractor>".
+  std::string getSeriesName(const std::string& taskName) const;
+
+  /// \brief Extracts the value from the MonitorObject.
+  /// \return false if the encapsulated object does not provide this quantity (e.g. mean of a TGraph).
+  bool extract(const MonitorObject& mo, double& value) const;
+
+ private:
+  std::string mObjectName;
+  Type mType;
+  double mFrom;
+  double mTo;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_TRENDINGEXTRACTOR_H
@@ -0,0 +1,92 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   TrendingStore.h
+///
+
+#ifndef QC_CORE_TRENDINGSTORE_H
+#define QC_CORE_TRENDINGSTORE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::quality_control::core
+{
+
+/// \brief One value of a trended quantity.
+struct TrendingPoint {
+  int64_t timestamp; // ms since epoch
+  int32_t run;
+  double value;
+};
+
+/// \brief A compact, columnar time-series store of scalar quantities, kept in local files.
+///
+/// Each series (e.g. "TPC/clusters/histo/mean") is stored in its own file in the given directory, as a sequence of
+/// blocks. A block contains a header with the number of rows and the ranges of timestamps and run numbers, followed by
+/// the columns of timestamps, run numbers and values. Values are buffered in memory and written as a block once
+/// blockSize values were appended or when flush() is called. Queries read only the blocks whose ranges overlap with
+/// the requested ones.
+///
+/// A block which was not completely written (e.g. because of a crash) is discarded when the series is opened again.
+class TrendingStore
+{
+ public:
+  /// \param directory Directory where the series are stored, it is created if needed.
+  /// \param blockSize Number of values in a block.
+  explicit TrendingStore(std::string directory, size_t blockSize = 1024);
+  /// Flushes the buffered values.
+  ~TrendingStore();
+
+  void append(const std::string& series, int64_t timestamp, int32_t run, double value);
+
+  /// \brief Writes all the buffered values to the files.
+  void flush();
+
+  /// \brief Returns the values of a series within [from, to], optionally only for a given run.
+  /// \param run Run number, negative to get all of them.
+  std::vector<TrendingPoint> query(const std::string& series, int64_t from, int64_t to, int32_t run = -1);
+
+  const std::string& getDirectory() const { return mDirectory; }
+
+  /// \brief Returns the name of the file which contains the given series.
+  std::string getFilePath(const std::string& series) const;
+
+ private:
+  struct BlockInfo {
+    int64_t offset; // offset of the columns in the file
+    uint32_t rows;
+    int64_t minTimestamp;
+    int64_t maxTimestamp;
+    int32_t minRun;
+    int32_t maxRun;
+  };
+
+  struct Series {
+    std::string path;
+    std::vector<BlockInfo> blocks;
+    std::vector<TrendingPoint> buffer;
+  };
+
+  Series& getSeries(const std::string& name);
+  void loadIndex(Series& series);
+  void flushSeries(Series& series);
+
+  std::string mDirectory;
+  size_t mBlockSize;
+  std::unordered_map<std::string, Series> mSeries;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_TRENDINGSTORE_H
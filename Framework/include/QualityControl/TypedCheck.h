@@ -0,0 +1,91 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   TypedCheck.h
+///
+
+#ifndef QC_CHECKER_TYPEDCHECK_H
+#define QC_CHECKER_TYPEDCHECK_H
+
+#include <string>
+
+#include <TClass.h>
+#include <TH1.h>
+
+#include "QualityControl/CheckInterface.h"
+
+namespace o2::quality_control::checker
+{
+
+/// \brief  Skeleton of a check of objects of a given class T (e.g. TH1F).
+///
+/// The check receives the encapsulated object as a T, without having to cast it and test the result. The class of
+/// the objects is compared with T once, the first time an object of this class is checked, and the following objects
+/// of the same class are converted directly. With a concrete class such as TH1F or TH1I, the check can access the bin
+/// array with its actual type (e.g. `histo.GetArray()`) and avoid the virtual TH1 accessors in its loops.
+///
+/// The objects which are not a T are not checked: their quality is Null and they are not beautified.
+template <typename T>
+class TypedCheck : public CheckInterface
+{
+ public:
+  /// Default constructor
+  TypedCheck() = default;
+  /// Destructor
+  ~TypedCheck() override = default;
+
+  Quality check(const MonitorObject* mo) final
+  {
+    const T* object = cast(mo);
+    return object != nullptr ? checkObject(mo, *object) : Quality::Null;
+  }
+
+  void beautify(MonitorObject* mo, Quality checkResult = Quality::Null) final
+  {
+    if (T* object = cast(mo)) {
+      beautifyObject(mo, *object, checkResult);
+    }
+  }
+
+  std::string getAcceptedType() override { return T::Class_Name(); }
+
+ protected:
+  /// \brief Returns the quality associated with this object. See CheckInterface::check().
+  virtual Quality checkObject(const MonitorObject* mo, const T& object) = 0;
+
+  /// \brief Modify the aspect of the object. See CheckInterface::beautify().
+  virtual void beautifyObject(MonitorObject* mo, T& object, Quality checkResult) = 0;
+
+ private:
+  T* cast(const MonitorObject* mo)
+  {
+    TObject* object = mo->getObject();
+    if (object == nullptr) {
+      return nullptr;
+    }
+    // all the objects given to a check are usually of the same class, remember the last one seen
+    TClass* objectClass = object->IsA();
+    if (objectClass != mLastClass) {
+      mLastClass = objectClass;
+      mLastClassAccepted = objectClass->InheritsFrom(T::Class());
+    }
+    return mLastClassAccepted ? static_cast<T*>(object) : nullptr;
+  }
+
+  TClass* mLastClass = nullptr;    //!
+  bool mLastClassAccepted = false; //!
+
+  ClassDefOverride(TypedCheck, 1)
+};
+
+} // namespace o2::quality_control::checker
+
+#endif // QC_CHECKER_TYPEDCHECK_H
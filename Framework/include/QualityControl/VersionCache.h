@@ -0,0 +1,85 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   VersionCache.h
+///
+
+#ifndef QC_REPOSITORY_VERSIONCACHE_H
+#define QC_REPOSITORY_VERSIONCACHE_H
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace o2::quality_control::repository
+{
+
+/// \brief A version of an object of the repository, as returned by the server.
+struct CachedVersion {
+  std::string etag;     // identifies the version, the server replies "not modified" if it is still the current one
+  long validFrom = 0;   // ms since epoch
+  long validUntil = 0;  // ms since epoch, excluded
+  std::string content;  // serialized object, or any rendering of it
+};
+
+/// \brief A thread-safe cache of object versions, limited in memory, which drops the least recently used first.
+///
+/// The versions are found by path and by a timestamp within their validity. A version found in the cache is only a
+/// candidate: a newer one may have been stored meanwhile, the caller asks the server whether it is still current
+/// (e.g. with its ETag) and counts a hit or a miss accordingly.
+class VersionCache
+{
+ public:
+  /// \param maxSize - the memory used by the cached versions (bytes), 0 disables the cache
+  explicit VersionCache(size_t maxSize = 0);
+
+  void setMaxSize(size_t maxSize);
+  /// \brief Returns the version of the path valid at the timestamp, nullptr if there is none in the cache.
+  std::shared_ptr<const CachedVersion> find(const std::string& path, long timestamp);
+  /// \brief Adds the version, replacing the cached one with the same validity start, and evicts the oldest versions
+  /// if the cache is full.
+  void insert(const std::string& path, std::shared_ptr<const CachedVersion> version);
+  void clear();
+
+  void countHit();
+  void countMiss();
+  /// \brief Returns the ratio of the hits over all the counted lookups, 0 if there was none.
+  double getHitRatio() const;
+  /// \brief Returns the memory used by the cached versions (bytes).
+  size_t getSize() const;
+  size_t getNumberOfVersions() const;
+
+ private:
+  using Key = std::pair<std::string /*path*/, long /*validFrom*/>;
+  struct Entry {
+    Key key;
+    std::shared_ptr<const CachedVersion> version;
+    size_t size;
+  };
+
+  void erase(std::map<Key, std::list<Entry>::iterator>::iterator index);
+  void evict();
+
+  mutable std::mutex mMutex;
+  size_t mMaxSize;
+  size_t mSize = 0;
+  std::list<Entry> mEntries; // the most recently used first
+  std::map<Key, std::list<Entry>::iterator> mIndex;
+  uint64_t mHits = 0;
+  uint64_t mMisses = 0;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_VERSIONCACHE_H
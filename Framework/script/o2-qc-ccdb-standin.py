@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+
+# Stand-in for the CCDB, to measure the upload throughput of o2-qc-repository-benchmark without a real server.
+# It accepts the objects (POST) and discards them, after an optional delay which emulates the latency of the
+# server. The connections are kept alive, as with the CCDB.
+#
+# Usage:
+#   o2-qc-ccdb-standin.py --port 8080 --latency 20
+#   o2-qc-repository-benchmark --database-url localhost:8080 --number-objects 500 --upload-threads 8 ...
+
+import argparse
+import logging
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+class Statistics:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.objects = 0
+        self.bytes = 0
+
+    def add(self, size):
+        with self.lock:
+            self.objects += 1
+            self.bytes += size
+
+    def take(self):
+        with self.lock:
+            objects, size = self.objects, self.bytes
+            self.objects, self.bytes = 0, 0
+        return objects, size
+
+
+statistics = Statistics()
+latency = 0.0
+
+
+class StandInHandler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'  # keep-alive
+
+    def do_POST(self):
+        length = int(self.headers.get('Content-Length', 0))
+        self.rfile.read(length)
+        if latency > 0:
+            time.sleep(latency)
+        statistics.add(length)
+        self.send_response(201)
+        self.send_header('Location', self.path)
+        self.send_header('Content-Length', '0')
+        self.end_headers()
+
+    def do_GET(self):
+        self.send_response(404)
+        self.send_header('Content-Length', '0')
+        self.end_headers()
+
+    def log_message(self, format, *args):
+        pass  # one line per object would slow down the server
+
+
+def report(period):
+    while True:
+        time.sleep(period)
+        objects, size = statistics.take()
+        logging.info(f'{objects / period:.1f} objects/s, {size / period / 1e6:.2f} MB/s')
+
+
+def main():
+    global latency
+    parser = argparse.ArgumentParser(description='Stand-in for the CCDB which accepts and discards the objects.')
+    parser.add_argument('--port', type=int, default=8080, help='Port to listen to (default: 8080)')
+    parser.add_argument('--latency', type=float, default=0, help='Delay before replying to an upload, in ms')
+    parser.add_argument('--report-period', type=float, default=10, help='Period of the throughput reports, in s')
+    args = parser.parse_args()
+    latency = args.latency / 1000
+
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s %(message)s')
+    threading.Thread(target=report, args=(args.report_period,), daemon=True).start()
+    server = ThreadingHTTPServer(('', args.port), StandInHandler)
+    logging.info(f'CCDB stand-in listening on port {args.port}')
+    server.serve_forever()
+
+
+if __name__ == '__main__':
+    main()
@@ -15,22 +15,36 @@
 
 #include "QualityControl/CcdbDatabase.h"
 #include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectFile.h"
+#include "QualityControl/SparseHistogram.h"
 #include "Common/Exceptions.h"
 // ROOT
+#include <TBufferFile.h>
 #include <TBufferJSON.h>
 #include <TH1F.h>
 #include <TFile.h>
 #include <TList.h>
+#include <TMessage.h>
 #include <TROOT.h>
 #include <TKey.h>
 #include <TStreamerInfo.h>
 #include <TSystem.h>
 // std
+#include <algorithm>
 #include <chrono>
+#include <climits>
+#include <cstdint>
+#include <condition_variable>
+#include <set>
 #include <sstream>
+#include <string_view>
 
 #include <fairlogger/Logger.h>
 #include <boost/algorithm/string.hpp>
+#include <boost/exception/diagnostic_information.hpp>
+#include <boost/exception/get_error_info.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
 
 using namespace std::chrono;
 using namespace AliceO2::Common;
@@ -40,7 +54,82 @@ using namespace std;
 namespace o2::quality_control::repository
 {
 
-CcdbDatabase::~CcdbDatabase() { disconnect(); }
+namespace
+{
+/// \brief Iterates over the versions of a listing, retrieving their objects with the function.
+class ListedVersionIterator : public VersionIterator
+{
+ public:
+  using Retrieve = std::function<std::unique_ptr<MonitorObject>(const ObjectVersion&, const std::string& id)>;
+
+  ListedVersionIterator(std::vector<std::pair<ObjectVersion, std::string>> versions, Retrieve retrieve)
+    : mVersions(std::move(versions)), mRetrieve(std::move(retrieve))
+  {
+  }
+
+  bool next() override
+  {
+    if (mCurrent + 1 >= mVersions.size()) {
+      return false; // the last version stays the current one
+    }
+    ++mCurrent;
+    return true;
+  }
+  const ObjectVersion& version() const override { return mVersions.at(mCurrent).first; }
+  std::unique_ptr<MonitorObject> object() override
+  {
+    return mRetrieve(mVersions.at(mCurrent).first, mVersions.at(mCurrent).second);
+  }
+
+ private:
+  std::vector<std::pair<ObjectVersion, std::string /*id*/>> mVersions;
+  Retrieve mRetrieve;
+  size_t mCurrent = SIZE_MAX; // before the first one
+};
+
+// the HTTP code of the response to a failed upload, absent if there was no response
+using errinfo_response_code = boost::error_info<struct errinfo_response_code_, long>;
+
+// an upload which failed because the CCDB could not be reached or was overloaded can succeed later, the other failures
+// are refusals of the object
+bool isRetryable(const DatabaseException& exception)
+{
+  const long* code = boost::get_error_info<errinfo_response_code>(exception);
+  return code == nullptr || *code >= 500 || *code == 408 || *code == 429;
+}
+
+size_t discardResponse(char* /*data*/, size_t size, size_t count, void* /*userData*/) { return size * count; }
+
+size_t appendResponse(char* data, size_t size, size_t count, void* content)
+{
+  static_cast<std::string*>(content)->append(data, size * count);
+  return size * count;
+}
+
+// keeps the headers by lower case name, the ones of the last response after the redirections override the others
+size_t collectHeader(char* data, size_t size, size_t count, void* headers)
+{
+  std::string line(data, size * count);
+  size_t colon = line.find(':');
+  if (colon != std::string::npos) {
+    std::string name = boost::algorithm::to_lower_copy(line.substr(0, colon));
+    (*static_cast<std::map<std::string, std::string>*>(headers))[name] = boost::algorithm::trim_copy(line.substr(colon + 1));
+  }
+  return size * count;
+}
+} // namespace
+
+CcdbDatabase::CcdbDatabase()
+{
+  // the connections of the uploads are created by several threads, the global initialization is not thread-safe
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+CcdbDatabase::~CcdbDatabase()
+{
+  disconnect();
+  curl_global_cleanup();
+}
 
 void CcdbDatabase::loadDeprecatedStreamerInfos()
 {
@@ -69,6 +158,23 @@ void CcdbDatabase::loadDeprecatedStreamerInfos()
   }
 }
 
+void CcdbDatabase::ensureDeprecatedStreamerInfos()
+{
+  // loaded once per process, by the first retrieval which needs them, the file is not looked for again if it fails
+  static std::once_flag loaded;
+  std::call_once(loaded, []() {
+    auto start = steady_clock::now();
+    try {
+      loadDeprecatedStreamerInfos();
+    } catch (boost::exception& e) {
+      LOG(ERROR) << "Could not load the deprecated streamer infos, old objects might not be readable: "
+                 << boost::diagnostic_information(e);
+    }
+    LOG(INFO) << "Deprecated streamer infos loaded in "
+              << duration_cast<milliseconds>(steady_clock::now() - start).count() << " ms";
+  });
+}
+
 void CcdbDatabase::connect(std::string host, std::string /*database*/, std::string /*username*/, std::string /*password*/)
 {
   mUrl = host;
@@ -78,81 +184,574 @@ void CcdbDatabase::connect(std::string host, std::string /*database*/, std::stri
 void CcdbDatabase::connect(const std::unordered_map<std::string, std::string>& config)
 {
   mUrl = config.at("host");
+  auto uploads = config.find("maxConcurrentUploads");
+  if (uploads != config.end() && !uploads->second.empty()) {
+    setMaxConcurrentUploads(std::stoul(uploads->second));
+  }
+  auto retrievals = config.find("maxConcurrentRetrievals");
+  if (retrievals != config.end() && !retrievals->second.empty()) {
+    setMaxConcurrentRetrievals(std::stoul(retrievals->second));
+  }
+  auto deduplicationPeriod = config.find("deduplicationPeriod");
+  if (deduplicationPeriod != config.end() && !deduplicationPeriod->second.empty()) {
+    setDeduplicationPeriod(std::stol(deduplicationPeriod->second));
+  }
+  auto cacheSize = config.find("cacheMaxSize");
+  if (cacheSize != config.end() && !cacheSize->second.empty()) {
+    mObjectCache.setMaxSize(std::stoull(cacheSize->second) * 1024 * 1024);
+  }
+  auto jsonCacheSize = config.find("jsonCacheMaxSize");
+  if (jsonCacheSize != config.end() && !jsonCacheSize->second.empty()) {
+    mJsonCache.setMaxSize(std::stoull(jsonCacheSize->second) * 1024 * 1024);
+  }
+  auto spoolDirectory = config.find("spoolDirectory");
+  if (spoolDirectory != config.end() && !spoolDirectory->second.empty()) {
+    uint64_t maxSize = 10240; // MB
+    double replayRate = 10;   // objects per second
+    auto maxSizeValue = config.find("spoolMaxSize");
+    if (maxSizeValue != config.end() && !maxSizeValue->second.empty()) {
+      maxSize = std::stoull(maxSizeValue->second);
+    }
+    auto replayRateValue = config.find("spoolReplayRate");
+    if (replayRateValue != config.end() && !replayRateValue->second.empty()) {
+      replayRate = std::stod(replayRateValue->second);
+    }
+    enableSpool(spoolDirectory->second, maxSize * 1024 * 1024, replayRate);
+  }
   init();
 }
 
 void CcdbDatabase::init()
 {
   ccdbApi.init(mUrl);
-  loadDeprecatedStreamerInfos();
 }
 
 void CcdbDatabase::store(std::shared_ptr<o2::quality_control::core::MonitorObject> mo)
 {
-  if (mo->getName().length() == 0 || mo->getTaskName().length() == 0) {
-    BOOST_THROW_EXCEPTION(DatabaseException()
-                          << errinfo_details("Object and task names can't be empty. Do not store."));
+  map<string, string> metadata;
+  string path = objectfiles::prepareStorage(*mo, metadata);
+  long from = getCurrentTimestamp();
+  long to = getFutureTimestamp(60 * 60 * 24 * 365 * 10);
+
+  size_t hash = contentHash(*mo, metadata);
+  if (mDeduplicator.isDuplicate(path, hash, from)) {
+    return;
   }
+  try {
+    ccdbApi.storeAsTFile(mo.get(), path, metadata, from, to);
+  } catch (...) {
+    mDeduplicator.forget(path, hash);
+    throw;
+  }
+}
 
-  if (mo->getName().find_first_of("\t\n ") != string::npos || mo->getTaskName().find_first_of("\t\n ") != string::npos) {
+size_t CcdbDatabase::contentHash(const core::MonitorObject& mo, const std::map<std::string, std::string>& metadata)
+{
+  if (mDeduplicator.getPeriod() == 0) {
+    return 0;
+  }
+  // the ROOT file which is uploaded contains the time it was written at, thus the object is streamed once more to be
+  // hashed, which costs about as much as its serialization without compression
+  TBufferFile buffer(TBuffer::kWrite);
+  buffer.WriteObject(&mo);
+  return ContentDeduplicator::hash(std::string_view(buffer.Buffer(), buffer.Length()), metadata);
+}
+
+void CcdbDatabase::setDeduplicationPeriod(long seconds) { mDeduplicator.setPeriod(seconds); }
+
+void CcdbDatabase::storeAsync(std::shared_ptr<o2::quality_control::core::MonitorObject> mo)
+{
+  SerializedObject object;
+  object.path = objectfiles::prepareStorage(*mo, object.metadata);
+  object.validFrom = getCurrentTimestamp();
+  object.validTo = getFutureTimestamp(60 * 60 * 24 * 365 * 10);
+
+  // an object identical to the previous version is not serialized nor uploaded
+  size_t hash = contentHash(*mo, object.metadata);
+  if (mDeduplicator.isDuplicate(object.path, hash, object.validFrom)) {
+    return;
+  }
+
+  // the object is serialized here, so that the ROOT I/O happens in the thread of the caller only
+  objectfiles::write(*mo, object);
+
+  // during an outage, the objects go to the spool after the ones already there, so that their order is kept, and its
+  // replay is sped up to drain it nevertheless
+  if (mSpool && !mSpool->empty()) {
+    if (!mSpool->append(object)) {
+      mDeduplicator.forget(object.path, hash);
+    }
+    return;
+  }
+
+  if (!mUploadPool) {
+    mUploadPool = std::make_unique<core::ThreadPool>(mMaxConcurrentUploads);
+  }
+  // the serialized objects waiting for an upload are limited, a slow database slows down the caller unless it can
+  // spool the objects
+  while (mPendingUploads.size() >= 4 * mMaxConcurrentUploads) {
+    if (mSpool && mPendingUploads.front().second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      if (!mSpool->append(object)) {
+        mDeduplicator.forget(object.path, hash);
+      }
+      return;
+    }
+    waitForOldestUpload();
+  }
+  string path = object.path;
+  mPendingUploads.emplace_back(path, mUploadPool->submit([this, hash, object = std::move(object)]() {
+    try {
+      upload(object);
+    } catch (const DatabaseException& exception) {
+      // the spool would refuse it again
+      if (!mSpool || !isRetryable(exception)) {
+        mDeduplicator.forget(object.path, hash);
+        throw;
+      }
+      LOG(WARNING) << "Could not store " << object.path << ", it is spooled to be stored later";
+      if (!mSpool->append(object)) {
+        mDeduplicator.forget(object.path, hash);
+      }
+    }
+  }));
+}
+
+void CcdbDatabase::upload(const SerializedObject& object)
+{
+  CURL* connection = acquireConnection();
+  string url = mUrl + "/" + object.path + "/" + std::to_string(object.validFrom) + "/" + std::to_string(object.validTo) + "/";
+  for (const auto& [key, value] : object.metadata) {
+    char* escapedKey = curl_easy_escape(connection, key.c_str(), key.size());
+    char* escapedValue = curl_easy_escape(connection, value.c_str(), value.size());
+    url += string(escapedKey) + "=" + escapedValue + "/";
+    curl_free(escapedKey);
+    curl_free(escapedValue);
+  }
+  curl_mime* form = curl_mime_init(connection);
+  curl_mimepart* part = curl_mime_addpart(form);
+  curl_mime_name(part, "send");
+  curl_mime_filename(part, object.fileName.c_str());
+  curl_mime_data(part, object.content.data(), object.content.size());
+  curl_easy_setopt(connection, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(connection, CURLOPT_MIMEPOST, form);
+
+  CURLcode result = curl_easy_perform(connection);
+  long responseCode = 0;
+  curl_easy_getinfo(connection, CURLINFO_RESPONSE_CODE, &responseCode);
+  curl_easy_setopt(connection, CURLOPT_MIMEPOST, nullptr);
+  curl_mime_free(form);
+  releaseConnection(connection);
+
+  if (result != CURLE_OK) {
+    BOOST_THROW_EXCEPTION(DatabaseException() << errinfo_details(string("Upload failed: ") + curl_easy_strerror(result)));
+  }
+  if (responseCode < 200 || responseCode >= 300) {
     BOOST_THROW_EXCEPTION(DatabaseException()
-                          << errinfo_details("Object and task names can't contain white spaces. Do not store."));
+                          << errinfo_details("Upload failed, the CCDB replied with the code " + std::to_string(responseCode))
+                          << errinfo_response_code(responseCode));
   }
+}
 
-  // metadata
-  map<string, string> metadata;
-  metadata["quality"] = std::to_string(mo->getQuality().getLevel());
-  map<string, string> userMetadata = mo->getMetadataMap();
-  if (!userMetadata.empty()) {
-    metadata.insert(userMetadata.begin(), userMetadata.end());
+bool CcdbDatabase::waitForOldestUpload()
+{
+  auto [path, upload] = std::move(mPendingUploads.front());
+  mPendingUploads.pop_front();
+  try {
+    upload.get();
+    return true;
+  } catch (boost::exception& e) {
+    LOG(ERROR) << "Could not store " << path << ": " << boost::diagnostic_information(e);
+  } catch (std::exception& e) {
+    LOG(ERROR) << "Could not store " << path << ": " << e.what();
   }
+  return false;
+}
 
-  // other attributes
-  string path = "qc/" + mo->getDetectorName() + "/" + mo->getTaskName() + "/" + mo->getName();
-  long from = getCurrentTimestamp();
-  long to = getFutureTimestamp(60 * 60 * 24 * 365 * 10);
+void CcdbDatabase::flush()
+{
+  size_t failed = 0;
+  size_t total = mPendingUploads.size();
+  while (!mPendingUploads.empty()) {
+    failed += waitForOldestUpload() ? 0 : 1;
+  }
+  if (failed > 0) {
+    LOG(ERROR) << failed << " objects out of " << total << " could not be stored in the CCDB";
+  }
+}
 
-  ccdbApi.storeAsTFile(mo.get(), path, metadata, from, to);
+void CcdbDatabase::enableSpool(const std::string& directory, uint64_t maxSize, double replayRate)
+{
+  flush();
+  mSpool = std::make_unique<Spool>(directory, maxSize);
+  mSpool->startReplay(
+    [this](const SerializedObject& object) {
+      try {
+        upload(object);
+        return Spool::SendResult::Sent;
+      } catch (const DatabaseException& exception) {
+        return isRetryable(exception) ? Spool::SendResult::Retry : Spool::SendResult::Rejected;
+      } catch (...) {
+        return Spool::SendResult::Retry;
+      }
+    },
+    replayRate);
 }
 
-core::MonitorObject* CcdbDatabase::retrieve(std::string path, std::string objectName, long timestamp)
+std::unordered_map<std::string, double> CcdbDatabase::getMetrics()
 {
-  string fullPath = path + "/" + objectName;
-  map<string, string> metadata;
-  long when = timestamp == 0 ? getCurrentTimestamp() : timestamp;
+  std::unordered_map<std::string, double> metrics{
+    { "cache_hit_ratio", mObjectCache.getHitRatio() },
+    { "cache_size_bytes", static_cast<double>(mObjectCache.getSize()) },
+    { "json_cache_hit_ratio", mJsonCache.getHitRatio() },
+    { "json_cache_size_bytes", static_cast<double>(mJsonCache.getSize()) },
+    { "skipped_duplicates", static_cast<double>(mDeduplicator.getSkipped()) }
+  };
+  if (mSpool) {
+    metrics["spool_objects"] = mSpool->getNumberOfObjects();
+    metrics["spool_size_bytes"] = mSpool->getSize();
+    metrics["spool_oldest_age_s"] = mSpool->getOldestAge().count();
+  }
+  return metrics;
+}
 
-  // we try first to load a TFile
-  TObject* object = ccdbApi.retrieveFromTFile(fullPath, metadata, when);
-  if (object == nullptr) {
-    // We could not open a TFile we should now try to open an object directly serialized
-    object = ccdbApi.retrieve(fullPath, metadata, when);
-    LOG(DEBUG) << "We could retrieve the object " << fullPath << " as a streamed object.";
-    if (object == nullptr) {
-      return nullptr;
+void CcdbDatabase::setMaxConcurrentUploads(size_t uploads)
+{
+  flush();
+  mMaxConcurrentUploads = std::max<size_t>(uploads, 1);
+  mUploadPool.reset();
+}
+
+void CcdbDatabase::setMaxConcurrentRetrievals(size_t retrievals)
+{
+  mMaxConcurrentRetrievals = std::max<size_t>(retrievals, 1);
+  mRetrievalPool.reset();
+}
+
+CURL* CcdbDatabase::acquireConnection()
+{
+  {
+    std::lock_guard<std::mutex> lock(mConnectionsMutex);
+    if (!mConnections.empty()) {
+      CURL* connection = mConnections.back();
+      mConnections.pop_back();
+      return connection;
+    }
+  }
+  CURL* connection = curl_easy_init();
+  curl_easy_setopt(connection, CURLOPT_NOSIGNAL, 1L); // required when curl is used by several threads
+  curl_easy_setopt(connection, CURLOPT_CONNECTTIMEOUT, 10L);
+  // a stuck upload would hold the objects queued after it, they are spooled instead if it fails
+  curl_easy_setopt(connection, CURLOPT_TIMEOUT, 30L);
+  curl_easy_setopt(connection, CURLOPT_TCP_KEEPALIVE, 1L);
+  // the object is sent right away rather than after the "100 Continue" of the server, it saves a round trip
+  curl_easy_setopt(connection, CURLOPT_EXPECT_100_TIMEOUT_MS, 0L);
+  curl_easy_setopt(connection, CURLOPT_WRITEFUNCTION, discardResponse);
+  curl_easy_setopt(connection, CURLOPT_FOLLOWLOCATION, 1L); // the CCDB may redirect to the file of the object
+  return connection;
+}
+
+void CcdbDatabase::releaseConnection(CURL* connection)
+{
+  // the handle keeps its connection open for the next upload
+  std::lock_guard<std::mutex> lock(mConnectionsMutex);
+  mConnections.push_back(connection);
+}
+
+long CcdbDatabase::get(const std::string& url, const std::vector<std::string>& requestHeaders, std::string& content,
+                       std::map<std::string, std::string>& headers)
+{
+  CURL* connection = acquireConnection();
+  curl_slist* headerList = nullptr;
+  for (const auto& header : requestHeaders) {
+    headerList = curl_slist_append(headerList, header.c_str());
+  }
+  curl_easy_setopt(connection, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(connection, CURLOPT_HTTPGET, 1L);
+  curl_easy_setopt(connection, CURLOPT_HTTPHEADER, headerList);
+  curl_easy_setopt(connection, CURLOPT_WRITEFUNCTION, appendResponse);
+  curl_easy_setopt(connection, CURLOPT_WRITEDATA, &content);
+  curl_easy_setopt(connection, CURLOPT_HEADERFUNCTION, collectHeader);
+  curl_easy_setopt(connection, CURLOPT_HEADERDATA, &headers);
+
+  CURLcode result = curl_easy_perform(connection);
+  long responseCode = 0;
+  curl_easy_getinfo(connection, CURLINFO_RESPONSE_CODE, &responseCode);
+  curl_easy_setopt(connection, CURLOPT_HTTPHEADER, nullptr);
+  curl_easy_setopt(connection, CURLOPT_WRITEFUNCTION, discardResponse);
+  curl_easy_setopt(connection, CURLOPT_HEADERFUNCTION, nullptr);
+  curl_easy_setopt(connection, CURLOPT_HEADERDATA, nullptr);
+  curl_slist_free_all(headerList);
+  releaseConnection(connection);
+
+  if (result != CURLE_OK) {
+    LOG(ERROR) << "Request to " << url << " failed: " << curl_easy_strerror(result);
+    return 0;
+  }
+  return responseCode;
+}
+
+std::shared_ptr<const CachedVersion> CcdbDatabase::retrieveVersion(const std::string& fullPath, long timestamp)
+{
+  // the cached version is sent again only if it is not the current one anymore
+  auto cached = mObjectCache.find(fullPath, timestamp);
+  auto version = std::make_shared<CachedVersion>();
+  std::map<std::string, std::string> headers;
+  std::vector<std::string> requestHeaders;
+  if (cached) {
+    requestHeaders.push_back("If-None-Match: " + cached->etag);
+  }
+  long responseCode = get(mUrl + "/" + fullPath + "/" + std::to_string(timestamp), requestHeaders, version->content, headers);
+  if (responseCode == 0) {
+    return nullptr;
+  }
+  if (responseCode == 304 && cached) {
+    mObjectCache.countHit();
+    return cached;
+  }
+  mObjectCache.countMiss();
+  if (responseCode != 200) {
+    if (responseCode != 404) {
+      LOG(ERROR) << "Could not retrieve " << fullPath << ", the CCDB replied with the code " << responseCode;
     }
+    return nullptr;
+  }
+
+  // without the validity, the version is still found for the next timestamps and checked with the server
+  version->etag = headers["etag"];
+  version->validFrom = headers.count("valid-from") ? std::stol(headers["valid-from"]) : timestamp;
+  version->validUntil = headers.count("valid-until") ? std::stol(headers["valid-until"]) : LONG_MAX;
+  if (!version->etag.empty()) {
+    mObjectCache.insert(fullPath, version);
+  }
+  return version;
+}
+
+std::shared_ptr<const CachedVersion> CcdbDatabase::retrieveVersionById(const std::string& fullPath,
+                                                                        const ObjectVersion& objectVersion,
+                                                                        const std::string& id)
+{
+  // a version does not change once stored, the cached one is used without asking the CCDB
+  string etag = "\"" + id + "\"";
+  auto cached = mObjectCache.find(fullPath, objectVersion.validFrom);
+  if (cached && cached->etag == etag) {
+    mObjectCache.countHit();
+    return cached;
+  }
+  mObjectCache.countMiss();
+
+  auto version = std::make_shared<CachedVersion>();
+  std::map<std::string, std::string> headers;
+  long responseCode = get(mUrl + "/download/" + id, {}, version->content, headers);
+  if (responseCode != 200) {
+    if (responseCode != 0) {
+      LOG(ERROR) << "Could not retrieve the version " << id << " of " << fullPath << ", the CCDB replied with the code "
+                 << responseCode;
+    }
+    return nullptr;
+  }
+  version->etag = etag;
+  version->validFrom = objectVersion.validFrom;
+  version->validUntil = objectVersion.validUntil;
+  mObjectCache.insert(fullPath, version);
+  return version;
+}
+
+std::unique_ptr<VersionIterator> CcdbDatabase::retrieveVersions(std::string taskName, std::string objectName, long from,
+                                                                long to, const std::map<std::string, std::string>& metadataFilter)
+{
+  string fullPath = taskName + "/" + objectName;
+
+  // the CCDB filters the versions by metadata and drops the ones created before the range, which cannot start in it
+  string url = mUrl + "/browse/" + fullPath;
+  CURL* connection = acquireConnection();
+  for (const auto& [key, value] : metadataFilter) {
+    char* escapedKey = curl_easy_escape(connection, key.c_str(), key.size());
+    char* escapedValue = curl_easy_escape(connection, value.c_str(), value.size());
+    url += "/" + string(escapedKey) + "=" + escapedValue;
+    curl_free(escapedKey);
+    curl_free(escapedValue);
+  }
+  releaseConnection(connection);
+  string listing;
+  std::map<std::string, std::string> headers;
+  long responseCode = get(url, { "Accept: application/json", "If-Not-Before: " + std::to_string(from) }, listing, headers);
+  if (responseCode != 200) {
+    BOOST_THROW_EXCEPTION(DatabaseException() << errinfo_details("Could not list the versions of " + fullPath +
+                                                                 ", the CCDB replied with the code " +
+                                                                 std::to_string(responseCode)));
+  }
+
+  // the fields which are not metadata
+  static const std::set<std::string> fields = { "path", "createTime", "lastModified", "id", "validFrom", "validUntil",
+                                                "initialValidity", "MD5", "fileName", "contentType", "size",
+                                                "replicas", "partName", "UploadedFrom" };
+  std::vector<std::pair<ObjectVersion, std::string /*id*/>> versions;
+  boost::property_tree::ptree tree;
+  std::stringstream stream(listing);
+  boost::property_tree::read_json(stream, tree);
+  for (const auto& [unused, object] : tree.get_child("objects", boost::property_tree::ptree())) {
+    if (object.get<string>("path", "") != fullPath) {
+      continue; // the objects in the folders below the path
+    }
+    ObjectVersion version;
+    version.validFrom = object.get<long>("validFrom", 0);
+    version.validUntil = object.get<long>("validUntil", LONG_MAX);
+    for (const auto& [key, value] : object) {
+      if (fields.count(key) == 0 && value.empty()) {
+        version.metadata[key] = value.data();
+      }
+    }
+    if (version.validFrom >= from && version.validFrom <= to && version.matches(metadataFilter)) {
+      versions.emplace_back(std::move(version), object.get<string>("id", ""));
+    }
+  }
+  std::sort(versions.begin(), versions.end(),
+            [](const auto& a, const auto& b) { return a.first.validFrom < b.first.validFrom; });
+
+  // the objects are retrieved only when the caller asks for them
+  auto retrieveObject = [this, fullPath](const ObjectVersion& objectVersion, const std::string& id) {
+    auto version = retrieveVersionById(fullPath, objectVersion, id);
+    return std::unique_ptr<core::MonitorObject>(version ? deserialize(*version, fullPath) : nullptr);
+  };
+  return std::make_unique<ListedVersionIterator>(std::move(versions), retrieveObject);
+}
+
+core::MonitorObject* CcdbDatabase::deserialize(const CachedVersion& version, const std::string& fullPath)
+{
+  if (version.content.compare(0, 4, "root") == 0) {
+    return objectfiles::read(version.content.data(), version.content.size(), fullPath);
+  }
+
+  // the objects stored before we were saving TFiles in the CCDB, without the streamer infos of their classes
+  ensureDeprecatedStreamerInfos();
+  TMessage message(kMESS_OBJECT);
+  message.SetBuffer(const_cast<char*>(version.content.data()), version.content.size(), kFALSE);
+  message.SetReadMode();
+  message.Reset();
+  TObject* object = message.ReadObject(TObject::Class());
+  LOG(DEBUG) << "We could retrieve the object " << fullPath << " as a streamed object.";
+  if (object == nullptr) {
+    LOG(ERROR) << "Could not read the object " << fullPath;
+    return nullptr;
   }
   auto* mo = dynamic_cast<core::MonitorObject*>(object);
   if (mo == nullptr) {
     LOG(ERROR) << "Could not cast the object " << fullPath << " to MonitorObject";
+    delete object;
   }
   return mo;
 }
 
+core::MonitorObject* CcdbDatabase::retrieve(std::string path, std::string objectName, long timestamp)
+{
+  string fullPath = path + "/" + objectName;
+  auto version = retrieveVersion(fullPath, timestamp == 0 ? getCurrentTimestamp() : timestamp);
+  return version ? deserialize(*version, fullPath) : nullptr;
+}
+
+void CcdbDatabase::retrieveMany(std::string taskName, const std::vector<std::string>& objectNames, long timestamp,
+                                const RetrieveCallback& callback)
+{
+  long when = timestamp == 0 ? getCurrentTimestamp() : timestamp;
+  if (!mRetrievalPool) {
+    mRetrievalPool = std::make_unique<core::ThreadPool>(mMaxConcurrentRetrievals);
+  }
+
+  // the objects are downloaded concurrently, they are read with ROOT in this thread only as they arrive
+  std::mutex mutex;
+  std::condition_variable arrived;
+  std::deque<std::pair<size_t, std::shared_ptr<const CachedVersion>>> versions;
+  std::vector<std::future<void>> downloads;
+  downloads.reserve(objectNames.size());
+  for (size_t i = 0; i < objectNames.size(); i++) {
+    downloads.push_back(mRetrievalPool->submit([&, i]() {
+      std::shared_ptr<const CachedVersion> version;
+      try {
+        version = retrieveVersion(taskName + "/" + objectNames[i], when);
+      } catch (std::exception& e) {
+        LOG(ERROR) << "Could not retrieve " << taskName << "/" << objectNames[i] << ": " << e.what();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        versions.emplace_back(i, std::move(version));
+      }
+      arrived.notify_one();
+    }));
+  }
+
+  // the downloads refer to the variables of this scope, they must be over before it ends
+  auto waitForDownloads = [&downloads]() {
+    for (auto& download : downloads) {
+      download.wait();
+    }
+  };
+  try {
+    for (size_t received = 0; received < objectNames.size(); received++) {
+      std::unique_lock<std::mutex> lock(mutex);
+      arrived.wait(lock, [&versions]() { return !versions.empty(); });
+      auto [i, version] = std::move(versions.front());
+      versions.pop_front();
+      lock.unlock();
+
+      string fullPath = taskName + "/" + objectNames[i];
+      callback(objectNames[i], std::unique_ptr<core::MonitorObject>(version ? deserialize(*version, fullPath) : nullptr));
+    }
+  } catch (...) {
+    waitForDownloads();
+    throw;
+  }
+  waitForDownloads();
+}
+
 std::string CcdbDatabase::retrieveJson(std::string path, std::string objectName)
 {
-  std::unique_ptr<core::MonitorObject> monitor(retrieve(path, objectName));
+  string fullPath = path + "/" + objectName;
+  auto version = retrieveVersion(fullPath, getCurrentTimestamp());
+  if (version == nullptr) {
+    return std::string();
+  }
+  // the JSON of the version is computed once
+  auto cachedJson = mJsonCache.find(fullPath, version->validFrom);
+  if (cachedJson && cachedJson->etag == version->etag && !version->etag.empty()) {
+    mJsonCache.countHit();
+    return cachedJson->content;
+  }
+  mJsonCache.countMiss();
+
+  std::unique_ptr<core::MonitorObject> monitor(deserialize(*version, fullPath));
   if (monitor == nullptr) {
     return std::string();
   }
+  // the JSON consumers expect the dense histograms
+  core::SparseHistogram::densify(*monitor);
   std::unique_ptr<TObject> obj(monitor->getObject());
   monitor->setIsOwner(false);
   TString json = TBufferJSON::ConvertToJSON(obj.get());
-  return json.Data();
+
+  auto rendering = std::make_shared<CachedVersion>(
+    CachedVersion{ version->etag, version->validFrom, version->validUntil, json.Data() });
+  if (!rendering->etag.empty()) {
+    mJsonCache.insert(fullPath, rendering);
+  }
+  return rendering->content;
+}
+
+void CcdbDatabase::setCacheSizes(size_t objects, size_t json)
+{
+  mObjectCache.setMaxSize(objects);
+  mJsonCache.setMaxSize(json);
 }
 
 void CcdbDatabase::disconnect()
 {
-  // NOOP for CCDB
+  flush();
+  // the objects not replayed yet stay in the spool for the next process
+  mSpool.reset();
+  std::lock_guard<std::mutex> lock(mConnectionsMutex);
+  for (CURL* connection : mConnections) {
+    curl_easy_cleanup(connection);
+  }
+  mConnections.clear();
 }
 
 void CcdbDatabase::prepareTaskDataContainer(std::string /*taskName*/)
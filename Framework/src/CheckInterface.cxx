@@ -4,8 +4,12 @@
 ///
 
 #include "QualityControl/CheckInterface.h"
+#include "QualityControl/DatabaseInterface.h"
 
 #include <TClass.h>
+#include <chrono>
+#include <CCDB/CcdbApi.h>
+#include <fairlogger/Logger.h>
 
 ClassImp(o2::quality_control::checker::CheckInterface)
 
@@ -19,8 +23,80 @@ std::string CheckInterface::getAcceptedType() { return "TObject"; }
 bool CheckInterface::isObjectCheckable(const MonitorObject* mo)
 {
   TObject* encapsulated = mo->getObject();
+  if (encapsulated == nullptr) {
+    return false;
+  }
+  // the accepted type does not change, avoid looking up its class by name for every object
+  if (mAcceptedClass == nullptr) {
+    mAcceptedClass = TClass::GetClass(getAcceptedType().c_str());
+  }
+  return mAcceptedClass != nullptr && encapsulated->IsA()->InheritsFrom(mAcceptedClass);
+}
+
+void CheckInterface::setCcdbUrl(const std::string& url)
+{
+  mCcdbUrl = url;
+  mCcdbApi.reset();
+}
+
+void CheckInterface::setDatabase(std::shared_ptr<repository::DatabaseInterface> database)
+{
+  mDatabase = std::move(database);
+}
+
+void CheckInterface::setActivity(const Activity& activity) { mActivity = activity; }
+
+const Activity& CheckInterface::getActivity() const { return mActivity; }
+
+void CheckInterface::setCustomParameters(const std::unordered_map<std::string, std::string>& parameters)
+{
+  mCustomParameters = parameters;
+}
+
+TObject* CheckInterface::retrieveCondition(std::string path, std::map<std::string, std::string> metadata, long timestamp)
+{
+  if (mCcdbUrl.empty()) {
+    LOG(ERROR) << "Trying to retrieve a condition, but the URL of the CCDB is not set.";
+    return nullptr;
+  }
+  if (!mCcdbApi) {
+    // many checks do not need conditions, the connection is made on first use
+    mCcdbApi = std::make_shared<o2::ccdb::CcdbApi>();
+    mCcdbApi->init(mCcdbUrl);
+    if (!mCcdbApi->isHostReachable()) {
+      LOG(WARN) << "CCDB at URL '" << mCcdbUrl << "' is not reachable.";
+    }
+  }
+  // the objects stored by QC and most conditions are ROOT files, the others are streamed with TMessage
+  TObject* condition = mCcdbApi->retrieveFromTFile(path, metadata, timestamp);
+  return condition != nullptr ? condition : mCcdbApi->retrieve(path, metadata, timestamp);
+}
+
+std::unique_ptr<MonitorObject> CheckInterface::retrieveObject(const std::string& path,
+                                                              const std::map<std::string, std::string>& metadata,
+                                                              long timestamp)
+{
+  auto separator = path.find_last_of('/');
+  if (!mDatabase || separator == std::string::npos) {
+    return nullptr;
+  }
+  const std::string taskName = path.substr(0, separator);
+  const std::string objectName = path.substr(separator + 1);
+  if (metadata.empty()) {
+    return std::unique_ptr<MonitorObject>(mDatabase->retrieve(taskName, objectName, timestamp));
+  }
 
-  return encapsulated->IsA()->InheritsFrom(getAcceptedType().c_str());
+  // the latest version started at the timestamp among the ones with the metadata, in one listing, the iterator stays
+  // on it at the end, only its object is retrieved
+  using namespace std::chrono;
+  const long now = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+  const long when = timestamp == 0 ? now : timestamp;
+  auto versions = mDatabase->retrieveVersions(taskName, objectName, 0, when, metadata);
+  bool found = false;
+  while (versions->next()) {
+    found = true;
+  }
+  return found && versions->version().validUntil > when ? versions->object() : nullptr;
 }
 
 } // namespace o2::quality_control::checker
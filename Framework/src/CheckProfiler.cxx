@@ -0,0 +1,84 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CheckProfiler.cxx
+///
+
+#include "QualityControl/CheckProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace o2::quality_control::checker
+{
+
+CallStatistics::CallStatistics(size_t windowSize) : mWindowSize(windowSize == 0 ? 1 : windowSize)
+{
+  mWindow.reserve(mWindowSize);
+}
+
+void CallStatistics::add(double durationUs)
+{
+  mCount++;
+  mTotal += durationUs;
+  mMax = std::max(mMax, durationUs);
+
+  if (mWindow.size() < mWindowSize) {
+    mWindow.push_back(durationUs);
+  } else {
+    mWindow[mWindowPosition] = durationUs;
+  }
+  mWindowPosition = (mWindowPosition + 1) % mWindowSize;
+}
+
+double CallStatistics::getPercentile(double percentile) const
+{
+  if (mWindow.empty()) {
+    return 0;
+  }
+  std::vector<double> sorted(mWindow);
+  auto rank = static_cast<size_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * sorted.size()));
+  auto nth = sorted.begin() + (rank == 0 ? 0 : rank - 1);
+  std::nth_element(sorted.begin(), nth, sorted.end());
+  return *nth;
+}
+
+void CheckProfiler::record(const std::string& checkName, const std::string& className, Call call, double durationUs)
+{
+  std::string suffix = "/" + callToString(call);
+  mChecksStatistics[checkName + suffix].add(durationUs);
+  mClassesStatistics[className + suffix].add(durationUs);
+}
+
+std::string CheckProfiler::dump() const
+{
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  auto dumpMap = [&ss](const std::string& title, const std::map<std::string, CallStatistics>& statistics) {
+    ss << title << " (durations in us)\n";
+    for (const auto& [name, stats] : statistics) {
+      ss << "  " << name << " : count " << stats.getCount() << ", total " << stats.getTotal()
+         << ", mean " << stats.getMean() << ", p99 " << stats.getPercentile(99) << ", max " << stats.getMax() << "\n";
+    }
+  };
+  dumpMap("Per check", mChecksStatistics);
+  dumpMap("Per check class", mClassesStatistics);
+  return ss.str();
+}
+
+std::string CheckProfiler::callToString(Call call)
+{
+  return call == Call::Check ? "check" : "beautify";
+}
+
+} // namespace o2::quality_control::checker
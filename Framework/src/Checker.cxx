@@ -30,6 +30,8 @@
 #include <Monitoring/Monitoring.h>
 // QC
 #include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/Decorations.h"
+#include "QualityControl/SparseHistogram.h"
 #include "QualityControl/TaskRunner.h"
 
 using namespace std::chrono;
@@ -48,15 +50,26 @@ namespace o2::quality_control::checker
 // TODO maybe we could use the CheckerFactory
 
 Checker::Checker(std::string checkerName, std::string taskName, std::string configurationSource)
+  : Checker(checkerName, std::vector<std::string>{ taskName }, configurationSource)
+{
+}
+
+Checker::Checker(std::string checkerName, std::vector<std::string> taskNames, std::string configurationSource)
   : mCheckerName(checkerName),
+    mTaskNames(taskNames),
     mConfigurationSource(configurationSource),
     mLogger(QcInfoLogger::GetInstance()),
-    mInputSpec{ "mo", TaskRunner::createTaskDataOrigin(), TaskRunner::createTaskDataDescription(taskName), 0 },
-    mOutputSpec{ "QC", Checker::createCheckerDataDescription(taskName), 0 },
     startFirstObject{ system_clock::time_point::min() },
     endLastObject{ system_clock::time_point::min() },
     mTotalNumberHistosReceived(0)
 {
+  if (taskNames.empty()) {
+    BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("No tasks given to the checker " + checkerName));
+  }
+  for (const auto& taskName : taskNames) {
+    mInputSpecs.push_back({ "mo", TaskRunner::createTaskDataOrigin(), TaskRunner::createTaskDataDescription(taskName), 0 });
+    mOutputSpecs.push_back({ "QC", Checker::createCheckerDataDescription(taskName), 0 });
+  }
 }
 
 Checker::~Checker()
@@ -68,6 +81,11 @@ Checker::~Checker()
     mCollector->send({ mTotalNumberHistosReceived, "QC_checker_Total_number_histos_treated" });
     double rate = mTotalNumberHistosReceived / diff.count();
     mCollector->send({ rate, "QC_checker_Rate_objects_treated_per_second_whole_run" });
+    sendCheckTimings();
+  }
+  if (mDumpCheckTimings) {
+    LOG(INFO) << "Durations of the checks run by " << mCheckerName << ":\n"
+              << mProfiler.dump();
   }
 }
 
@@ -82,6 +100,39 @@ void Checker::init(framework::InitContext&)
     LOG(INFO) << "Database that is going to be used : ";
     LOG(INFO) << ">> Implementation : " << config->get<std::string>("qc.config.database.implementation");
     LOG(INFO) << ">> Host : " << config->get<std::string>("qc.config.database.host");
+    mDumpCheckTimings = config->get<bool>("qc.config.checker.dumpCheckTimings", false);
+    mStripDecorations = config->get<bool>("qc.config.decorations.strip", false);
+
+    // configuration of the checks
+    mActivity = Activity(config->get<int>("qc.config.Activity.number", 0), config->get<int>("qc.config.Activity.type", 0));
+    mConditionUrl = config->get<std::string>("qc.config.conditionDB.url", "http://ccdb-test.cern.ch:8080");
+    auto qcConfig = config->getRecursive("qc");
+    if (auto checksConfig = qcConfig.get_child_optional("checks")) {
+      for (const auto& [checkName, checkConfig] : *checksConfig) {
+        if (auto parameters = checkConfig.get_child_optional("checkParameters")) {
+          for (const auto& [key, value] : *parameters) {
+            mChecksParameters[checkName][key] = value.get_value<std::string>();
+          }
+        }
+      }
+    }
+
+    // configuration of the trending
+    for (const auto& taskName : mTaskNames) {
+      auto taskConfig = config->getRecursive("qc.tasks." + taskName);
+      auto trendingConfig = taskConfig.get_child_optional("trending");
+      if (!trendingConfig) {
+        continue;
+      }
+      for (const auto& extractorConfig : *trendingConfig) {
+        mTrendingExtractors[taskName].push_back(TrendingExtractor::fromConfiguration(extractorConfig.second));
+      }
+    }
+    if (!mTrendingExtractors.empty()) {
+      mTrendingStore = std::make_unique<TrendingStore>(config->get<std::string>("qc.config.trending.directory", "qc-trending"),
+                                                       config->get<size_t>("qc.config.trending.blockSize", 64));
+      LOG(INFO) << ">> Trending directory : " << mTrendingStore->getDirectory();
+    }
   } catch (
     std::string const& e) { // we have to catch here to print the exception because the device will make it disappear
     LOG(ERROR) << "exception : " << e;
@@ -108,32 +159,46 @@ void Checker::init(framework::InitContext&)
 
 void Checker::run(framework::ProcessingContext& ctx)
 {
-  mLogger << "Receiving " << ctx.inputs().size() << " MonitorObjects" << AliceO2::InfoLogger::InfoLogger::endm;
+  mLogger << "Receiving " << ctx.inputs().size() << " MonitorObject arrays" << AliceO2::InfoLogger::InfoLogger::endm;
 
   // Save time of first object
   if (startFirstObject == std::chrono::system_clock::time_point::min()) {
     startFirstObject = system_clock::now();
   }
 
-  std::shared_ptr<TObjArray> moArray{ framework::DataRefUtils::as<TObjArray>(*ctx.inputs().begin()) };
-  moArray->SetOwner(false);
-  auto checkedMoArray = std::make_unique<TObjArray>();
-  checkedMoArray->SetOwner();
-
-  for (const auto& to : *moArray) {
-    std::shared_ptr<MonitorObject> mo{ dynamic_cast<MonitorObject*>(to) };
-    moArray->RemoveFirst();
-    if (mo) {
-      check(mo);
-      store(mo);
-      mTotalNumberHistosReceived++;
-      checkedMoArray->Add(new MonitorObject(*mo));
-    } else {
-      mLogger << "the mo is null" << AliceO2::InfoLogger::InfoLogger::endm;
+  for (const auto& input : ctx.inputs()) {
+    if (input.header == nullptr || input.payload == nullptr) {
+      continue;
+    }
+
+    const auto* dataHeader = header::get<header::DataHeader*>(input.header);
+    int route = findRoute(dataHeader->dataDescription);
+    if (route < 0) {
+      mLogger << "Received MonitorObjects with an unexpected description " << dataHeader->dataDescription.as<std::string>()
+              << ", ignoring them" << AliceO2::InfoLogger::InfoLogger::endm;
+      continue;
+    }
+
+    std::shared_ptr<TObjArray> moArray{ framework::DataRefUtils::as<TObjArray>(input) };
+    moArray->SetOwner(false);
+    auto checkedMoArray = std::make_unique<TObjArray>();
+    checkedMoArray->SetOwner();
+
+    for (const auto& to : *moArray) {
+      std::shared_ptr<MonitorObject> mo{ dynamic_cast<MonitorObject*>(to) };
+      moArray->RemoveFirst();
+      if (mo) {
+        process(mo);
+        checkedMoArray->Add(new MonitorObject(*mo));
+      } else {
+        mLogger << "the mo is null" << AliceO2::InfoLogger::InfoLogger::endm;
+      }
     }
-  }
 
-  send(checkedMoArray, ctx.outputs());
+    send(checkedMoArray, mOutputSpecs[route], ctx.outputs());
+  }
+  // the objects of all the inputs are uploaded concurrently
+  mDatabase->flush();
 
   // monitoring
   endLastObject = system_clock::now();
@@ -142,7 +207,33 @@ void Checker::run(framework::ProcessingContext& ctx)
   if (timer.isTimeout()) {
     timer.reset(1000000); // 10 s.
     mCollector->send({ mTotalNumberHistosReceived, "objects" }, o2::monitoring::DerivedMetricMode::RATE);
+    sendCheckTimings();
+    for (const auto& [name, value] : mDatabase->getMetrics()) {
+      mCollector->send({ value, "QC_checker_database_" + name });
+    }
+  }
+}
+
+void Checker::process(std::shared_ptr<MonitorObject> mo)
+{
+  if (mStripDecorations) {
+    // only the decorations of this cycle end up in the stored object
+    decorations::strip(mo->getObject());
   }
+  check(mo);
+  trend(*mo);
+  store(mo);
+  mTotalNumberHistosReceived++;
+}
+
+int Checker::findRoute(const o2::header::DataDescription& description) const
+{
+  for (size_t i = 0; i < mInputSpecs.size(); i++) {
+    if (framework::DataSpecUtils::asConcreteDataMatcher(mInputSpecs[i]).description == description) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
 }
 
 o2::header::DataDescription Checker::createCheckerDataDescription(const std::string taskName)
@@ -155,6 +246,21 @@ o2::header::DataDescription Checker::createCheckerDataDescription(const std::str
   return description;
 }
 
+std::string Checker::createCheckerIdString()
+{
+  return std::string("QC-CHECKER");
+}
+
+framework::CompletionPolicy::CompletionOp Checker::completionPolicyCallback(gsl::span<framework::PartRef const> const& inputs)
+{
+  for (auto& input : inputs) {
+    if (input.header != nullptr && input.payload != nullptr) {
+      return framework::CompletionPolicy::CompletionOp::Consume;
+    }
+  }
+  return framework::CompletionPolicy::CompletionOp::Wait;
+}
+
 void Checker::check(std::shared_ptr<MonitorObject> mo)
 {
   std::map<std::string /*checkName*/, CheckDefinition> checks = mo->getChecks();
@@ -164,6 +270,8 @@ void Checker::check(std::shared_ptr<MonitorObject> mo)
   // Get the Checks
 
   // Loop over the Checks and execute them followed by the beautification
+  // The dense copy of a sparse histogram is only checked and beautified, the sparse one is stored and forwarded.
+  std::unique_ptr<MonitorObject> dense;
   for (const auto& [checkName, check] : checks) {
     mLogger << "        check name : " << checkName << AliceO2::InfoLogger::InfoLogger::endm;
     mLogger << "        check className : " << check.className << AliceO2::InfoLogger::InfoLogger::endm;
@@ -173,31 +281,91 @@ void Checker::check(std::shared_ptr<MonitorObject> mo)
     // TODO : preload modules and pre-instantiate, or keep a cache
     loadLibrary(check.libraryName);
     CheckInterface* checkInstance = getCheck(checkName, check.className);
-    Quality q = checkInstance->check(mo.get());
+    MonitorObject* checked = mo.get();
+    if (!isBound(checkName, checkInstance, checked)) {
+      // the histograms published sparse are densified once, for the checks which do not accept them as they are
+      if (!dense && dynamic_cast<SparseHistogram*>(mo->getObject()) != nullptr) {
+        dense = std::make_unique<MonitorObject>(*mo);
+        dense->setIsOwner(false); // the sparse histogram belongs to mo
+        if (!SparseHistogram::densify(*dense)) {
+          dense.reset();
+        }
+      }
+      checked = dense.get();
+      if (checked == nullptr || !isBound(checkName, checkInstance, checked)) {
+        mLogger << "  " << checkName << " does not accept the object \"" << mo->getName() << "\", skipping it"
+                << AliceO2::InfoLogger::InfoLogger::endm;
+        continue;
+      }
+    }
+
+    auto t0 = high_resolution_clock::now();
+    Quality q = checkInstance->check(checked);
+    auto t1 = high_resolution_clock::now();
+    mProfiler.record(checkName, check.className, CheckProfiler::Call::Check, duration<double, std::micro>(t1 - t0).count());
 
     mLogger << "  result of the check " << checkName << ": " << q.getName()
             << AliceO2::InfoLogger::InfoLogger::endm;
+    // the checks are the ones of the object, setQualityForCheck finds them
+    mo->setQualityForCheck(checkName, q);
+
+    checkInstance->beautify(checked, q);
+    auto t2 = high_resolution_clock::now();
+    mProfiler.record(checkName, check.className, CheckProfiler::Call::Beautify, duration<double, std::micro>(t2 - t1).count());
+  }
+}
+
+void Checker::sendCheckTimings()
+{
+  auto sendStatistics = [this](const std::string& prefix, const std::map<std::string, CallStatistics>& statistics) {
+    for (const auto& [name, stats] : statistics) {
+      mCollector->sendGrouped(prefix + name, { { stats.getCount(), "count" },
+                                               { stats.getTotal(), "total_us" },
+                                               { stats.getPercentile(99), "p99_us" },
+                                               { stats.getMax(), "max_us" } });
+    }
+  };
+  sendStatistics("QC_checker_check_duration_", mProfiler.getChecksStatistics());
+  sendStatistics("QC_checker_class_duration_", mProfiler.getClassesStatistics());
+}
+
+void Checker::trend(const MonitorObject& mo)
+{
+  if (!mTrendingStore) {
+    return;
+  }
+  auto extractors = mTrendingExtractors.find(mo.getTaskName());
+  if (extractors == mTrendingExtractors.end()) {
+    return;
+  }
 
-    checkInstance->beautify(mo.get(), q);
+  auto timestamp = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+  for (const auto& extractor : extractors->second) {
+    double value = 0;
+    if (extractor.getObjectName() == mo.getName() && extractor.extract(mo, value)) {
+      mTrendingStore->append(extractor.getSeriesName(mo.getTaskName()), timestamp, mActivity.mId, value);
+    }
   }
 }
 
 void Checker::store(std::shared_ptr<MonitorObject> mo)
 {
   mLogger << "Storing \"" << mo->getName() << "\"" << AliceO2::InfoLogger::InfoLogger::endm;
+  // the objects of a run, e.g. the references, are found by its number in any backend
+  mo->addMetadata(runMetadataKey, std::to_string(mActivity.mId));
   try {
-    mDatabase->store(mo);
+    mDatabase->storeAsync(mo);
   } catch (boost::exception& e) {
     mLogger << "Unable to " << diagnostic_information(e) << AliceO2::InfoLogger::InfoLogger::endm;
   }
 }
 
-void Checker::send(std::unique_ptr<TObjArray>& moArray, framework::DataAllocator& allocator)
+void Checker::send(std::unique_ptr<TObjArray>& moArray, const framework::OutputSpec& outputSpec, framework::DataAllocator& allocator)
 {
   mLogger << "Sending Monitor Object array with " << moArray->GetEntries() << " objects inside." << AliceO2::InfoLogger::InfoLogger::endm;
-  auto concreteOutput = framework::DataSpecUtils::asConcreteDataMatcher(mOutputSpec);
+  auto concreteOutput = framework::DataSpecUtils::asConcreteDataMatcher(outputSpec);
   allocator.adopt(
-    framework::Output{ concreteOutput.origin, concreteOutput.description, concreteOutput.subSpec, mOutputSpec.lifetime }, moArray.release());
+    framework::Output{ concreteOutput.origin, concreteOutput.description, concreteOutput.subSpec, outputSpec.lifetime }, moArray.release());
 }
 
 void Checker::loadLibrary(const std::string libraryName)
@@ -221,6 +389,19 @@ void Checker::loadLibrary(const std::string libraryName)
   }
 }
 
+bool Checker::isBound(const std::string& checkName, CheckInterface* checkInstance, const MonitorObject* mo)
+{
+  if (mo->getObject() == nullptr) {
+    return false;
+  }
+  auto binding = std::make_pair(checkName, mo->getObject()->IsA());
+  auto cached = mChecksBindings.find(binding);
+  if (cached != mChecksBindings.end()) {
+    return cached->second;
+  }
+  return mChecksBindings[binding] = checkInstance->isObjectCheckable(mo);
+}
+
 CheckInterface* Checker::getCheck(std::string checkName, std::string className)
 {
   CheckInterface* result = nullptr;
@@ -252,6 +433,12 @@ CheckInterface* Checker::getCheck(std::string checkName, std::string className)
       tempString += R"( because the class named ")";
       BOOST_THROW_EXCEPTION(FatalException() << errinfo_details(tempString));
     }
+    result->setCcdbUrl(mConditionUrl);
+    result->setDatabase(mDatabase);
+    result->setActivity(mActivity);
+    if (mChecksParameters.count(checkName)) {
+      result->setCustomParameters(mChecksParameters[checkName]);
+    }
     result->configure(checkName);
     mChecksLoaded[checkName] = result;
   } else {
@@ -15,7 +15,9 @@
 
 #include "QualityControl/CheckerFactory.h"
 
+#include <Framework/CompletionPolicy.h>
 #include <Framework/DataProcessorSpec.h>
+#include <Framework/DeviceSpec.h>
 #include "QualityControl/Checker.h"
 
 namespace o2::quality_control::checker
@@ -39,4 +41,30 @@ DataProcessorSpec CheckerFactory::create(std::string checkerName, std::string ta
   return newChecker;
 }
 
+DataProcessorSpec CheckerFactory::create(std::string checkerName, std::vector<std::string> taskNames, std::string configurationSource)
+{
+  Checker qcChecker{ checkerName, taskNames, configurationSource };
+
+  DataProcessorSpec newChecker{ checkerName,
+                                qcChecker.getInputSpecs(),
+                                qcChecker.getOutputSpecs(),
+                                adaptFromTask<Checker>(std::move(qcChecker)),
+                                Options{},
+                                std::vector<std::string>{},
+                                std::vector<DataProcessorLabel>{} };
+
+  return newChecker;
+}
+
+void CheckerFactory::customizeInfrastructure(std::vector<framework::CompletionPolicy>& policies)
+{
+  auto matcher = [](framework::DeviceSpec const& device) {
+    return device.name.find(Checker::createCheckerIdString()) != std::string::npos;
+  };
+  auto callback = Checker::completionPolicyCallback;
+
+  framework::CompletionPolicy checkerCompletionPolicy{ "checkerCompletionPolicy", matcher, callback };
+  policies.push_back(checkerCompletionPolicy);
+}
+
 } // namespace o2::quality_control::checker
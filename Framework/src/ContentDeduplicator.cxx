@@ -0,0 +1,72 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ContentDeduplicator.cxx
+///
+
+#include "QualityControl/ContentDeduplicator.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace o2::quality_control::repository
+{
+
+ContentDeduplicator::ContentDeduplicator(long period) : mPeriod(std::max(period, 0l)) {}
+
+void ContentDeduplicator::setPeriod(long seconds)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mPeriod = std::max(seconds, 0l);
+  mContents.clear();
+}
+
+long ContentDeduplicator::getPeriod() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mPeriod;
+}
+
+bool ContentDeduplicator::isDuplicate(const std::string& path, size_t hash, long timestamp)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mPeriod == 0) {
+    return false;
+  }
+  auto& stored = mContents[path];
+  if (stored.hash == hash && timestamp - stored.timestamp < mPeriod * 1000) {
+    mSkipped++;
+    return true;
+  }
+  stored = { hash, timestamp };
+  return false;
+}
+
+void ContentDeduplicator::forget(const std::string& path, size_t hash)
+{
+  // the next identical content is stored, since this one could not be
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto stored = mContents.find(path);
+  if (stored != mContents.end() && stored->second.hash == hash) {
+    mContents.erase(stored);
+  }
+}
+
+size_t ContentDeduplicator::hash(std::string_view content, const std::map<std::string, std::string>& metadata)
+{
+  size_t hash = std::hash<std::string_view>{}(content);
+  for (const auto& [key, value] : metadata) {
+    hash ^= std::hash<std::string>{}(key + "=" + value) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+} // namespace o2::quality_control::repository
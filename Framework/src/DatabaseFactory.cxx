@@ -19,6 +19,7 @@
 #include <Common/Exceptions.h>
 // QC
 #include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/FileDatabase.h"
 #include "QualityControl/QcInfoLogger.h"
 #ifdef _WITH_MYSQL
 #include "QualityControl/MySqlDatabase.h"
@@ -45,6 +46,9 @@ std::unique_ptr<DatabaseInterface> DatabaseFactory::create(std::string name)
     // TODO check if CCDB installed
     QcInfoLogger::GetInstance() << "CCDB backend selected" << QcInfoLogger::endm;
     return std::make_unique<CcdbDatabase>();
+  } else if (name == "File") {
+    QcInfoLogger::GetInstance() << "File backend selected" << QcInfoLogger::endm;
+    return std::make_unique<FileDatabase>();
   } else {
     BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("No database named " + name));
   }
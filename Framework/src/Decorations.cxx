@@ -0,0 +1,114 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   Decorations.cxx
+///
+
+#include "QualityControl/Decorations.h"
+
+#include <TGraph.h>
+#include <TH1.h>
+
+namespace o2::quality_control::checker::decorations
+{
+
+namespace
+{
+constexpr unsigned int kDecorationBit = 0x80000000u;
+}
+
+TList* getList(TObject* object)
+{
+  if (auto* histo = dynamic_cast<TH1*>(object)) {
+    return histo->GetListOfFunctions();
+  }
+  if (auto* graph = dynamic_cast<TGraph*>(object)) {
+    return graph->GetListOfFunctions();
+  }
+  return nullptr;
+}
+
+unsigned int getId(const std::string& name)
+{
+  // FNV-1a, the ids must be the same in all the processes which read the objects
+  unsigned int hash = 2166136261u;
+  for (unsigned char c : name) {
+    hash ^= c;
+    hash *= 16777619u;
+  }
+  return hash | kDecorationBit;
+}
+
+bool isDecoration(const TObject* object)
+{
+  return object != nullptr && (object->GetUniqueID() & kDecorationBit) != 0;
+}
+
+TObject* find(TObject* object, const std::string& name)
+{
+  TList* list = getList(object);
+  if (list == nullptr) {
+    return nullptr;
+  }
+  const unsigned int id = getId(name);
+  for (TObject* primitive : *list) {
+    if (primitive->GetUniqueID() == id) {
+      return primitive;
+    }
+  }
+  return nullptr;
+}
+
+TObject* set(TObject* object, const std::string& name, TObject* decoration)
+{
+  TList* list = getList(object);
+  if (list == nullptr) {
+    delete decoration;
+    return nullptr;
+  }
+  remove(object, name);
+  decoration->SetUniqueID(getId(name));
+  list->Add(decoration);
+  return decoration;
+}
+
+bool remove(TObject* object, const std::string& name)
+{
+  TObject* decoration = find(object, name);
+  if (decoration == nullptr) {
+    return false;
+  }
+  getList(object)->Remove(decoration);
+  delete decoration;
+  return true;
+}
+
+size_t strip(TObject* object)
+{
+  TList* list = getList(object);
+  if (list == nullptr) {
+    return 0;
+  }
+  size_t removed = 0;
+  TObjLink* link = list->FirstLink();
+  while (link != nullptr) {
+    TObjLink* next = link->Next();
+    if (isDecoration(link->GetObject())) {
+      TObject* decoration = list->Remove(link);
+      delete decoration;
+      removed++;
+    }
+    link = next;
+  }
+  return removed;
+}
+
+} // namespace o2::quality_control::checker::decorations
@@ -0,0 +1,203 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FileDatabase.cxx
+///
+
+#include "QualityControl/FileDatabase.h"
+#include "QualityControl/CcdbDatabase.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectFile.h"
+#include "QualityControl/SparseHistogram.h"
+#include "Common/Exceptions.h"
+
+#include <TBufferJSON.h>
+
+#include <algorithm>
+
+#include <fairlogger/Logger.h>
+
+using namespace AliceO2::Common;
+using namespace o2::quality_control::core;
+using namespace std;
+
+namespace o2::quality_control::repository
+{
+
+namespace
+{
+/// \brief Iterates over the listed versions, reading their objects from the store when asked.
+class FileVersionIterator : public VersionIterator
+{
+ public:
+  FileVersionIterator(const FileStore& store, std::vector<StoredVersion> versions)
+    : mStore(store), mVersions(std::move(versions))
+  {
+  }
+
+  bool next() override
+  {
+    if (mCurrent + 1 >= mVersions.size()) {
+      return false; // the last version stays the current one
+    }
+    const auto& stored = mVersions[++mCurrent];
+    mVersion.validFrom = stored.validFrom;
+    mVersion.validUntil = stored.validTo;
+    mVersion.metadata = stored.metadata;
+    return true;
+  }
+
+  const ObjectVersion& version() const override { return mVersion; }
+
+  std::unique_ptr<MonitorObject> object() override
+  {
+    SerializedObject object;
+    if (!mStore.read(mVersions.at(mCurrent), object)) {
+      LOG(ERROR) << "Could not read a version of " << mVersions.at(mCurrent).path;
+      return nullptr;
+    }
+    return std::unique_ptr<MonitorObject>(objectfiles::read(object.content.data(), object.content.size(), object.path));
+  }
+
+ private:
+  const FileStore& mStore;
+  std::vector<StoredVersion> mVersions;
+  ObjectVersion mVersion;
+  size_t mCurrent = SIZE_MAX; // before the first one
+};
+} // namespace
+
+FileDatabase::~FileDatabase() { disconnect(); }
+
+void FileDatabase::connect(std::string host, std::string /*database*/, std::string /*username*/, std::string /*password*/)
+{
+  connect({ { "host", host } });
+}
+
+void FileDatabase::connect(const std::unordered_map<std::string, std::string>& config)
+{
+  uint64_t segmentSize = 256; // MB
+  auto segmentSizeValue = config.find("segmentSize");
+  if (segmentSizeValue != config.end() && !segmentSizeValue->second.empty()) {
+    segmentSize = std::stoull(segmentSizeValue->second);
+  }
+  disconnect();
+  try {
+    mStore = std::make_unique<FileStore>(config.at("host"), segmentSize * 1024 * 1024);
+  } catch (std::runtime_error& e) {
+    BOOST_THROW_EXCEPTION(DatabaseException() << errinfo_details(e.what()));
+  }
+}
+
+FileStore& FileDatabase::getStore()
+{
+  if (!mStore) {
+    BOOST_THROW_EXCEPTION(DatabaseException() << errinfo_details("The file repository is not connected"));
+  }
+  return *mStore;
+}
+
+void FileDatabase::store(std::shared_ptr<o2::quality_control::core::MonitorObject> mo)
+{
+  SerializedObject object;
+  object.path = objectfiles::prepareStorage(*mo, object.metadata);
+  object.validFrom = CcdbDatabase::getCurrentTimestamp();
+  object.validTo = CcdbDatabase::getFutureTimestamp(60 * 60 * 24 * 365 * 10);
+  objectfiles::write(*mo, object);
+
+  if (!getStore().append(object)) {
+    BOOST_THROW_EXCEPTION(DatabaseException() << errinfo_details("Could not store " + object.path));
+  }
+}
+
+void FileDatabase::flush()
+{
+  if (mStore && !mStore->flush()) {
+    LOG(ERROR) << "Could not write the file repository to the disk";
+  }
+}
+
+std::unordered_map<std::string, double> FileDatabase::getMetrics()
+{
+  if (!mStore) {
+    return {};
+  }
+  return { { "versions", static_cast<double>(mStore->getNumberOfVersions()) },
+           { "size_bytes", static_cast<double>(mStore->getSize()) } };
+}
+
+core::MonitorObject* FileDatabase::retrieve(std::string taskName, std::string objectName, long timestamp)
+{
+  SerializedObject object;
+  long when = timestamp == 0 ? CcdbDatabase::getCurrentTimestamp() : timestamp;
+  if (!getStore().find(taskName + "/" + objectName, when, object)) {
+    return nullptr;
+  }
+  return objectfiles::read(object.content.data(), object.content.size(), object.path);
+}
+
+std::unique_ptr<VersionIterator> FileDatabase::retrieveVersions(std::string taskName, std::string objectName, long from,
+                                                                long to, const std::map<std::string, std::string>& metadataFilter)
+{
+  auto versions = getStore().list(taskName + "/" + objectName, from, to);
+  versions.erase(std::remove_if(versions.begin(), versions.end(),
+                                [&](const StoredVersion& version) {
+                                  return !ObjectVersion{ version.validFrom, version.validTo, version.metadata }.matches(metadataFilter);
+                                }),
+                 versions.end());
+  return std::make_unique<FileVersionIterator>(getStore(), std::move(versions));
+}
+
+std::string FileDatabase::retrieveJson(std::string taskName, std::string objectName)
+{
+  std::unique_ptr<core::MonitorObject> monitor(retrieve(taskName, objectName));
+  if (monitor == nullptr) {
+    return std::string();
+  }
+  // the JSON consumers expect the dense histograms
+  core::SparseHistogram::densify(*monitor);
+  std::unique_ptr<TObject> obj(monitor->getObject());
+  monitor->setIsOwner(false);
+  TString json = TBufferJSON::ConvertToJSON(obj.get());
+  return json.Data();
+}
+
+void FileDatabase::disconnect()
+{
+  // the index is written when the store is closed
+  mStore.reset();
+}
+
+void FileDatabase::prepareTaskDataContainer(std::string /*taskName*/)
+{
+  // NOOP for the files, the paths are created with their first version
+}
+
+std::vector<std::string> FileDatabase::getPublishedObjectNames(std::string taskName)
+{
+  std::vector<std::string> names;
+  string prefix = taskName + "/";
+  for (const auto& path : getStore().paths(prefix)) {
+    names.push_back(path.substr(prefix.size()));
+  }
+  return names;
+}
+
+void FileDatabase::truncate(std::string taskName, std::string objectName)
+{
+  LOG(INFO) << "truncating data for " << taskName << "/" << objectName;
+  if (!getStore().remove(taskName + "/" + objectName)) {
+    BOOST_THROW_EXCEPTION(DatabaseException()
+                          << errinfo_details("Could not truncate " + taskName + "/" + objectName));
+  }
+}
+
+} // namespace o2::quality_control::repository
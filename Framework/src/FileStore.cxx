@@ -0,0 +1,811 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FileStore.cxx
+///
+
+#include "QualityControl/FileStore.h"
+#include "QualityControl/RecordCodec.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fairlogger/Logger.h>
+
+namespace o2::quality_control::repository
+{
+
+using namespace records;
+
+namespace
+{
+// a record is a header followed by a body, see RecordCodec.h:
+// header: magic (u32), crc32 of the body (u32), size of the body (u64), flags (u32), size of the body before the
+//         content (u32)
+const uint32_t recordMagic = 0x53464351; // "QCFS"
+const size_t headerSize = 24;
+const uint32_t removalFlag = 1; // the record removes the versions of its path written before it, it has no content
+
+// the index file is a header followed by the entries, sorted, and by the paths:
+// header (64 bytes): magic (u64), number of entries (u64), number of paths (u64), segment (u32, then 4 unused bytes)
+//                    and offset (u64) up to which the records are in the index, offset of the paths (u64)
+// paths: by id, the path preceded by its size (u32), then the position of its latest removal, segment (u32) and
+//        offset (u64)
+const uint64_t indexMagic = 0x3158444953464351; // "QCFSIDX1"
+const size_t indexHeaderSize = 64;
+const char* const segmentSuffix = ".seg";
+
+template <typename T>
+T at(const char* data, size_t offset)
+{
+  T value;
+  std::memcpy(&value, data + offset, sizeof(T));
+  return value;
+}
+
+std::vector<char> serialize(const SerializedObject& object, uint32_t flags)
+{
+  std::vector<char> record(headerSize);
+  uint32_t metadataSize = putBody(record, object);
+
+  uint64_t bodySize = record.size() - headerSize;
+  uint32_t crc = checksum(record.data() + headerSize, bodySize);
+  std::memcpy(record.data(), &recordMagic, sizeof(recordMagic));
+  std::memcpy(record.data() + 4, &crc, sizeof(crc));
+  std::memcpy(record.data() + 8, &bodySize, sizeof(bodySize));
+  std::memcpy(record.data() + 16, &flags, sizeof(flags));
+  std::memcpy(record.data() + 20, &metadataSize, sizeof(metadataSize));
+  return record;
+}
+
+bool writeAll(int fd, const char* buffer, size_t size)
+{
+  while (size > 0) {
+    ssize_t written = write(fd, buffer, size);
+    if (written <= 0) {
+      return false;
+    }
+    buffer += written;
+    size -= written;
+  }
+  return true;
+}
+
+// reads the record at the offset, without its content unless asked, and checks it entirely if its content is read
+bool readRecordAt(int fd, uint64_t offset, uint64_t fileSize, bool withContent, SerializedObject& object,
+                  uint32_t& flags, uint64_t& recordSize)
+{
+  char header[headerSize];
+  if (fd < 0 || offset > fileSize || fileSize - offset < headerSize || !readAt(fd, offset, header, headerSize)) {
+    return false;
+  }
+  auto bodySize = at<uint64_t>(header, 8);
+  auto metadataSize = at<uint32_t>(header, 20);
+  if (at<uint32_t>(header, 0) != recordMagic || bodySize > fileSize - offset - headerSize || metadataSize > bodySize) {
+    return false;
+  }
+  std::vector<char> body(withContent ? bodySize : metadataSize);
+  if (!readAt(fd, offset + headerSize, body.data(), body.size()) ||
+      (withContent && checksum(body.data(), body.size()) != at<uint32_t>(header, 4))) {
+    return false;
+  }
+
+  object = SerializedObject();
+  if (!getBody(body.data(), body.size(), withContent, object)) {
+    return false;
+  }
+  flags = at<uint32_t>(header, 16);
+  recordSize = headerSize + bodySize;
+  return true;
+}
+
+// returns the offset of the first valid record after the damaged one at the offset, the file size if there is none
+uint64_t nextRecordAfter(int fd, uint64_t offset, uint64_t fileSize)
+{
+  SerializedObject object;
+  uint32_t flags = 0;
+  uint64_t recordSize = 0;
+  auto isRecord = [&](uint64_t position) { return readRecordAt(fd, position, fileSize, true, object, flags, recordSize); };
+
+  // the header of the damaged record tells where the next one starts, if it is intact
+  char header[headerSize];
+  if (fileSize - offset >= headerSize && readAt(fd, offset, header, headerSize) && at<uint32_t>(header, 0) == recordMagic &&
+      at<uint64_t>(header, 8) <= fileSize - offset - headerSize) {
+    uint64_t next = offset + headerSize + at<uint64_t>(header, 8);
+    if (next == fileSize || isRecord(next)) {
+      return next;
+    }
+  }
+  // otherwise the next record is looked for by its magic number
+  std::vector<char> buffer(1024 * 1024);
+  for (uint64_t start = offset + 1; start < fileSize; start += buffer.size() - sizeof(recordMagic) + 1) {
+    size_t size = std::min<uint64_t>(buffer.size(), fileSize - start);
+    if (!readAt(fd, start, buffer.data(), size)) {
+      break;
+    }
+    for (size_t i = 0; i + sizeof(recordMagic) <= size; i++) {
+      if (at<uint32_t>(buffer.data(), i) == recordMagic && isRecord(start + i)) {
+        return start + i;
+      }
+    }
+    if (size < buffer.size()) {
+      break;
+    }
+  }
+  return fileSize;
+}
+
+// maps the index file and checks its header, returns nullptr if it cannot
+const char* mapIndexFile(const std::string& path, size_t& size)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat status {
+  };
+  void* mapped = MAP_FAILED;
+  if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= indexHeaderSize) {
+    mapped = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    return nullptr;
+  }
+  size = status.st_size;
+  const char* data = static_cast<const char*>(mapped);
+  auto numberOfEntries = at<uint64_t>(data, 8);
+  auto pathsOffset = at<uint64_t>(data, 40);
+  if (at<uint64_t>(data, 0) != indexMagic || numberOfEntries > (size - indexHeaderSize) / 32 ||
+      pathsOffset < indexHeaderSize + numberOfEntries * 32 || pathsOffset > size) {
+    munmap(mapped, size);
+    return nullptr;
+  }
+  return data;
+}
+
+// the new name replaces the previous one at once, a crash leaves one or the other
+bool writeCurrent(const std::string& directory, const std::string& generation)
+{
+  std::string path = directory + "/CURRENT";
+  std::string content = generation + "\n";
+  int fd = open((path + ".tmp").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  bool written = fd >= 0 && writeAll(fd, content.data(), content.size()) && fdatasync(fd) == 0;
+  if (fd >= 0) {
+    close(fd);
+  }
+  if (!written || rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+    LOG(ERROR) << "Cannot write " << path << ": " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+std::vector<uint32_t> listSegments(const std::string& directory)
+{
+  std::vector<uint32_t> segments;
+  if (DIR* dir = opendir(directory.c_str())) {
+    while (dirent* entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      size_t suffix = name.find(segmentSuffix);
+      if (suffix != std::string::npos && suffix > 0 && suffix + strlen(segmentSuffix) == name.size() &&
+          std::all_of(name.begin(), name.begin() + suffix, ::isdigit)) {
+        segments.push_back(std::stoul(name.substr(0, suffix)));
+      }
+    }
+    closedir(dir);
+  }
+  std::sort(segments.begin(), segments.end());
+  return segments;
+}
+
+void removeDirectory(const std::string& directory)
+{
+  if (DIR* dir = opendir(directory.c_str())) {
+    while (dirent* entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name != "." && name != "..") {
+        unlink((directory + "/" + name).c_str());
+      }
+    }
+    closedir(dir);
+    rmdir(directory.c_str());
+  }
+}
+} // namespace
+
+FileStore::FileStore(std::string directory, uint64_t segmentSize, size_t maxUnindexed)
+  : mDirectory(std::move(directory)), mSegmentSize(segmentSize), mMaxUnindexed(maxUnindexed)
+{
+  if (mkdir(mDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+    throw std::runtime_error("Cannot create the directory " + mDirectory + ": " + strerror(errno));
+  }
+  // one process at a time, the lock is released by the system if the process dies
+  mLockFd = ::open((mDirectory + "/lock").c_str(), O_RDWR | O_CREAT, 0644);
+  if (mLockFd < 0 || flock(mLockFd, LOCK_EX | LOCK_NB) != 0) {
+    std::string error = strerror(errno);
+    if (mLockFd >= 0) {
+      ::close(mLockFd);
+    }
+    throw std::runtime_error("Cannot lock the directory " + mDirectory + ", is it used by another process? " + error);
+  }
+
+  try {
+    std::ifstream current(mDirectory + "/CURRENT");
+    if (!(current >> mGeneration)) {
+      mGeneration = "g1";
+      if ((mkdir((mDirectory + "/" + mGeneration).c_str(), 0755) != 0 && errno != EEXIST) ||
+          !writeCurrent(mDirectory, mGeneration)) {
+        throw std::runtime_error("Cannot initialize the directory " + mDirectory);
+      }
+    }
+    load();
+  } catch (...) {
+    closeFiles();
+    ::close(mLockFd);
+    throw;
+  }
+  LOG(INFO) << "File repository in " << mDirectory << " opened with " << getNumberOfVersions() << " versions of "
+            << mPaths.size() << " paths";
+}
+
+FileStore::FileStore(std::string directory, std::string generation, uint64_t segmentSize, size_t maxUnindexed)
+  : mDirectory(std::move(directory)), mGeneration(std::move(generation)), mSegmentSize(segmentSize), mMaxUnindexed(maxUnindexed)
+{
+  try {
+    load();
+  } catch (...) {
+    closeFiles();
+    throw;
+  }
+}
+
+FileStore::~FileStore()
+{
+  closeFiles();
+  if (mLockFd >= 0) {
+    ::close(mLockFd);
+  }
+}
+
+std::string FileStore::segmentPath(uint32_t segment) const
+{
+  // the names are padded so that their alphabetical order is the order of the segments
+  char name[16];
+  snprintf(name, sizeof(name), "%08u", segment);
+  return mDirectory + "/" + mGeneration + "/" + name + segmentSuffix;
+}
+
+void FileStore::load()
+{
+  std::string generation = mDirectory + "/" + mGeneration;
+  if (mkdir(generation.c_str(), 0755) != 0 && errno != EEXIST) {
+    throw std::runtime_error("Cannot create the directory " + generation + ": " + strerror(errno));
+  }
+  auto segments = listSegments(generation);
+  recover(segments, loadIndex());
+
+  if (segments.empty()) {
+    if (!openNewSegment()) {
+      throw std::runtime_error("Cannot create a segment in " + generation);
+    }
+    return;
+  }
+  mWriteSegment = segments.back();
+  mWriteFd = ::open(segmentPath(mWriteSegment).c_str(), O_WRONLY | O_APPEND);
+  if (mWriteFd < 0) {
+    throw std::runtime_error("Cannot open the segment " + segmentPath(mWriteSegment) + ": " + strerror(errno));
+  }
+  mWriteOffset = lseek(mWriteFd, 0, SEEK_END);
+}
+
+FileStore::Position FileStore::loadIndex()
+{
+  std::string path = mDirectory + "/" + mGeneration + "/index";
+  size_t size = 0;
+  const char* data = mapIndexFile(path, size);
+  if (data == nullptr) {
+    if (access(path.c_str(), F_OK) == 0) {
+      LOG(WARNING) << "The index " << path << " cannot be read, the versions are read from the segments";
+    }
+    return { 0, 0 };
+  }
+  mMapped = data;
+  mMappedSize = size;
+  mIndexed = reinterpret_cast<const Entry*>(data + indexHeaderSize);
+  mNumberOfIndexed = at<uint64_t>(data, 8);
+
+  bool valid = true;
+  auto numberOfPaths = at<uint64_t>(data, 16);
+  uint64_t position = at<uint64_t>(data, 40);
+  for (uint64_t i = 0; i < numberOfPaths && valid; i++) {
+    uint32_t length = size - position >= 4 ? at<uint32_t>(data, position) : UINT32_MAX;
+    valid = size - position >= 16ull + length;
+    if (valid) {
+      uint32_t id = pathId(std::string(data + position + 4, length));
+      mRemovedBefore[id] = { at<uint32_t>(data, position + 4 + length), at<uint64_t>(data, position + 8 + length) };
+      position += 16 + length;
+    }
+  }
+  for (size_t i = 0; i < mNumberOfIndexed && valid; i++) {
+    valid = mIndexed[i].pathId < mPaths.size();
+    if (valid) {
+      mLatest[mIndexed[i].pathId] = std::max(mLatest[mIndexed[i].pathId], { mIndexed[i].segment, mIndexed[i].offset });
+    }
+  }
+  if (!valid) {
+    LOG(WARNING) << "The index " << path << " is corrupted, the versions are read from the segments";
+    unmapIndex();
+    mPaths.clear();
+    mPathIds.clear();
+    mRemovedBefore.clear();
+    mLatest.clear();
+    return { 0, 0 };
+  }
+  return { at<uint32_t>(data, 24), at<uint64_t>(data, 32) };
+}
+
+void FileStore::unmapIndex()
+{
+  if (mMapped != nullptr) {
+    munmap(const_cast<char*>(mMapped), mMappedSize);
+  }
+  mMapped = nullptr;
+  mMappedSize = 0;
+  mIndexed = nullptr;
+  mNumberOfIndexed = 0;
+}
+
+void FileStore::recover(const std::vector<uint32_t>& segments, Position indexed)
+{
+  size_t recovered = 0;
+  for (uint32_t segment : segments) {
+    int fd = ::open(segmentPath(segment).c_str(), O_RDONLY);
+    struct stat status {
+    };
+    if (fd < 0 || fstat(fd, &status) != 0) {
+      std::string error = strerror(errno);
+      if (fd >= 0) {
+        ::close(fd);
+      }
+      throw std::runtime_error("Cannot read the segment " + segmentPath(segment) + ": " + error);
+    }
+    if (mSegmentFds.size() <= segment) {
+      mSegmentFds.resize(segment + 1, -1);
+    }
+    mSegmentFds[segment] = fd;
+    uint64_t size = status.st_size;
+
+    // the records written after the index are read again
+    if (segment >= indexed.first) {
+      uint64_t offset = segment == indexed.first ? indexed.second : 0;
+      SerializedObject object;
+      uint32_t flags = 0;
+      uint64_t recordSize = 0;
+      bool last = segment == segments.back();
+      while (offset < size) {
+        if (readRecordAt(fd, offset, size, true, object, flags, recordSize)) {
+          addEntry(flags, object.path, object.validFrom, object.validTo, { segment, offset });
+          offset += recordSize;
+          recovered++;
+          continue;
+        }
+        uint64_t next = nextRecordAfter(fd, offset, size);
+        if (next == size && last) {
+          break;
+        }
+        LOG(ERROR) << "The " << next - offset << " bytes at " << offset << " in the segment " << segmentPath(segment)
+                   << " are not a valid record, they are skipped";
+        offset = next;
+      }
+      if (offset < size) {
+        // the process stopped while writing the last record
+        LOG(WARNING) << "The segment " << segmentPath(segment) << " ends with an incomplete record, it is truncated";
+        if (::truncate(segmentPath(segment).c_str(), offset) != 0) {
+          throw std::runtime_error("Cannot truncate the segment " + segmentPath(segment) + ": " + strerror(errno));
+        }
+        size = offset;
+      }
+    }
+    mSize += size;
+  }
+  if (recovered > 0) {
+    LOG(INFO) << recovered << " records of " << mDirectory << " were not in its index, they are added to it";
+  }
+}
+
+bool FileStore::openNewSegment()
+{
+  if (mWriteFd >= 0) {
+    fdatasync(mWriteFd);
+    ::close(mWriteFd);
+    mWriteFd = -1;
+  }
+  uint32_t segment = mWriteSegment + 1;
+  int writeFd = ::open(segmentPath(segment).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+  int readFd = ::open(segmentPath(segment).c_str(), O_RDONLY);
+  if (writeFd < 0 || readFd < 0) {
+    LOG(ERROR) << "Cannot create the segment " << segmentPath(segment) << ": " << strerror(errno);
+    for (int fd : { writeFd, readFd }) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+    return false;
+  }
+  {
+    std::unique_lock<std::shared_mutex> lock(mIndexMutex);
+    if (mSegmentFds.size() <= segment) {
+      mSegmentFds.resize(segment + 1, -1);
+    }
+    mSegmentFds[segment] = readFd;
+  }
+  mWriteFd = writeFd;
+  mWriteSegment = segment;
+  mWriteOffset = 0;
+  return true;
+}
+
+bool FileStore::writeRecord(const std::vector<char>& record, Position& position)
+{
+  if ((mWriteFd < 0 || mWriteOffset >= mSegmentSize) && !openNewSegment()) {
+    return false;
+  }
+  // one write per record, so that a crash leaves at most one incomplete record at the end of the segment
+  ssize_t written = ::write(mWriteFd, record.data(), record.size());
+  if (written != static_cast<ssize_t>(record.size())) {
+    LOG(ERROR) << "Cannot write to the segment " << segmentPath(mWriteSegment) << ": " << strerror(errno);
+    if (ftruncate(mWriteFd, mWriteOffset) != 0) {
+      openNewSegment(); // the partial record is left behind at the end of the segment, the recovery skips it
+    }
+    return false;
+  }
+  position = { mWriteSegment, mWriteOffset };
+  mWriteOffset += record.size();
+  mSize += record.size();
+  return true;
+}
+
+bool FileStore::append(const SerializedObject& object)
+{
+  auto record = serialize(object, 0);
+  std::lock_guard<std::mutex> lock(mWriteMutex);
+  Position position;
+  if (!writeRecord(record, position)) {
+    return false;
+  }
+  {
+    std::unique_lock<std::shared_mutex> indexLock(mIndexMutex);
+    addEntry(0, object.path, object.validFrom, object.validTo, position);
+  }
+  if (mUnindexed.size() >= mMaxUnindexed) {
+    writeIndex();
+  }
+  return true;
+}
+
+bool FileStore::remove(const std::string& path)
+{
+  SerializedObject removal;
+  removal.path = path;
+  auto record = serialize(removal, removalFlag);
+  std::lock_guard<std::mutex> lock(mWriteMutex);
+  Position position;
+  if (!writeRecord(record, position)) {
+    return false;
+  }
+  std::unique_lock<std::shared_mutex> indexLock(mIndexMutex);
+  addEntry(removalFlag, path, 0, 0, position);
+  return true;
+}
+
+uint32_t FileStore::pathId(const std::string& path)
+{
+  auto id = mPathIds.find(path);
+  if (id != mPathIds.end()) {
+    return id->second;
+  }
+  mPaths.push_back(path);
+  mRemovedBefore.emplace_back(0, 0);
+  mLatest.emplace_back(0, 0);
+  return mPathIds[path] = mPaths.size() - 1;
+}
+
+void FileStore::addEntry(uint32_t flags, const std::string& path, int64_t validFrom, int64_t validTo, Position position)
+{
+  uint32_t id = pathId(path);
+  if (flags & removalFlag) {
+    mRemovedBefore[id] = std::max(mRemovedBefore[id], position);
+  } else {
+    mUnindexed.insert({ id, position.first, validFrom, validTo, position.second });
+    mLatest[id] = std::max(mLatest[id], position);
+  }
+  mIndexChanged = true;
+}
+
+bool FileStore::isRemoved(const Entry& entry) const
+{
+  return Position{ entry.segment, entry.offset } < mRemovedBefore[entry.pathId];
+}
+
+std::vector<FileStore::Entry> FileStore::entries(uint32_t pathId, int64_t from, int64_t to) const
+{
+  Entry first{ pathId, 0, from, 0, 0 };
+  Entry last{ pathId, UINT32_MAX, to, 0, UINT64_MAX };
+  const Entry* begin = std::lower_bound(mIndexed, mIndexed + mNumberOfIndexed, first);
+  const Entry* end = std::upper_bound(begin, mIndexed + mNumberOfIndexed, last);
+  std::vector<Entry> result;
+  std::merge(begin, end, mUnindexed.lower_bound(first), mUnindexed.upper_bound(last), std::back_inserter(result));
+  result.erase(std::remove_if(result.begin(), result.end(), [this](const Entry& entry) { return isRemoved(entry); }),
+               result.end());
+  return result;
+}
+
+int FileStore::segmentFd(uint32_t segment) const
+{
+  std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+  return segment < mSegmentFds.size() ? mSegmentFds[segment] : -1;
+}
+
+bool FileStore::find(const std::string& path, long timestamp, SerializedObject& object) const
+{
+  Entry found{};
+  {
+    std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+    auto id = mPathIds.find(path);
+    if (id == mPathIds.end()) {
+      return false;
+    }
+    // in each part of the index, the versions of the path starting before the timestamp, the latest one last
+    Entry last{ id->second, UINT32_MAX, timestamp, 0, UINT64_MAX };
+    auto latestValid = [&](auto begin, auto end) -> const Entry* {
+      for (auto entry = end; entry != begin;) {
+        --entry;
+        if (entry->pathId != last.pathId) {
+          break;
+        }
+        if (timestamp < entry->validTo && !isRemoved(*entry)) {
+          return &*entry;
+        }
+      }
+      return nullptr;
+    };
+    const Entry* indexed = latestValid(mIndexed, std::upper_bound(mIndexed, mIndexed + mNumberOfIndexed, last));
+    const Entry* unindexed = latestValid(mUnindexed.begin(), mUnindexed.upper_bound(last));
+    if (indexed == nullptr && unindexed == nullptr) {
+      return false;
+    }
+    found = indexed == nullptr || (unindexed != nullptr && *indexed < *unindexed) ? *unindexed : *indexed;
+  }
+  uint32_t flags = 0;
+  uint64_t size = 0;
+  return readRecordAt(segmentFd(found.segment), found.offset, UINT64_MAX, true, object, flags, size);
+}
+
+std::vector<StoredVersion> FileStore::list(const std::string& path, long from, long to) const
+{
+  std::vector<Entry> found;
+  {
+    std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+    auto id = mPathIds.find(path);
+    if (id == mPathIds.end()) {
+      return {};
+    }
+    found = entries(id->second, from, to);
+  }
+
+  std::vector<StoredVersion> versions;
+  versions.reserve(found.size());
+  for (const auto& entry : found) {
+    SerializedObject object;
+    uint32_t flags = 0;
+    uint64_t size = 0;
+    if (!readRecordAt(segmentFd(entry.segment), entry.offset, UINT64_MAX, false, object, flags, size)) {
+      LOG(ERROR) << "Cannot read the version of " << path << " at " << entry.offset << " in " << segmentPath(entry.segment);
+      continue;
+    }
+    versions.push_back({ path, entry.validFrom, entry.validTo, std::move(object.metadata), entry.segment, entry.offset });
+  }
+  return versions;
+}
+
+bool FileStore::read(const StoredVersion& version, SerializedObject& object) const
+{
+  uint32_t flags = 0;
+  uint64_t size = 0;
+  return readRecordAt(segmentFd(version.segment), version.offset, UINT64_MAX, true, object, flags, size) &&
+         object.path == version.path;
+}
+
+std::vector<std::string> FileStore::paths(const std::string& prefix) const
+{
+  std::vector<std::string> result;
+  {
+    std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+    for (uint32_t id = 0; id < mPaths.size(); id++) {
+      if (mLatest[id] > mRemovedBefore[id] && mPaths[id].compare(0, prefix.size(), prefix) == 0) {
+        result.push_back(mPaths[id]);
+      }
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+bool FileStore::flush()
+{
+  // the versions missing in the index are found again by the recovery, it is rewritten only when they are many
+  std::lock_guard<std::mutex> lock(mWriteMutex);
+  if (mWriteFd >= 0 && fdatasync(mWriteFd) != 0) {
+    LOG(ERROR) << "Cannot write the segment " << segmentPath(mWriteSegment) << " to the disk: " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool FileStore::writeIndex()
+{
+  if (!mIndexChanged) {
+    return true;
+  }
+  // the index must not refer to records which could still be lost
+  if (mWriteFd >= 0 && fdatasync(mWriteFd) != 0) {
+    LOG(ERROR) << "Cannot write the segment " << segmentPath(mWriteSegment) << " to the disk: " << strerror(errno);
+    return false;
+  }
+
+  // the writer holds the write mutex, the index can only change under it, the readers can go on meanwhile
+  std::vector<char> content(indexHeaderSize);
+  uint64_t numberOfEntries = 0;
+  {
+    std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+    std::vector<Entry> merged;
+    merged.reserve(mNumberOfIndexed + mUnindexed.size());
+    std::merge(mIndexed, mIndexed + mNumberOfIndexed, mUnindexed.begin(), mUnindexed.end(), std::back_inserter(merged));
+    merged.erase(std::remove_if(merged.begin(), merged.end(), [this](const Entry& entry) { return isRemoved(entry); }),
+                 merged.end());
+    numberOfEntries = merged.size();
+    const char* bytes = reinterpret_cast<const char*>(merged.data());
+    content.insert(content.end(), bytes, bytes + merged.size() * sizeof(Entry));
+
+    uint64_t header[8] = { indexMagic, numberOfEntries, mPaths.size(), mWriteSegment, mWriteOffset, content.size(), 0, 0 };
+    std::memcpy(content.data(), header, sizeof(header));
+    for (uint32_t id = 0; id < mPaths.size(); id++) {
+      putString(content, mPaths[id]);
+      put<uint32_t>(content, mRemovedBefore[id].first);
+      put<uint64_t>(content, mRemovedBefore[id].second);
+    }
+  }
+
+  // the new index replaces the previous one at once, a crash leaves one or the other
+  std::string path = mDirectory + "/" + mGeneration + "/index";
+  int fd = ::open((path + ".tmp").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  bool written = fd >= 0 && writeAll(fd, content.data(), content.size()) && fdatasync(fd) == 0;
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  if (!written || rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+    LOG(ERROR) << "Cannot write the index " << path << ": " << strerror(errno);
+    unlink((path + ".tmp").c_str());
+    return false;
+  }
+  size_t size = 0;
+  const char* data = mapIndexFile(path, size);
+  if (data == nullptr) {
+    LOG(ERROR) << "Cannot map the index " << path << ": " << strerror(errno);
+    return false;
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mIndexMutex);
+  unmapIndex();
+  mMapped = data;
+  mMappedSize = size;
+  mIndexed = reinterpret_cast<const Entry*>(data + indexHeaderSize);
+  mNumberOfIndexed = numberOfEntries;
+  mUnindexed.clear();
+  mIndexChanged = false;
+  return true;
+}
+
+void FileStore::closeFiles()
+{
+  std::lock_guard<std::mutex> lock(mWriteMutex);
+  writeIndex();
+  if (mWriteFd >= 0) {
+    ::close(mWriteFd);
+    mWriteFd = -1;
+  }
+  std::unique_lock<std::shared_mutex> indexLock(mIndexMutex);
+  for (int fd : mSegmentFds) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+  mSegmentFds.clear();
+  unmapIndex();
+}
+
+size_t FileStore::getNumberOfVersions() const
+{
+  std::shared_lock<std::shared_mutex> lock(mIndexMutex);
+  return mNumberOfIndexed + mUnindexed.size();
+}
+
+uint64_t FileStore::getSize() const
+{
+  return mSize;
+}
+
+bool FileStore::compact(const std::string& directory, size_t keepVersions, long keepSince)
+{
+  try {
+    FileStore source(directory);
+    std::string next = "g" + std::to_string(std::stoul(source.mGeneration.substr(1)) + 1);
+    removeDirectory(directory + "/" + next); // left by a compaction which failed
+
+    size_t kept = 0;
+    size_t dropped = 0;
+    {
+      // the index is written once, at the end
+      FileStore target(directory, next, source.mSegmentSize, SIZE_MAX);
+      for (const auto& path : source.paths()) {
+        auto versions = source.list(path, LONG_MIN, LONG_MAX);
+        for (size_t i = 0; i < versions.size(); i++) {
+          bool latest = keepVersions == 0 || versions.size() - i <= keepVersions;
+          if (!latest && versions[i].validFrom < keepSince) {
+            dropped++;
+            continue;
+          }
+          SerializedObject object;
+          if (!source.read(versions[i], object)) {
+            LOG(WARNING) << "Cannot read a version of " << path << ", it is dropped";
+            dropped++;
+            continue;
+          }
+          if (!target.append(object)) {
+            return false;
+          }
+          kept++;
+        }
+      }
+      if (!target.flush()) {
+        return false;
+      }
+    }
+
+    source.closeFiles();
+    if (!writeCurrent(directory, next)) {
+      return false;
+    }
+    removeDirectory(directory + "/" + source.mGeneration);
+    LOG(INFO) << "The file repository " << directory << " is compacted, " << kept << " versions are kept and "
+              << dropped << " dropped";
+    return true;
+  } catch (std::exception& e) {
+    LOG(ERROR) << "Cannot compact the file repository " << directory << ": " << e.what();
+    return false;
+  }
+}
+
+} // namespace o2::quality_control::repository
@@ -14,9 +14,15 @@
 ///
 
 #include "QualityControl/HistoMerger.h"
+#include "QualityControl/Decorations.h"
+#include "QualityControl/ThreadPool.h"
 
-#include <TH1.h>
+#include <charconv>
+#include <sstream>
+
+#include <TClass.h>
 #include <TObjArray.h>
+#include <TROOT.h>
 
 #include <Framework/DataSpecUtils.h>
 #include <Framework/DataRefUtils.h>
@@ -33,59 +39,289 @@ HistoMerger::HistoMerger(std::string mergerName, double publicationPeriodSeconds
   : mMergerName(mergerName), mOutputSpec{ header::gDataOriginInvalid, header::gDataDescriptionInvalid }
 {
   mPublicationTimer.reset(static_cast<int>(publicationPeriodSeconds * 1000000));
-  mMergedArray.SetOwner(true);
 }
 
+HistoMerger::HistoMerger(HistoMerger&&) = default;
+
 HistoMerger::~HistoMerger() {}
 
-void HistoMerger::init(framework::InitContext&) { mMergedArray.Clear(); }
+void HistoMerger::init(framework::InitContext&)
+{
+  mMergedObjects.clear();
+  mMergedObjectsIndex.clear();
+  if (mNumberOfThreads > 1) {
+    ROOT::EnableThreadSafety();
+    // the thread calling run() takes part in the merging as well
+    mThreadPool = std::make_unique<ThreadPool>(mNumberOfThreads - 1);
+  }
+}
 
 void HistoMerger::run(framework::ProcessingContext& ctx)
 {
   for (const auto& input : ctx.inputs()) {
-    if (input.header != nullptr && input.spec != nullptr) {
-      std::unique_ptr<TObjArray> moArray = DataRefUtils::as<TObjArray>(input);
-
-      if (mMergedArray.IsEmpty()) {
-        mMergedArray = *moArray.release();
-      } else {
-        if (mMergedArray.GetSize() != moArray->GetSize()) {
-          LOG(ERROR) << "array don't match in size, " << mMergedArray.GetSize() << " vs " << moArray->GetSize();
-          return;
-        }
-
-        for (int i = 0; i < mMergedArray.GetEntries(); i++) {
-          MonitorObject* mo = dynamic_cast<MonitorObject*>((*moArray)[i]);
-          if (mo && std::strstr(mo->getObject()->ClassName(), "TH1") != nullptr) {
-            TH1* h = dynamic_cast<TH1*>(dynamic_cast<MonitorObject*>(mMergedArray[i])->getObject());
-            const TH1* hUpdate = dynamic_cast<TH1*>(mo->getObject());
-            h->Add(hUpdate);
-          }
-        }
+    if (input.header == nullptr || input.spec == nullptr || input.spec->binding == "timer-deadline") {
+      continue; // the timer only wakes us up to check the deadline
+    }
+    auto producer = DataRefUtils::getHeader<header::DataHeader*>(input)->subSpecification;
+    std::unique_ptr<TObjArray> moArray = DataRefUtils::as<TObjArray>(input);
+    moArray->SetOwner(true); // the objects which are not adopted are deleted with the array
+    receive(*moArray, producer);
+  }
+  mergeReceived();
+
+  if (isPublicationTime()) {
+    publish(ctx);
+  }
+}
+
+void HistoMerger::receive(TObjArray& moArray, header::DataHeader::SubSpecificationType producer)
+{
+  if (mCycleProducers.empty()) {
+    mCycleStart = std::chrono::steady_clock::now();
+  }
+  mCycleProducers.insert(producer);
+
+  for (int i = 0; i <= moArray.GetLast(); i++) {
+    if (auto* mo = dynamic_cast<MonitorObject*>(moArray.At(i))) {
+      moArray.RemoveAt(i);
+      mo->setIsOwner(true);
+      if (mStripDecorations) {
+        checker::decorations::strip(mo->getObject());
       }
+      queueObject(std::unique_ptr<MonitorObject>(mo), producer);
     }
   }
-  if (mPublicationTimer.isTimeout()) {
-    if (!mMergedArray.IsEmpty()) {
-      auto concreteOutput = framework::DataSpecUtils::asConcreteDataMatcher(mOutputSpec);
-      ctx.outputs().snapshot(Output{ concreteOutput.origin, concreteOutput.description, concreteOutput.subSpec }, mMergedArray);
+}
+
+void HistoMerger::mergeReceived()
+{
+  // the objects are first sorted out by merged object, then each merged object is updated by one thread
+  if (mThreadPool && mUpdatedObjects.size() > 1) {
+    mThreadPool->parallelFor(mUpdatedObjects.size(), [&](size_t i) { mergePending(mMergedObjects[mUpdatedObjects[i]]); });
+  } else {
+    for (auto index : mUpdatedObjects) {
+      mergePending(mMergedObjects[index]);
+    }
+  }
+  // the merged updates are deleted by this thread, ROOT objects deletion is not thread-safe in all cases
+  for (auto index : mUpdatedObjects) {
+    mMergedObjects[index].pending.clear();
+  }
+  mUpdatedObjects.clear();
+}
+
+bool HistoMerger::isPublicationTime()
+{
+  if (mCycleDeadline.count() <= 0) {
+    if (!mPublicationTimer.isTimeout()) {
+      return false;
     }
     // avoid publishing mo many times consecutively because of too long initial waiting time
     do {
       mPublicationTimer.increment();
     } while (mPublicationTimer.isTimeout());
+    return true;
+  }
+
+  if (mCycleProducers.empty()) {
+    return false;
+  }
+  if (mCycleProducers.size() < mNumberOfProducers) {
+    if (std::chrono::steady_clock::now() - mCycleStart < mCycleDeadline) {
+      return false;
+    }
+    LOG(INFO) << "Deadline of the cycle is over, " << mMergerName << " publishes the contributions of "
+              << mCycleProducers.size() << " producers out of " << mNumberOfProducers;
+  }
+  mCycleProducers.clear();
+  return true;
+}
+
+std::set<header::DataHeader::SubSpecificationType> HistoMerger::parseContributors(const std::string& list)
+{
+  std::set<header::DataHeader::SubSpecificationType> contributors;
+  std::stringstream stream(list);
+  std::string contributor;
+  while (std::getline(stream, contributor, ',')) {
+    header::DataHeader::SubSpecificationType value = 0;
+    auto [end, error] = std::from_chars(contributor.data(), contributor.data() + contributor.size(), value);
+    if (error != std::errc() || end != contributor.data() + contributor.size()) {
+      LOG(WARNING) << "Skipping the malformed contributor '" << contributor << "'";
+      continue;
+    }
+    contributors.insert(value);
+  }
+  return contributors;
+}
+
+void HistoMerger::queueObject(std::unique_ptr<MonitorObject> mo, header::DataHeader::SubSpecificationType producer)
+{
+  auto now = std::chrono::steady_clock::now();
+
+  // objects coming from another merger list their own contributors
+  auto metadata = mo->getMetadataMap();
+  auto listed = metadata.find("contributors");
+  auto contributors = listed != metadata.end() ? parseContributors(listed->second)
+                                               : std::set<header::DataHeader::SubSpecificationType>{};
+  if (contributors.empty()) {
+    contributors.insert(producer);
+  }
+
+  auto position = mMergedObjectsIndex.find(mo->getName());
+  if (position == mMergedObjectsIndex.end()) {
+    // first time we see this object, it is the start of the merged one
+    mMergedObjectsIndex.emplace(mo->getName(), mMergedObjects.size());
+    MergedObject merged;
+    merged.mo = std::move(mo);
+    merged.lastUpdate = now;
+    merged.contributors = std::move(contributors);
+    mMergedObjects.push_back(std::move(merged));
+    return;
+  }
+
+  MergedObject& merged = mMergedObjects[position->second];
+  merged.lastUpdate = now;
+  merged.contributors.insert(contributors.begin(), contributors.end());
+  TObject* target = merged.mo->getObject();
+  if (target == nullptr || mo->getObject() == nullptr) {
+    return;
+  }
+  // the registry is not thread-safe, the function is resolved here rather than in mergePending()
+  if (target->IsA() != merged.objectClass) {
+    merged.objectClass = target->IsA();
+    merged.mergeFunction = mMergeRegistry.resolve(target);
+  }
+  if (merged.mergeFunction == nullptr) {
+    return;
+  }
+  if (merged.pending.empty()) {
+    mUpdatedObjects.push_back(position->second);
+  }
+  merged.pending.push_back(std::move(mo));
+}
+
+void HistoMerger::mergePending(MergedObject& merged)
+{
+  TObject* target = merged.mo->getObject();
+  for (const auto& mo : merged.pending) {
+    if (!(*merged.mergeFunction)(target, mo->getObject())) {
+      LOG(ERROR) << "Could not merge the object " << mo->getName() << " of class " << merged.objectClass->GetName();
+    }
+  }
+}
+
+void HistoMerger::removeExpiredObjects()
+{
+  if (mObjectsLifetime.count() <= 0) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < mMergedObjects.size();) {
+    if (now - mMergedObjects[i].lastUpdate <= mObjectsLifetime) {
+      i++;
+      continue;
+    }
+    LOG(INFO) << "Object " << mMergedObjects[i].mo->getName() << " was not received for "
+              << mObjectsLifetime.count() << " s, it is removed from the merger " << mMergerName;
+    // the last object takes the place of the removed one
+    mMergedObjectsIndex.erase(mMergedObjects[i].mo->getName());
+    if (i != mMergedObjects.size() - 1) {
+      mMergedObjects[i] = std::move(mMergedObjects.back());
+      mMergedObjectsIndex[mMergedObjects[i].mo->getName()] = i;
+    }
+    mMergedObjects.pop_back();
+  }
+}
+
+std::unique_ptr<TObjArray> HistoMerger::preparePublication()
+{
+  mergeReceived();
+  removeExpiredObjects();
+
+  auto isPublished = [this](const MergedObject& merged) {
+    return !mPublishOnlyUpdated || merged.lastUpdate > mLastPublication;
+  };
+  auto published = std::make_unique<TObjArray>();
+  published->Expand(mMergedObjects.size());
+  for (auto& merged : mMergedObjects) {
+    std::string contributors;
+    for (auto contributor : merged.contributors) {
+      contributors += (contributors.empty() ? "" : ",") + std::to_string(contributor);
+    }
+    merged.mo->addMetadata("contributors", contributors);
+    merged.mo->addMetadata("numberOfContributors", std::to_string(merged.contributors.size()));
+    merged.contributors.clear();
+    if (isPublished(merged)) {
+      published->Add(mResetAfterPublication ? merged.mo.release() : merged.mo.get());
+    }
+  }
+  mLastPublication = std::chrono::steady_clock::now();
+
+  if (mResetAfterPublication) {
+    // the published objects are handed over, the merging starts from scratch
+    published->SetOwner(true);
+    mMergedObjects.clear();
+    mMergedObjectsIndex.clear();
+  }
+  return published;
+}
+
+void HistoMerger::publish(framework::ProcessingContext& ctx)
+{
+  auto concreteOutput = framework::DataSpecUtils::asConcreteDataMatcher(mOutputSpec);
+  Output output{ concreteOutput.origin, concreteOutput.description, concreteOutput.subSpec };
+  auto published = preparePublication();
+  if (published->IsEmpty()) {
+    return;
+  }
+  if (mResetAfterPublication) {
+    // DPL serializes the objects it adopts, they are not merged anymore
+    ctx.outputs().adopt(output, published.release());
+  } else {
+    // the merged objects are still merged afterwards, they are serialized right away
+    ctx.outputs().snapshot(output, *published);
+  }
+}
+
+void HistoMerger::addMergeFunction(const std::string& className, MergeRegistry::MergeFunction function)
+{
+  mMergeRegistry.add(className, std::move(function));
+  // the functions resolved so far are not valid anymore
+  for (auto& merged : mMergedObjects) {
+    merged.objectClass = nullptr;
+    merged.mergeFunction = nullptr;
   }
 }
 
 void HistoMerger::configureInputsOutputs(DataOrigin origin, DataDescription description,
-                                         std::pair<SubSpecificationType, SubSpecificationType> subSpecRange)
+                                         std::pair<SubSpecificationType, SubSpecificationType> subSpecRange,
+                                         SubSpecificationType outputSubSpec)
 {
   mInputSpecs.clear();
+  mOptions.clear();
 
   for (SubSpecificationType s = subSpecRange.first; s <= subSpecRange.second; s++) {
     mInputSpecs.push_back({ "mo", origin, description, s });
   }
-  mOutputSpec = OutputSpec{ origin, description, 0 };
+  mNumberOfProducers = mInputSpecs.size();
+  mOutputSpec = OutputSpec{ origin, description, outputSubSpec };
+
+  if (mCycleDeadline.count() > 0) {
+    // the deadline is checked ten times within its duration, the timer is unique to this merger by its subspec
+    mInputSpecs.push_back({ "timer-deadline", header::DataOrigin{ "MRGT" }, description, outputSubSpec, Lifetime::Timer });
+    mOptions.push_back({ "period-timer-deadline", VariantType::Int,
+                         std::max(1, static_cast<int>(mCycleDeadline.count() * 100000)), { "deadline timer period" } });
+  }
+}
+
+framework::CompletionPolicy::CompletionOp HistoMerger::completionPolicyCallback(gsl::span<framework::PartRef const> const& inputs)
+{
+  for (auto& input : inputs) {
+    if (input.header != nullptr && input.payload != nullptr) {
+      return framework::CompletionPolicy::CompletionOp::Consume;
+    }
+  }
+  return framework::CompletionPolicy::CompletionOp::Wait;
 }
 
 } // namespace o2::quality_control::core
\ No newline at end of file
@@ -0,0 +1,145 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   HistogramAdd.cxx
+///
+
+#include "QualityControl/HistogramAdd.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include <TAxis.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TH3.h>
+
+namespace o2::quality_control::core::histograms
+{
+
+bool isPlainHistogram(const TClass* histoClass)
+{
+  static const TClass* plainClasses[] = {
+    TH1I::Class(), TH1F::Class(), TH1D::Class(),
+    TH2I::Class(), TH2F::Class(), TH2D::Class(),
+    TH3I::Class(), TH3F::Class(), TH3D::Class()
+  };
+  return std::find(std::begin(plainClasses), std::end(plainClasses), histoClass) != std::end(plainClasses);
+}
+
+namespace
+{
+
+bool sameAxis(const TAxis& a, const TAxis& b)
+{
+  if (a.GetNbins() != b.GetNbins() || a.GetXmin() != b.GetXmin() || a.GetXmax() != b.GetXmax()) {
+    return false;
+  }
+  // alphanumeric bins are matched by label by TH1::Add
+  if (a.GetLabels() != nullptr || b.GetLabels() != nullptr) {
+    return false;
+  }
+  const TArrayD* edgesA = a.GetXbins();
+  const TArrayD* edgesB = b.GetXbins();
+  return edgesA->fN == edgesB->fN && std::equal(edgesA->fArray, edgesA->fArray + edgesA->fN, edgesB->fArray);
+}
+
+template <typename T>
+void addArrays(T* __restrict target, const T* __restrict other, int size)
+{
+  for (int i = 0; i < size; i++) {
+    target[i] += other[i];
+  }
+}
+
+// integer bins saturate instead of overflowing, as in TH1I::AddBinContent
+void addArrays(Int_t* __restrict target, const Int_t* __restrict other, int size)
+{
+  for (int i = 0; i < size; i++) {
+    Long64_t sum = static_cast<Long64_t>(target[i]) + other[i];
+    target[i] = static_cast<Int_t>(std::clamp<Long64_t>(sum, -INT_MAX, INT_MAX));
+  }
+}
+
+// without sumw2, the squared error of a bin is its content
+template <typename T>
+void addContentsAsSumw2(double* __restrict sumw2, const T* __restrict content, int size)
+{
+  for (int i = 0; i < size; i++) {
+    sumw2[i] += std::abs(static_cast<double>(content[i]));
+  }
+}
+
+template <typename Array>
+bool addBinArrays(TH1& target, const TH1& other)
+{
+  auto* targetArray = dynamic_cast<Array*>(&target);
+  auto* otherArray = dynamic_cast<const Array*>(&other);
+  if (targetArray == nullptr || otherArray == nullptr) {
+    return false;
+  }
+  addArrays(targetArray->fArray, otherArray->fArray, targetArray->fN);
+  if (target.GetSumw2N() > 0) {
+    if (other.GetSumw2N() > 0) {
+      addArrays(target.GetSumw2()->fArray, other.GetSumw2()->fArray, target.GetSumw2N());
+    } else {
+      addContentsAsSumw2(target.GetSumw2()->fArray, otherArray->fArray, targetArray->fN);
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+bool haveSameLayout(const TH1& target, const TH1& other)
+{
+  return target.IsA() == other.IsA() && isPlainHistogram(target.IsA()) &&
+         sameAxis(*target.GetXaxis(), *other.GetXaxis()) &&
+         sameAxis(*target.GetYaxis(), *other.GetYaxis()) &&
+         sameAxis(*target.GetZaxis(), *other.GetZaxis());
+}
+
+bool addSameLayout(TH1& target, const TH1& other)
+{
+  if (!haveSameLayout(target, other)) {
+    return false;
+  }
+  // cases where TH1::Add does more: creating the sumw2 of the target, emptying the buffers, averaging the bins,
+  // other errors than the square root of the content
+  if ((target.GetSumw2N() == 0 && other.GetSumw2N() > 0) || target.GetBuffer() != nullptr ||
+      other.GetBuffer() != nullptr || target.TestBit(TH1::kIsAverage) || other.TestBit(TH1::kIsAverage) ||
+      other.GetBinErrorOption() != TH1::kNormal) {
+    return false;
+  }
+
+  // the statistics are taken before the bins are modified, as TH1::Add does
+  Double_t targetStats[TH1::kNstat] = { 0 };
+  Double_t otherStats[TH1::kNstat] = { 0 };
+  target.GetStats(targetStats);
+  other.GetStats(otherStats);
+  Double_t entries = target.GetEntries() + other.GetEntries();
+
+  bool added = addBinArrays<TArrayF>(target, other) || addBinArrays<TArrayD>(target, other) ||
+               addBinArrays<TArrayI>(target, other);
+  if (!added) {
+    return false;
+  }
+
+  for (int i = 0; i < TH1::kNstat; i++) {
+    targetStats[i] += otherStats[i];
+  }
+  target.PutStats(targetStats);
+  target.SetEntries(entries);
+  return true;
+}
+
+} // namespace o2::quality_control::core::histograms
@@ -15,13 +15,19 @@
 
 #include "QualityControl/InfrastructureGenerator.h"
 
+#include "QualityControl/Checker.h"
 #include "QualityControl/CheckerFactory.h"
 #include "QualityControl/HistoMerger.h"
+#include "QualityControl/QualityAggregator.h"
 #include "QualityControl/TaskRunner.h"
 #include "QualityControl/TaskRunnerFactory.h"
 
+#include <algorithm>
+
 #include <boost/property_tree/ptree.hpp>
 #include <Configuration/ConfigurationFactory.h>
+#include <Framework/CompletionPolicy.h>
+#include <Framework/DeviceSpec.h>
 
 using namespace o2::framework;
 using namespace o2::configuration;
@@ -73,7 +79,7 @@ o2::framework::WorkflowSpec InfrastructureGenerator::generateRemoteInfrastructur
   auto config = ConfigurationFactory::getConfiguration(configurationSource);
 
   TaskRunnerFactory taskRunnerFactory;
-  CheckerFactory checkerFactory;
+  std::vector<std::string> checkedTasks;
   for (const auto& [taskName, taskConfig] : config->getRecursive("qc.tasks")) {
     // todo sanitize somehow this if-frenzy
     if (taskConfig.get<bool>("active", true)) {
@@ -82,20 +88,21 @@ o2::framework::WorkflowSpec InfrastructureGenerator::generateRemoteInfrastructur
 
         //todo use real mergers when they are done
 
-        // generate merger only, when there is a need to merge something
-        if (taskConfig.get_child("machines").size() > 1) {
-          HistoMerger merger(taskName + "-merger", 1);
-          merger.configureInputsOutputs(TaskRunner::createTaskDataOrigin(),
-                                        TaskRunner::createTaskDataDescription(taskName),
-                                        { 1, taskConfig.get_child("machines").size() });
-          DataProcessorSpec mergerSpec{
-            merger.getName(),
-            merger.getInputSpecs(),
-            Outputs{ merger.getOutputSpec() },
-            adaptFromTask<HistoMerger>(std::move(merger)),
-          };
-
-          workflow.emplace_back(mergerSpec);
+        // generate mergers only, when there is a need to merge something
+        size_t numberOfMachines = taskConfig.get_child("machines").size();
+        if (numberOfMachines > 1) {
+          auto mergersPerLayer = computeMergersTopology(numberOfMachines,
+                                                        std::max(0, config->get<int>("qc.config.mergers.fanIn", 0)),
+                                                        std::max(0, config->get<int>("qc.config.mergers.layers", 0)));
+          generateMergers(workflow, taskName + "-merger", TaskRunner::createTaskDataOrigin(),
+                          TaskRunner::createTaskDataDescription(taskName), numberOfMachines, mergersPerLayer,
+                          [&config](HistoMerger& merger) {
+                            merger.setStripDecorations(config->get<bool>("qc.config.decorations.strip", false));
+                            merger.setObjectsLifetime(config->get<double>("qc.config.mergers.objectsLifetime", 0));
+                            merger.setNumberOfThreads(std::max(1, config->get<int>("qc.config.mergers.threads", 1)));
+                            merger.setPublishOnlyUpdated(config->get<bool>("qc.config.mergers.publishOnlyUpdated", false));
+                            merger.setCycleDeadline(config->get<double>("qc.config.mergers.cycleDeadline", 0));
+                          });
         }
 
       } else if (taskConfig.get<std::string>("location") == "remote") {
@@ -104,12 +111,123 @@ o2::framework::WorkflowSpec InfrastructureGenerator::generateRemoteInfrastructur
         workflow.emplace_back(taskRunnerFactory.create(taskName, configurationSource, 0));
       }
 
-      workflow.emplace_back(checkerFactory.create(taskName + "-checker", taskName, configurationSource));
+      checkedTasks.push_back(taskName);
     }
   }
+
+  generateCheckers(workflow, checkedTasks, configurationSource, config->get<int>("qc.config.infrastructure.numberOfCheckers", 0));
+
+  if (config->get<bool>("qc.config.aggregator.active", false) && !checkedTasks.empty()) {
+    QualityAggregator aggregator(QualityAggregator::createAggregatorIdString(), checkedTasks, configurationSource);
+    DataProcessorSpec aggregatorSpec{
+      aggregator.getName(),
+      aggregator.getInputSpecs(),
+      Outputs{ aggregator.getOutputSpec() },
+      adaptFromTask<QualityAggregator>(std::move(aggregator)),
+    };
+    workflow.emplace_back(aggregatorSpec);
+  }
+
   return workflow;
 }
 
+void InfrastructureGenerator::generateCheckers(framework::WorkflowSpec& workflow, const std::vector<std::string>& taskNames,
+                                               std::string configurationSource, int numberOfCheckers)
+{
+  CheckerFactory checkerFactory;
+
+  if (numberOfCheckers <= 0) {
+    // one Checker per task
+    for (const auto& taskName : taskNames) {
+      workflow.emplace_back(checkerFactory.create(taskName + "-checker", taskName, configurationSource));
+    }
+    return;
+  }
+
+  // tasks are distributed in a round-robin fashion among the requested number of Checkers
+  std::vector<std::vector<std::string>> groups(std::min(static_cast<size_t>(numberOfCheckers), taskNames.size()));
+  for (size_t i = 0; i < taskNames.size(); i++) {
+    groups[i % groups.size()].push_back(taskNames[i]);
+  }
+  for (size_t i = 0; i < groups.size(); i++) {
+    workflow.emplace_back(checkerFactory.create(Checker::createCheckerIdString() + "-" + std::to_string(i), groups[i], configurationSource));
+  }
+}
+
+std::vector<size_t> InfrastructureGenerator::computeMergersTopology(size_t numberOfInputs, size_t fanIn, size_t layers)
+{
+  if (numberOfInputs == 0) {
+    return {};
+  }
+  if (layers > 0) {
+    // the smallest fan-in which allows to merge everything within the number of layers
+    fanIn = 2;
+    auto reachable = [&]() {
+      size_t inputs = numberOfInputs;
+      for (size_t l = 0; l < layers; l++) {
+        inputs = (inputs + fanIn - 1) / fanIn;
+      }
+      return inputs == 1;
+    };
+    while (!reachable()) {
+      fanIn++;
+    }
+  } else if (fanIn <= 1) {
+    return { 1 };
+  }
+
+  std::vector<size_t> mergersPerLayer;
+  size_t inputs = numberOfInputs;
+  do {
+    inputs = (inputs + fanIn - 1) / fanIn;
+    mergersPerLayer.push_back(inputs);
+  } while (inputs > 1);
+  return mergersPerLayer;
+}
+
+void InfrastructureGenerator::generateMergers(framework::WorkflowSpec& workflow, const std::string& mergerName,
+                                              header::DataOrigin origin, header::DataDescription description,
+                                              size_t numberOfInputs, const std::vector<size_t>& mergersPerLayer,
+                                              const std::function<void(HistoMerger&)>& configure)
+{
+  using SubSpecificationType = header::DataHeader::SubSpecificationType;
+
+  // subspecs of the inputs of the current layer, the producers have 1..numberOfInputs
+  SubSpecificationType firstInput = 1;
+  size_t inputs = numberOfInputs;
+  for (size_t layer = 0; layer < mergersPerLayer.size(); layer++) {
+    size_t mergers = mergersPerLayer[layer];
+    bool lastLayer = layer == mergersPerLayer.size() - 1;
+    SubSpecificationType firstOutput = firstInput + inputs;
+
+    for (size_t m = 0; m < mergers; m++) {
+      // the inputs are spread evenly among the mergers of the layer
+      SubSpecificationType rangeBegin = firstInput + m * inputs / mergers;
+      SubSpecificationType rangeEnd = firstInput + (m + 1) * inputs / mergers - 1;
+
+      HistoMerger merger(lastLayer ? mergerName : mergerName + "-" + std::to_string(layer) + "-" + std::to_string(m), 1);
+      if (configure) {
+        configure(merger);
+      }
+      merger.setResetAfterPublication(!lastLayer);
+      merger.configureInputsOutputs(origin, description, { rangeBegin, rangeEnd },
+                                    lastLayer ? 0 : static_cast<SubSpecificationType>(firstOutput + m));
+      auto options = merger.getOptions(); // the merger is moved away before the last member is initialized
+      DataProcessorSpec mergerSpec{
+        merger.getName(),
+        merger.getInputSpecs(),
+        Outputs{ merger.getOutputSpec() },
+        adaptFromTask<HistoMerger>(std::move(merger)),
+        options
+      };
+      workflow.emplace_back(mergerSpec);
+    }
+
+    firstInput = firstOutput;
+    inputs = mergers;
+  }
+}
+
 void InfrastructureGenerator::generateRemoteInfrastructure(framework::WorkflowSpec& workflow, std::string configurationSource)
 {
   auto qcInfrastructure = InfrastructureGenerator::generateRemoteInfrastructure(configurationSource);
@@ -119,6 +237,17 @@ void InfrastructureGenerator::generateRemoteInfrastructure(framework::WorkflowSp
 void InfrastructureGenerator::customizeInfrastructure(std::vector<framework::CompletionPolicy>& policies)
 {
   TaskRunnerFactory::customizeInfrastructure(policies);
+  CheckerFactory::customizeInfrastructure(policies);
+
+  auto aggregatorMatcher = [](framework::DeviceSpec const& device) {
+    return device.name.find(QualityAggregator::createAggregatorIdString()) != std::string::npos;
+  };
+  policies.push_back({ "qualityAggregatorCompletionPolicy", aggregatorMatcher, QualityAggregator::completionPolicyCallback });
+
+  auto mergerMatcher = [](framework::DeviceSpec const& device) {
+    return device.name.find("-merger") != std::string::npos;
+  };
+  policies.push_back({ "mergerCompletionPolicy", mergerMatcher, HistoMerger::completionPolicyCallback });
 }
 
 } // namespace o2::quality_control::core
\ No newline at end of file
@@ -0,0 +1,172 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   MergeRegistry.cxx
+///
+
+#include "QualityControl/MergeRegistry.h"
+#include "QualityControl/HistogramAdd.h"
+#include "QualityControl/Mergeable.h"
+
+#include <deque>
+
+#include <TBaseClass.h>
+#include <TClass.h>
+#include <TGraph.h>
+#include <TH1.h>
+#include <THnBase.h>
+#include <TList.h>
+#include <TTree.h>
+
+#include <fairlogger/Logger.h>
+
+namespace o2::quality_control::core
+{
+
+MergeRegistry::MergeRegistry()
+{
+  add(TH1::Class(), [](TObject* target, TObject* other) {
+    auto* otherHisto = dynamic_cast<TH1*>(other);
+    if (otherHisto == nullptr) {
+      return false;
+    }
+    auto* targetHisto = static_cast<TH1*>(target);
+    // usually the histograms have the same binning and can be added array by array
+    return histograms::addSameLayout(*targetHisto, *otherHisto) || targetHisto->Add(otherHisto);
+  });
+  add(THnBase::Class(), [](TObject* target, TObject* other) {
+    auto* otherHisto = dynamic_cast<THnBase*>(other);
+    if (otherHisto == nullptr) {
+      return false;
+    }
+    static_cast<THnBase*>(target)->Add(otherHisto);
+    return true;
+  });
+  add(TGraph::Class(), [](TObject* target, TObject* other) {
+    if (dynamic_cast<TGraph*>(other) == nullptr) {
+      return false;
+    }
+    TList list;
+    list.Add(other);
+    return static_cast<TGraph*>(target)->Merge(&list) >= 0;
+  });
+  add(TTree::Class(), [](TObject* target, TObject* other) {
+    if (dynamic_cast<TTree*>(other) == nullptr) {
+      return false;
+    }
+    TList list;
+    list.Add(other);
+    return static_cast<TTree*>(target)->Merge(&list) >= 0;
+  });
+
+  mMergeableFunction = [](TObject* target, TObject* other) {
+    auto* mergeable = dynamic_cast<Mergeable*>(target);
+    return mergeable != nullptr && other->IsA() == target->IsA() && mergeable->merge(other);
+  };
+  // the classes with a dictionary can also be resolved by their base classes
+  add("o2::quality_control::core::Mergeable", mMergeableFunction);
+}
+
+void MergeRegistry::add(TClass* objectClass, MergeFunction function)
+{
+  if (objectClass == nullptr) {
+    LOG(ERROR) << "Cannot register a merge function for an unknown class";
+    return;
+  }
+  mFunctions[objectClass] = std::move(function);
+  mResolved.clear();
+}
+
+void MergeRegistry::add(const std::string& className, MergeFunction function)
+{
+  TClass* objectClass = TClass::GetClass(className.c_str());
+  if (objectClass == nullptr) {
+    LOG(WARNING) << "Class " << className << " is not known by ROOT, its merge function is not registered";
+    return;
+  }
+  add(objectClass, std::move(function));
+}
+
+const MergeRegistry::MergeFunction* MergeRegistry::resolve(TClass* objectClass)
+{
+  if (objectClass == nullptr) {
+    return nullptr;
+  }
+  auto resolved = mResolved.find(objectClass);
+  if (resolved != mResolved.end()) {
+    return resolved->second;
+  }
+  const MergeFunction* function = findForClass(objectClass);
+  if (function == nullptr) {
+    LOG(WARNING) << "The objects of class " << objectClass->GetName() << " cannot be merged";
+  }
+  mResolved[objectClass] = function;
+  return function;
+}
+
+const MergeRegistry::MergeFunction* MergeRegistry::resolve(const TObject* object)
+{
+  if (object == nullptr) {
+    return nullptr;
+  }
+  // custom classes without a dictionary are only known as their ROOT base class
+  if (dynamic_cast<const Mergeable*>(object) != nullptr) {
+    return &mMergeableFunction;
+  }
+  return resolve(object->IsA());
+}
+
+bool MergeRegistry::merge(TObject* target, TObject* other)
+{
+  const MergeFunction* function = resolve(target);
+  return function != nullptr && other != nullptr && (*function)(target, other);
+}
+
+const MergeRegistry::MergeFunction* MergeRegistry::findForClass(TClass* objectClass)
+{
+  // breadth-first search of the nearest base class with a registered function
+  std::deque<TClass*> classes{ objectClass };
+  while (!classes.empty()) {
+    TClass* currentClass = classes.front();
+    classes.pop_front();
+    auto registered = mFunctions.find(currentClass);
+    if (registered != mFunctions.end()) {
+      return &registered->second;
+    }
+    if (TList* bases = currentClass->GetListOfBases()) {
+      for (auto* base : *bases) {
+        if (TClass* baseClass = static_cast<TBaseClass*>(base)->GetClassPointer()) {
+          classes.push_back(baseClass);
+        }
+      }
+    }
+  }
+
+  // otherwise the Merge(TCollection*) method of the class, if any
+  ROOT::MergeFunc_t mergeMethod = objectClass->GetMerge();
+  if (mergeMethod == nullptr) {
+    return nullptr;
+  }
+  auto& function = mGenericFunctions[objectClass];
+  function = [objectClass, mergeMethod](TObject* target, TObject* other) {
+    if (other->IsA() != target->IsA()) {
+      return false;
+    }
+    TList list;
+    list.Add(other);
+    // the method expects the address of the object of this class, which might not be the one of its TObject base
+    void* address = objectClass->DynamicCast(TObject::Class(), target, false);
+    return address != nullptr && mergeMethod(address, &list, nullptr) >= 0;
+  };
+  return &function;
+}
+
+} // namespace o2::quality_control::core
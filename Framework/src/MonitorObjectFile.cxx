@@ -0,0 +1,86 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   MonitorObjectFile.cxx
+///
+
+#include "QualityControl/MonitorObjectFile.h"
+#include "QualityControl/MonitorObject.h"
+#include "Common/Exceptions.h"
+
+#include <TH1.h>
+#include <TMemFile.h>
+
+#include <fairlogger/Logger.h>
+#include <boost/algorithm/string.hpp>
+
+using namespace AliceO2::Common;
+
+namespace o2::quality_control::repository::objectfiles
+{
+
+std::string prepareStorage(const core::MonitorObject& mo, std::map<std::string, std::string>& metadata)
+{
+  if (mo.getName().length() == 0 || mo.getTaskName().length() == 0) {
+    BOOST_THROW_EXCEPTION(DatabaseException()
+                          << errinfo_details("Object and task names can't be empty. Do not store."));
+  }
+
+  if (mo.getName().find_first_of("\t\n ") != std::string::npos ||
+      mo.getTaskName().find_first_of("\t\n ") != std::string::npos) {
+    BOOST_THROW_EXCEPTION(DatabaseException()
+                          << errinfo_details("Object and task names can't contain white spaces. Do not store."));
+  }
+
+  // metadata
+  metadata["quality"] = std::to_string(mo.getQuality().getLevel());
+  std::map<std::string, std::string> userMetadata = mo.getMetadataMap();
+  if (!userMetadata.empty()) {
+    metadata.insert(userMetadata.begin(), userMetadata.end());
+  }
+
+  return "qc/" + mo.getDetectorName() + "/" + mo.getTaskName() + "/" + mo.getName();
+}
+
+void write(const core::MonitorObject& mo, SerializedObject& object)
+{
+  object.fileName = boost::replace_all_copy(mo.getName(), "/", "_") + "_" + std::to_string(object.validFrom) + ".root";
+  TDirectory::TContext context; // the memory file becomes the current directory until the end of the scope
+  TMemFile file(object.fileName.c_str(), "RECREATE");
+  file.WriteTObject(&mo, objectKey);
+  file.Close();
+  object.content.resize(file.GetSize());
+  file.CopyTo(object.content.data(), object.content.size());
+}
+
+core::MonitorObject* read(const char* content, size_t size, const std::string& path)
+{
+  TDirectory::TContext context;
+  TMemFile file(path.c_str(), const_cast<char*>(content), size, "READ");
+  TObject* object = file.Get(objectKey);
+  if (object == nullptr) {
+    LOG(ERROR) << "Could not read the object " << path;
+    return nullptr;
+  }
+  auto* mo = dynamic_cast<core::MonitorObject*>(object);
+  if (mo == nullptr) {
+    LOG(ERROR) << "Could not cast the object " << path << " to MonitorObject";
+    delete object;
+    return nullptr;
+  }
+  // the histograms read from the file would be deleted with it
+  if (auto* histogram = dynamic_cast<TH1*>(mo->getObject())) {
+    histogram->SetDirectory(nullptr);
+  }
+  return mo;
+}
+
+} // namespace o2::quality_control::repository::objectfiles
@@ -14,6 +14,11 @@
 ///
 
 // std
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <functional>
+#include <set>
 #include <sstream>
 // ROOT
 #include <TMessage.h>
@@ -27,6 +32,7 @@
 // QC
 #include "QualityControl/MySqlDatabase.h"
 #include "QualityControl/QcInfoLogger.h"
+#include "QualityControl/SparseHistogram.h"
 
 using namespace AliceO2::Common;
 using namespace std;
@@ -111,6 +117,27 @@ void MySqlDatabase::storeQueue()
   lastStorage.reset();
 }
 
+namespace
+{
+// the run column of the object, from its metadata runMetadataKey, 0 if it has none
+int runOf(const MonitorObject& mo)
+{
+  auto metadata = mo.getMetadataMap();
+  auto run = metadata.find(runMetadataKey);
+  if (run == metadata.end()) {
+    return 0;
+  }
+  char* end = nullptr;
+  long value = std::strtol(run->second.c_str(), &end, 10);
+  if (run->second.empty() || *end != '\0' || value < 0 || value > INT_MAX) {
+    QcInfoLogger::GetInstance() << "Invalid run \"" << run->second << "\" of " << mo.getName() << ", stored as 0"
+                                << infologger::endm;
+    return 0;
+  }
+  return static_cast<int>(value);
+}
+} // namespace
+
 void MySqlDatabase::storeForTask(std::string taskName)
 {
   std::vector<std::shared_ptr<o2::quality_control::core::MonitorObject>> objects = mObjectsQueue[taskName];
@@ -150,7 +177,7 @@ void MySqlDatabase::storeForTask(std::string taskName)
     statement->NextIteration();
     statement->SetString(0, mo->getName().c_str());
     statement->SetBinary(1, message.Buffer(), message.Length(), message.Length());
-    statement->SetInt(2, 0);
+    statement->SetInt(2, runOf(*mo));
     statement->SetInt(3, 0);
   }
   statement->Process();
@@ -162,15 +189,192 @@ void MySqlDatabase::storeForTask(std::string taskName)
   objects.clear();
 }
 
-o2::quality_control::core::MonitorObject* MySqlDatabase::retrieve(std::string taskName, std::string objectName, long /*timestamp*/)
+namespace
 {
-  // TODO use the timestamp
+// the argument of FROM_UNIXTIME, which returns NULL after 2038 with MySQL 5
+double toUnixTime(long timestamp) { return std::min(timestamp / 1000.0, 2147483647.0); }
 
-  string query;
-  TMySQLStatement* statement = nullptr;
+// orders the rows of an object by their closeness to the time of the two parameters, the ones stored before it first:
+// a row of a run is replaced by each storage for the run, the version stored before the time may not be there anymore
+const char* const closestFirst = " ORDER BY updatetime > FROM_UNIXTIME(?), ABS(UNIX_TIMESTAMP(updatetime) - ?)";
+} // namespace
 
-  query += "SELECT object_name, data, updatetime, run, fill FROM data_" + taskName + " WHERE object_name = ?";
-  statement = (TMySQLStatement*)mServer->Statement(query.c_str());
+o2::quality_control::core::MonitorObject* MySqlDatabase::retrieve(std::string taskName, std::string objectName, long timestamp)
+{
+  string query = "SELECT object_name, data, updatetime, run, fill FROM data_" + taskName + " WHERE object_name = ?";
+  query += timestamp != 0 ? closestFirst : " ORDER BY updatetime DESC";
+  query += " LIMIT 1";
+  TMySQLStatement* statement = prepareStatement(query);
+  statement->NextIteration();
+  statement->SetString(0, objectName.c_str());
+  if (timestamp != 0) {
+    statement->SetDouble(1, toUnixTime(timestamp));
+    statement->SetDouble(2, toUnixTime(timestamp));
+  }
+  processStatement(statement);
+
+  o2::quality_control::core::MonitorObject* mo = nullptr;
+  if (statement->NextResultRow()) {
+    string name = statement->GetString(0);
+    //    TDatime updatetime(statement->GetYear(2), statement->GetMonth(2), statement->GetDay(2), statement->GetHour(2),
+    //                       statement->GetMinute(2), statement->GetSecond(2));
+    //    int run = statement->IsNull(3) ? -1 : statement->GetInt(3);
+    //    int fill = statement->IsNull(4) ? -1 : statement->GetInt(4);
+    mo = readObject(statement, 1);
+  }
+  delete statement;
+
+  return mo;
+}
+
+void MySqlDatabase::retrieveMany(std::string taskName, const std::vector<std::string>& objectNames, long timestamp,
+                                 const RetrieveCallback& callback)
+{
+  if (objectNames.empty()) {
+    return;
+  }
+
+  // one query for all the objects, each one is given to the callback as soon as its row is read
+  string query = "SELECT object_name, data FROM data_" + taskName + " WHERE object_name IN (?";
+  for (size_t i = 1; i < objectNames.size(); i++) {
+    query += ", ?";
+  }
+  query += ")";
+  query += timestamp != 0 ? closestFirst : " ORDER BY updatetime DESC";
+  TMySQLStatement* statement = prepareStatement(query);
+  statement->NextIteration();
+  for (size_t i = 0; i < objectNames.size(); i++) {
+    statement->SetString(i, objectNames[i].c_str());
+  }
+  if (timestamp != 0) {
+    statement->SetDouble(objectNames.size(), toUnixTime(timestamp));
+    statement->SetDouble(objectNames.size() + 1, toUnixTime(timestamp));
+  }
+  processStatement(statement);
+
+  std::set<std::string> remaining(objectNames.begin(), objectNames.end());
+  try {
+    while (statement->NextResultRow()) {
+      string name = statement->GetString(0);
+      if (remaining.erase(name) == 0) {
+        continue; // as in retrieve(), only the first row of an object in the order of the query is considered
+      }
+      callback(name, std::unique_ptr<MonitorObject>(readObject(statement, 1)));
+    }
+  } catch (...) {
+    delete statement;
+    throw;
+  }
+  delete statement;
+
+  for (const auto& name : remaining) {
+    callback(name, nullptr);
+  }
+}
+
+namespace
+{
+/// \brief Iterates over the rows of the versions of an object, reading each object only when asked for.
+class MySqlVersionIterator : public VersionIterator
+{
+ public:
+  using ObjectReader = std::function<MonitorObject*(int run)>;
+
+  /// \param statement - the processed statement, with the columns time (s), run and fill, the iterator owns it
+  /// \param readObject - reads the object of a run, a version is identified by its run
+  MySqlVersionIterator(TMySQLStatement* statement, ObjectReader readObject)
+    : mStatement(statement), mReadObject(std::move(readObject))
+  {
+  }
+
+  bool next() override
+  {
+    if (!mStatement->NextResultRow()) {
+      return false; // the last version stays the current one
+    }
+    mRun = mStatement->GetInt(1);
+    mVersion.validFrom = static_cast<long>(mStatement->GetDouble(0) * 1000);
+    mVersion.validUntil = LONG_MAX; // not stored, a version is valid until the next one
+    mVersion.metadata = { { runMetadataKey, std::to_string(mRun) },
+                          { "fill", std::to_string(mStatement->IsNull(2) ? -1 : mStatement->GetInt(2)) } };
+    return true;
+  }
+
+  const ObjectVersion& version() const override { return mVersion; }
+
+  std::unique_ptr<MonitorObject> object() override { return std::unique_ptr<MonitorObject>(mReadObject(mRun)); }
+
+ private:
+  std::unique_ptr<TMySQLStatement> mStatement;
+  ObjectReader mReadObject;
+  ObjectVersion mVersion;
+  int mRun = 0;
+};
+} // namespace
+
+std::unique_ptr<VersionIterator> MySqlDatabase::retrieveVersions(std::string taskName, std::string objectName,
+                                                                 long from, long to,
+                                                                 const std::map<std::string, std::string>& metadataFilter)
+{
+  // the versions only have the run and the fill, the columns filtered by the query
+  std::vector<int> columnValues;
+  string query = "SELECT UNIX_TIMESTAMP(updatetime), run, fill FROM data_" + taskName +
+                 " WHERE object_name = ? AND updatetime BETWEEN FROM_UNIXTIME(?) AND FROM_UNIXTIME(?)";
+  for (const auto& [key, value] : metadataFilter) {
+    const char* column = key == runMetadataKey ? "run" : key == "fill" ? "fill" : nullptr;
+    if (column == nullptr) {
+      BOOST_THROW_EXCEPTION(DatabaseException() << errinfo_details("The versions of MySQL cannot be filtered by " + key +
+                                                                   ", only by " + runMetadataKey + " and fill"));
+    }
+    query += string(" AND ") + column + " = ?";
+    try {
+      columnValues.push_back(std::stoi(value));
+    } catch (std::exception&) {
+      BOOST_THROW_EXCEPTION(DatabaseException() << errinfo_details("Invalid " + key + " in the filter: " + value));
+    }
+  }
+  query += " ORDER BY updatetime";
+
+  TMySQLStatement* statement = prepareStatement(query);
+  statement->NextIteration();
+  statement->SetString(0, objectName.c_str());
+  statement->SetDouble(1, toUnixTime(from));
+  statement->SetDouble(2, toUnixTime(to));
+  for (size_t i = 0; i < columnValues.size(); i++) {
+    statement->SetInt(3 + i, columnValues[i]);
+  }
+  processStatement(statement);
+  return std::make_unique<MySqlVersionIterator>(
+    statement, [this, taskName, objectName](int run) { return retrieveRun(taskName, objectName, run); });
+}
+
+o2::quality_control::core::MonitorObject* MySqlDatabase::retrieveRun(const std::string& taskName,
+                                                                     const std::string& objectName, int run)
+{
+  // (object_name, run) is the primary key, there is one version per run
+  TMySQLStatement* statement =
+    prepareStatement("SELECT data FROM data_" + taskName + " WHERE object_name = ? AND run = ?");
+  statement->NextIteration();
+  statement->SetString(0, objectName.c_str());
+  statement->SetInt(1, run);
+  processStatement(statement);
+
+  o2::quality_control::core::MonitorObject* mo = nullptr;
+  try {
+    if (statement->NextResultRow()) {
+      mo = readObject(statement, 0);
+    }
+  } catch (...) {
+    delete statement;
+    throw;
+  }
+  delete statement;
+  return mo;
+}
+
+TMySQLStatement* MySqlDatabase::prepareStatement(const std::string& query)
+{
+  auto* statement = (TMySQLStatement*)mServer->Statement(query.c_str());
   if (mServer->IsError()) {
     if (statement) {
       delete statement;
@@ -179,9 +383,11 @@ o2::quality_control::core::MonitorObject* MySqlDatabase::retrieve(std::string ta
                           << errinfo_details("Encountered an error when creating statement in MySqlDatabase")
                           << errinfo_db_message(mServer->GetErrorMsg()) << errinfo_db_errno(mServer->GetErrorCode()));
   }
-  statement->NextIteration();
-  statement->SetString(0, objectName.c_str());
+  return statement;
+}
 
+void MySqlDatabase::processStatement(TMySQLStatement* statement)
+{
   if (!(statement->Process() && statement->StoreResult())) {
     delete statement;
     BOOST_THROW_EXCEPTION(DatabaseException()
@@ -189,32 +395,24 @@ o2::quality_control::core::MonitorObject* MySqlDatabase::retrieve(std::string ta
                                "Encountered an error when processing and storing results in MySqlDatabase")
                           << errinfo_db_message(mServer->GetErrorMsg()) << errinfo_db_errno(mServer->GetErrorCode()));
   }
+}
 
-  o2::quality_control::core::MonitorObject* mo = nullptr;
-  if (statement->NextResultRow()) { // Consider only the first result
-    string name = statement->GetString(0);
-    void* blob = nullptr;
-    Long_t blobSize = 0;
-    statement->GetBinary(1, blob, blobSize); // retrieve the data
-                                             //    TDatime updatetime(statement->GetYear(2), statement->GetMonth(2), statement->GetDay(2), statement->GetHour(2),
-                                             //                       statement->GetMinute(2), statement->GetSecond(2));
-                                             //    int run = statement->IsNull(3) ? -1 : statement->GetInt(3);
-                                             //    int fill = statement->IsNull(4) ? -1 : statement->GetInt(4);
-
-    TMessage mess(kMESS_OBJECT);
-    mess.SetBuffer(blob, blobSize, kFALSE);
-    mess.SetReadMode();
-    mess.Reset();
-    try {
-      mo = (o2::quality_control::core::MonitorObject*)(mess.ReadObjectAny(mess.GetClass()));
-    } catch (...) {
-      QcInfoLogger::GetInstance() << "Node: unable to parse TObject from MySQL" << infologger::endm;
-      throw;
-    }
+o2::quality_control::core::MonitorObject* MySqlDatabase::readObject(TMySQLStatement* statement, int column)
+{
+  void* blob = nullptr;
+  Long_t blobSize = 0;
+  statement->GetBinary(column, blob, blobSize); // retrieve the data
+
+  TMessage mess(kMESS_OBJECT);
+  mess.SetBuffer(blob, blobSize, kFALSE);
+  mess.SetReadMode();
+  mess.Reset();
+  try {
+    return (o2::quality_control::core::MonitorObject*)(mess.ReadObjectAny(mess.GetClass()));
+  } catch (...) {
+    QcInfoLogger::GetInstance() << "Node: unable to parse TObject from MySQL" << infologger::endm;
+    throw;
   }
-  delete statement;
-
-  return mo;
 }
 
 std::string MySqlDatabase::retrieveJson(std::string taskName, std::string objectName)
@@ -223,6 +421,8 @@ std::string MySqlDatabase::retrieveJson(std::string taskName, std::string object
   if (monitor == nullptr) {
     return std::string();
   }
+  // the JSON consumers expect the dense histograms
+  SparseHistogram::densify(*monitor);
   std::unique_ptr<TObject> obj(monitor->getObject());
   monitor->setIsOwner(false);
   TString json = TBufferJSON::ConvertToJSON(obj.get());
@@ -15,9 +15,12 @@
 
 #include "QualityControl/ObjectsManager.h"
 
+#include "QualityControl/HistogramAdd.h"
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/ServiceDiscovery.h"
+#include "QualityControl/SparseHistogram.h"
 #include <Common/Exceptions.h>
+#include <TH1.h>
 #include <TObjArray.h>
 
 using namespace o2::quality_control::core;
@@ -78,6 +81,7 @@ void ObjectsManager::stopPublishing(const string& name)
     BOOST_THROW_EXCEPTION(ObjectNotFoundError() << errinfo_object_name(name));
   }
   mMonitorObjects->Remove(mo);
+  mSparseObjects.erase(name);
 }
 
 Quality ObjectsManager::getQuality(std::string objectName)
@@ -113,9 +117,49 @@ TObject* ObjectsManager::getObject(std::string objectName)
   return mo->getObject();
 }
 
-TObjArray* ObjectsManager::getNonOwningArray() const
+TObjArray* ObjectsManager::getNonOwningArray()
 {
-  return new TObjArray(*mMonitorObjects);
+  mSparseMonitorObjects.clear();
+  if (mSparseObjects.empty()) {
+    return new TObjArray(*mMonitorObjects);
+  }
+
+  auto* array = new TObjArray(mMonitorObjects->GetEntriesFast());
+  for (auto* object : *mMonitorObjects) {
+    auto* mo = static_cast<MonitorObject*>(object);
+    auto* histogram = dynamic_cast<TH1*>(mo->getObject());
+    std::unique_ptr<SparseHistogram> sparse;
+    if (histogram != nullptr && mSparseObjects.count(mo->getName()) > 0) {
+      sparse = SparseHistogram::fromHistogram(*histogram);
+    }
+    if (sparse == nullptr) {
+      array->Add(mo);
+      continue;
+    }
+    // a copy of the MonitorObject carries the sparse histogram, the task keeps filling the dense one
+    auto sparseMo = std::make_unique<MonitorObject>(*mo);
+    sparseMo->setObject(sparse.release());
+    sparseMo->setIsOwner(true);
+    array->Add(sparseMo.get());
+    mSparseMonitorObjects.push_back(std::move(sparseMo));
+  }
+  return array;
+}
+
+void ObjectsManager::setSparse(const std::string& objectName, bool sparse)
+{
+  MonitorObject* mo = getMonitorObject(objectName);
+  auto* histogram = dynamic_cast<TH1*>(mo->getObject());
+  if (sparse && (histogram == nullptr || !histograms::isPlainHistogram(histogram->IsA()))) {
+    QcInfoLogger::GetInstance() << "Object " << objectName << " cannot be published as a sparse histogram"
+                                << infologger::endm;
+    return;
+  }
+  if (sparse) {
+    mSparseObjects.insert(objectName);
+  } else {
+    mSparseObjects.erase(objectName);
+  }
 }
 
 void ObjectsManager::addCheck(const TObject* object, const std::string& checkName, const std::string& checkClassName,
@@ -0,0 +1,164 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   QualityAggregator.cxx
+///
+
+#include "QualityControl/QualityAggregator.h"
+
+#include <algorithm>
+#include <set>
+// ROOT
+#include <TNamed.h>
+#include <TObjArray.h>
+// O2
+#include <Configuration/ConfigurationFactory.h>
+#include <Framework/DataRefUtils.h>
+#include <Framework/DataSpecUtils.h>
+// QC
+#include "QualityControl/Checker.h"
+#include "QualityControl/DatabaseFactory.h"
+
+using namespace o2::configuration;
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository;
+
+namespace o2::quality_control::checker
+{
+
+constexpr char QualityAggregator::TaskName[];
+
+QualityAggregator::QualityAggregator(std::string aggregatorName, std::vector<std::string> taskNames, std::string configurationSource)
+  : mAggregatorName(aggregatorName),
+    mConfigurationSource(configurationSource),
+    mOutputSpec{ "QC", "QUALITY-AGG", 0 }
+{
+  for (const auto& taskName : taskNames) {
+    mInputSpecs.push_back({ "checked-mo", "QC", Checker::createCheckerDataDescription(taskName), 0 });
+  }
+}
+
+void QualityAggregator::init(framework::InitContext&)
+{
+  try {
+    std::unique_ptr<ConfigurationInterface> config = ConfigurationFactory::getConfiguration(mConfigurationSource);
+    mDatabase = DatabaseFactory::create(config->get<std::string>("qc.config.database.implementation"));
+    mDatabase->connect(config->getRecursiveMap("qc.config.database"));
+
+    // the hierarchy can be reduced, e.g. "task" to aggregate objects into tasks and tasks directly into global
+    auto hierarchy = config->get<std::string>("qc.config.aggregator.hierarchy", "detector,task");
+    mUseDetectorLevel = hierarchy.find("detector") != std::string::npos;
+    mUseTaskLevel = hierarchy.find("task") != std::string::npos;
+  } catch (...) {
+    std::string diagnostic = boost::current_exception_diagnostic_information();
+    LOG(ERROR) << "Unexpected exception, diagnostic information follows:\n"
+               << diagnostic;
+    throw;
+  }
+}
+
+void QualityAggregator::run(framework::ProcessingContext& ctx)
+{
+  std::set<std::string> changedNodes;
+
+  for (const auto& input : ctx.inputs()) {
+    if (input.header == nullptr || input.payload == nullptr) {
+      continue;
+    }
+    std::unique_ptr<TObjArray> moArray = framework::DataRefUtils::as<TObjArray>(input);
+    moArray->SetOwner(true);
+    auto changed = aggregate(*moArray);
+    changedNodes.insert(changed.begin(), changed.end());
+  }
+
+  if (changedNodes.empty()) {
+    return;
+  }
+
+  auto aggregatedArray = std::make_unique<TObjArray>();
+  aggregatedArray->SetOwner(true);
+  for (const auto& nodePath : changedNodes) {
+    try {
+      mDatabase->store(std::shared_ptr<MonitorObject>(createAggregatedObject(nodePath)));
+    } catch (boost::exception& e) {
+      LOG(ERROR) << "Unable to store " << nodePath << " : " << diagnostic_information(e);
+    }
+    // some databases keep the stored objects for a while, so we publish a separate instance
+    aggregatedArray->Add(createAggregatedObject(nodePath));
+  }
+
+  auto concreteOutput = framework::DataSpecUtils::asConcreteDataMatcher(mOutputSpec);
+  ctx.outputs().adopt(
+    framework::Output{ concreteOutput.origin, concreteOutput.description, concreteOutput.subSpec, mOutputSpec.lifetime }, aggregatedArray.release());
+}
+
+std::set<std::string> QualityAggregator::aggregate(const TObjArray& checkedObjects)
+{
+  std::set<std::string> changedNodes;
+  for (const auto& to : checkedObjects) {
+    auto* mo = dynamic_cast<MonitorObject*>(to);
+    if (mo == nullptr) {
+      continue;
+    }
+    auto changed = mTree.update(createPath(*mo), mo->getQuality());
+    changedNodes.insert(changed.begin(), changed.end());
+  }
+  return changedNodes;
+}
+
+std::vector<std::string> QualityAggregator::createPath(const MonitorObject& mo) const
+{
+  std::vector<std::string> path;
+  if (mUseDetectorLevel) {
+    path.push_back(mo.getDetectorName());
+  }
+  if (mUseTaskLevel) {
+    path.push_back(mo.getTaskName());
+  }
+  path.push_back(mo.getName());
+  return path;
+}
+
+MonitorObject* QualityAggregator::createAggregatedObject(const std::string& nodePath)
+{
+  Quality quality = mTree.getQuality(nodePath);
+
+  // "global/TPC/clusters" is stored as "TPC_clusters" of detector "TPC", "global" as "global" of detector "GLO"
+  std::string relativePath = nodePath == mTree.getRootName() ? nodePath : nodePath.substr(mTree.getRootName().size() + 1);
+  std::string detector = mUseDetectorLevel && relativePath != nodePath ? relativePath.substr(0, relativePath.find('/')) : "GLO";
+  std::string name = relativePath;
+  std::replace(name.begin(), name.end(), '/', '_');
+
+  auto* named = new TNamed(name.c_str(), quality.getName().c_str());
+  auto* mo = new MonitorObject(named, TaskName, detector);
+  mo->setIsOwner(true);
+  mo->addCheck("aggregation", "QualityAggregator");
+  mo->setQualityForCheck("aggregation", quality);
+  mo->addMetadata("node", nodePath);
+  return mo;
+}
+
+std::string QualityAggregator::createAggregatorIdString()
+{
+  return std::string("QC-AGGREGATOR");
+}
+
+framework::CompletionPolicy::CompletionOp QualityAggregator::completionPolicyCallback(gsl::span<framework::PartRef const> const& inputs)
+{
+  for (auto& input : inputs) {
+    if (input.header != nullptr && input.payload != nullptr) {
+      return framework::CompletionPolicy::CompletionOp::Consume;
+    }
+  }
+  return framework::CompletionPolicy::CompletionOp::Wait;
+}
+
+} // namespace o2::quality_control::checker
@@ -0,0 +1,112 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   QualityTree.cxx
+///
+
+#include "QualityControl/QualityTree.h"
+
+#include <Common/Exceptions.h>
+
+namespace o2::quality_control::core
+{
+
+QualityTree::QualityTree(std::string rootName) : mRoot(std::make_unique<Node>())
+{
+  mRoot->path = rootName;
+  mIndex[rootName] = mRoot.get();
+}
+
+std::vector<std::string> QualityTree::update(const std::vector<std::string>& path, const Quality& quality)
+{
+  Node* node = mRoot.get();
+  for (const auto& name : path) {
+    node = getOrCreateChild(node, name);
+  }
+
+  std::vector<std::string> changed;
+  if (node == mRoot.get() || node->quality == quality) {
+    return changed;
+  }
+
+  Quality previous = node->quality;
+  node->quality = quality;
+  Quality current = quality;
+
+  // propagate the change upwards as long as it affects the ancestors
+  for (Node* parent = node->parent; parent != nullptr; parent = parent->parent) {
+    parent->removeChildQuality(previous);
+    parent->addChildQuality(current);
+    Quality aggregated = parent->aggregate();
+    if (aggregated == parent->quality) {
+      break;
+    }
+    previous = parent->quality;
+    parent->quality = aggregated;
+    current = aggregated;
+    changed.push_back(parent->path);
+  }
+  return changed;
+}
+
+Quality QualityTree::getQuality(const std::string& nodePath) const
+{
+  auto node = mIndex.find(nodePath);
+  if (node == mIndex.end()) {
+    throw AliceO2::Common::ObjectNotFoundError();
+  }
+  return node->second->quality;
+}
+
+QualityTree::Node* QualityTree::getOrCreateChild(Node* node, const std::string& name)
+{
+  auto child = node->children.find(name);
+  if (child != node->children.end()) {
+    return child->second.get();
+  }
+
+  auto newChild = std::make_unique<Node>();
+  newChild->path = node->path + "/" + name;
+  newChild->parent = node;
+  // a new node is Null and its parent has to know about it, but it does not change the parent's quality unless
+  // the parent had no children at all, which means it was Null already.
+  node->addChildQuality(newChild->quality);
+  mIndex[newChild->path] = newChild.get();
+  return node->children.emplace(name, std::move(newChild)).first->second.get();
+}
+
+void QualityTree::Node::addChildQuality(const Quality& q)
+{
+  auto& level = childrenLevels[q.getLevel()];
+  level.first++;
+  level.second = q;
+}
+
+void QualityTree::Node::removeChildQuality(const Quality& q)
+{
+  auto level = childrenLevels.find(q.getLevel());
+  if (level != childrenLevels.end() && --level->second.first == 0) {
+    childrenLevels.erase(level);
+  }
+}
+
+Quality QualityTree::Node::aggregate() const
+{
+  // the worst quality has the highest level, but Null is considered only if there is nothing else
+  for (auto level = childrenLevels.rbegin(); level != childrenLevels.rend(); ++level) {
+    if (level->first != Quality::NullLevel) {
+      return level->second.second;
+    }
+  }
+  return Quality::Null;
+}
+
+} // namespace o2::quality_control::core
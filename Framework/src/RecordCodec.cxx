@@ -0,0 +1,128 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   RecordCodec.cxx
+///
+
+#include "QualityControl/RecordCodec.h"
+
+#include <cstring>
+
+#include <unistd.h>
+
+#include <boost/crc.hpp>
+
+namespace o2::quality_control::repository::records
+{
+
+namespace
+{
+// reads the body, each get fails once the end of the body is reached
+class BodyReader
+{
+ public:
+  BodyReader(const char* body, size_t size) : mBody(body), mSize(size) {}
+
+  template <typename T>
+  bool get(T& value)
+  {
+    if (mSize - mPosition < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, mBody + mPosition, sizeof(T));
+    mPosition += sizeof(T);
+    return true;
+  }
+
+  template <typename Size, typename Container>
+  bool getBytes(Container& container)
+  {
+    Size size = 0;
+    if (!get(size) || mSize - mPosition < size) {
+      return false;
+    }
+    container.assign(mBody + mPosition, mBody + mPosition + size);
+    mPosition += size;
+    return true;
+  }
+
+ private:
+  const char* mBody;
+  size_t mSize;
+  size_t mPosition = 0;
+};
+} // namespace
+
+void putString(std::vector<char>& buffer, const std::string& string)
+{
+  put<uint32_t>(buffer, string.size());
+  buffer.insert(buffer.end(), string.begin(), string.end());
+}
+
+uint32_t putBody(std::vector<char>& buffer, const SerializedObject& object)
+{
+  size_t start = buffer.size();
+  buffer.reserve(start + 64 + object.path.size() + object.fileName.size() + object.content.size());
+  put<int64_t>(buffer, object.validFrom);
+  put<int64_t>(buffer, object.validTo);
+  putString(buffer, object.path);
+  putString(buffer, object.fileName);
+  put<uint32_t>(buffer, object.metadata.size());
+  for (const auto& [key, value] : object.metadata) {
+    putString(buffer, key);
+    putString(buffer, value);
+  }
+  uint32_t metadataSize = buffer.size() - start;
+  put<uint64_t>(buffer, object.content.size());
+  buffer.insert(buffer.end(), object.content.begin(), object.content.end());
+  return metadataSize;
+}
+
+bool getBody(const char* body, size_t size, bool withContent, SerializedObject& object)
+{
+  BodyReader reader(body, size);
+  uint32_t numberOfMetadata = 0;
+  if (!reader.get(object.validFrom) || !reader.get(object.validTo) || !reader.getBytes<uint32_t>(object.path) ||
+      !reader.getBytes<uint32_t>(object.fileName) || !reader.get(numberOfMetadata)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < numberOfMetadata; i++) {
+    std::string key, value;
+    if (!reader.getBytes<uint32_t>(key) || !reader.getBytes<uint32_t>(value)) {
+      return false;
+    }
+    object.metadata[key] = value;
+  }
+  return !withContent || reader.getBytes<uint64_t>(object.content);
+}
+
+uint32_t checksum(const char* data, size_t size)
+{
+  boost::crc_32_type crc;
+  crc.process_bytes(data, size);
+  return crc.checksum();
+}
+
+bool readAt(int fd, uint64_t offset, char* buffer, size_t size)
+{
+  while (size > 0) {
+    ssize_t read = pread(fd, buffer, size, offset);
+    if (read <= 0) {
+      return false;
+    }
+    buffer += read;
+    offset += read;
+    size -= read;
+  }
+  return true;
+}
+
+} // namespace o2::quality_control::repository::records
@@ -25,7 +25,9 @@
 
 #include <Common/Exceptions.h>
 
+#include "QualityControl/CcdbDatabase.h"
 #include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/FileDatabase.h"
 #include "QualityControl/QcInfoLogger.h"
 
 using namespace std;
@@ -78,11 +80,15 @@ void RepositoryBenchmark::InitTask()
   string dbUrl = fConfig->GetValue<string>("database-url");
   string dbBackend = fConfig->GetValue<string>("database-backend");
   mTaskName = fConfig->GetValue<string>("task-name");
+  uint64_t startupDuration = 0;
   try {
+    auto startupStart = steady_clock::now();
     mDatabase = o2::quality_control::repository::DatabaseFactory::create(dbBackend);
     mDatabase->connect(fConfig->GetValue<string>("database-url"), fConfig->GetValue<string>("database-name"),
                        fConfig->GetValue<string>("database-username"), fConfig->GetValue<string>("database-password"));
     mDatabase->prepareTaskDataContainer(mTaskName);
+    startupDuration = duration_cast<milliseconds>(steady_clock::now() - startupStart).count();
+    QcInfoLogger::GetInstance() << "Database client ready in " << startupDuration << " ms" << infologger::endm;
   } catch (boost::exception& exc) {
     string diagnostic = boost::current_exception_diagnostic_information();
     std::cerr << "Unexpected exception, diagnostic information follows:\n"
@@ -99,6 +105,15 @@ void RepositoryBenchmark::InitTask()
   mDeletionMode = static_cast<bool>(fConfig->GetValue<int>("delete"));
   mObjectName = fConfig->GetValue<string>("object-name");
   auto numberTasks = fConfig->GetValue<uint64_t>("number-tasks");
+  mUploadThreads = fConfig->GetValue<uint64_t>("upload-threads");
+  mReadMode = fConfig->GetValue<int>("read");
+  if (auto* ccdb = dynamic_cast<CcdbDatabase*>(mDatabase.get()); ccdb != nullptr) {
+    // the same objects are stored at each iteration, they must all be uploaded
+    ccdb->setDeduplicationPeriod(0);
+    if (mUploadThreads > 0) {
+      ccdb->setMaxConcurrentUploads(mUploadThreads);
+    }
+  }
 
   // monitoring
   mMonitoring = MonitoringFactory::Get(fConfig->GetValue<string>("monitoring-url"));
@@ -108,6 +123,7 @@ void RepositoryBenchmark::InitTask()
   mMonitoring->addGlobalTag("taskName", mTaskName);
   mMonitoring->addGlobalTag("numberObject", to_string(mNumberObjects));
   mMonitoring->addGlobalTag("sizeObject", to_string(mSizeObjects));
+  mMonitoring->send({ startupDuration, "databaseStartupDuration_ms" }, DerivedMetricMode::NONE);
   if (mTaskName == "benchmarkTask_0") { // send these parameters to monitoring only once per benchmark run
     mMonitoring->sendGrouped("ccdb-benchmark-parameters", { { mNumberObjects, "number-objects" },
                                                             { mSizeObjects * 1000, "size-objects" },
@@ -152,10 +168,19 @@ bool RepositoryBenchmark::ConditionalRun()
 
   high_resolution_clock::time_point t1 = high_resolution_clock::now();
 
-  // Store the object
-  for (unsigned int i = 0; i < mNumberObjects; i++) {
-    mDatabase->store(mMyObjects[i]);
-    mTotalNumberObjects++;
+  if (mReadMode > 0) {
+    retrieveObjects();
+  } else {
+    // Store the object
+    for (unsigned int i = 0; i < mNumberObjects; i++) {
+      if (mUploadThreads > 0) {
+        mDatabase->storeAsync(mMyObjects[i]);
+      } else {
+        mDatabase->store(mMyObjects[i]);
+      }
+      mTotalNumberObjects++;
+    }
+    mDatabase->flush();
   }
   if (!mThreadedMonitoring) {
     mMonitoring->send({ mTotalNumberObjects, "objectsSent" }, DerivedMetricMode::RATE);
@@ -163,7 +188,8 @@ bool RepositoryBenchmark::ConditionalRun()
 
   high_resolution_clock::time_point t2 = high_resolution_clock::now();
   long duration = duration_cast<milliseconds>(t2 - t1).count();
-  mMonitoring->send({ duration / mNumberObjects, "storeDurationForOneObject_ms" }, DerivedMetricMode::NONE);
+  string durationMetric = mReadMode > 0 ? "retrieveDurationForOneObject_ms" : "storeDurationForOneObject_ms";
+  mMonitoring->send({ duration / mNumberObjects, durationMetric }, DerivedMetricMode::NONE);
 
   // determine how long we should wait till next iteration in order to have 1 sec between storage
   auto duration2 = duration_cast<microseconds>(t2 - t1);
@@ -184,11 +210,46 @@ bool RepositoryBenchmark::ConditionalRun()
   return true;
 }
 
+std::string RepositoryBenchmark::getTaskPath() const
+{
+  // the objects are stored in "qc/<detector>/<task>" by the CCDB and File backends
+  bool detectorPath = dynamic_cast<CcdbDatabase*>(mDatabase.get()) != nullptr ||
+                      dynamic_cast<FileDatabase*>(mDatabase.get()) != nullptr;
+  return (detectorPath ? "qc/BMK/" : "") + mTaskName;
+}
+
+void RepositoryBenchmark::retrieveObjects()
+{
+  string path = getTaskPath();
+  uint64_t missing = 0;
+  if (mReadMode == 2) {
+    vector<string> names;
+    for (const auto& mo : mMyObjects) {
+      names.push_back(mo->getName());
+    }
+    mDatabase->retrieveMany(path, names, 0, [&](const string&, unique_ptr<MonitorObject> mo) {
+      missing += mo == nullptr ? 1 : 0;
+      mTotalNumberObjects++;
+    });
+  } else {
+    for (const auto& mo : mMyObjects) {
+      unique_ptr<MonitorObject> retrieved(mDatabase->retrieve(path, mo->getName()));
+      missing += retrieved == nullptr ? 1 : 0;
+      mTotalNumberObjects++;
+    }
+  }
+  if (missing > 0) {
+    QcInfoLogger::GetInstance() << missing << " objects could not be retrieved, were they stored before?"
+                                << infologger::endm;
+  }
+}
+
 void RepositoryBenchmark::emptyDatabase()
 {
-  mDatabase->truncate(mTaskName, mObjectName);
+  string path = getTaskPath();
+  mDatabase->truncate(path, mObjectName);
   for (uint64_t i = 0; i < mNumberObjects; i++) {
-    mDatabase->truncate(mTaskName, mObjectName + to_string(i));
+    mDatabase->truncate(path, mObjectName + to_string(i));
   }
 }
 
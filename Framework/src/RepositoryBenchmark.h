@@ -37,6 +37,9 @@ class RepositoryBenchmark : public FairMQDevice
   virtual void InitTask();
   virtual bool ConditionalRun();
   void emptyDatabase();
+  void retrieveObjects();
+  /// \brief Returns the path of the objects of the task in the database.
+  std::string getTaskPath() const;
   void checkTimedOut();
   TH1* createHisto(uint64_t sizeObjects, std::string name);
 
@@ -49,6 +52,8 @@ class RepositoryBenchmark : public FairMQDevice
   std::string mTaskName;
   std::string mObjectName;
   bool mDeletionMode = false; // todo: is false ok as default?
+  uint64_t mUploadThreads = 0;
+  int mReadMode = 0; // 0: store, 1: retrieve, 2: retrieveMany
 
   // monitoring
   std::unique_ptr<o2::monitoring::Monitoring> mMonitoring;
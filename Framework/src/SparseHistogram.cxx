@@ -0,0 +1,274 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   SparseHistogram.cxx
+///
+
+#include "QualityControl/SparseHistogram.h"
+#include "QualityControl/HistogramAdd.h"
+#include "QualityControl/MonitorObject.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <type_traits>
+
+#include <TClass.h>
+#include <TH1.h>
+
+#include <fairlogger/Logger.h>
+
+ClassImp(o2::quality_control::core::SparseHistogram)
+
+namespace o2::quality_control::core
+{
+
+namespace
+{
+
+template <typename Array>
+bool collectBins(const TH1& histogram, std::vector<Int_t>& bins, std::vector<Double_t>& contents,
+                 std::vector<Double_t>& sumw2)
+{
+  auto* array = dynamic_cast<const Array*>(&histogram);
+  if (array == nullptr) {
+    return false;
+  }
+  const Double_t* errors = histogram.GetSumw2N() > 0 ? histogram.GetSumw2()->GetArray() : nullptr;
+  for (Int_t bin = 0; bin < array->fN; bin++) {
+    if (array->fArray[bin] != 0 || (errors != nullptr && errors[bin] != 0)) {
+      bins.push_back(bin);
+      contents.push_back(array->fArray[bin]);
+      if (errors != nullptr) {
+        sumw2.push_back(errors[bin]);
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+T toBinContent(Double_t content)
+{
+  return static_cast<T>(content);
+}
+
+// integer bins saturate instead of overflowing, as in TH1I::AddBinContent
+template <>
+Int_t toBinContent<Int_t>(Double_t content)
+{
+  return static_cast<Int_t>(std::clamp<Double_t>(content, -INT_MAX, INT_MAX));
+}
+
+template <typename Array>
+bool fillBins(TH1& histogram, const std::vector<Int_t>& bins, const std::vector<Double_t>& contents)
+{
+  auto* array = dynamic_cast<Array*>(&histogram);
+  if (array == nullptr) {
+    return false;
+  }
+  using Content = std::remove_reference_t<decltype(*array->fArray)>;
+  for (size_t i = 0; i < bins.size(); i++) {
+    array->fArray[bins[i]] = toBinContent<Content>(contents[i]);
+  }
+  return true;
+}
+
+bool sameBinning(const TAxis& a, const TAxis& b)
+{
+  if (a.GetNbins() != b.GetNbins() || a.GetXmin() != b.GetXmin() || a.GetXmax() != b.GetXmax()) {
+    return false;
+  }
+  // alphanumeric bins are matched by label by TH1::Merge, not by index
+  if (a.GetLabels() != nullptr || b.GetLabels() != nullptr) {
+    return false;
+  }
+  const TArrayD* edgesA = a.GetXbins();
+  const TArrayD* edgesB = b.GetXbins();
+  return edgesA->fN == edgesB->fN && std::equal(edgesA->fArray, edgesA->fArray + edgesA->fN, edgesB->fArray);
+}
+
+} // namespace
+
+std::unique_ptr<SparseHistogram> SparseHistogram::fromHistogram(const TH1& histogram)
+{
+  if (!histograms::isPlainHistogram(histogram.IsA()) || histogram.GetBuffer() != nullptr ||
+      histogram.TestBit(TH1::kIsAverage)) {
+    return nullptr;
+  }
+  // the histograms with alphanumeric bins could not be merged, they stay dense
+  for (const TAxis* axis : { histogram.GetXaxis(), histogram.GetYaxis(), histogram.GetZaxis() }) {
+    if (axis->GetLabels() != nullptr) {
+      return nullptr;
+    }
+  }
+
+  auto sparse = std::make_unique<SparseHistogram>();
+  sparse->SetNameTitle(histogram.GetName(), histogram.GetTitle());
+  sparse->mHistogramClass = histogram.IsA()->GetName();
+  histogram.GetXaxis()->Copy(sparse->mXaxis);
+  histogram.GetYaxis()->Copy(sparse->mYaxis);
+  histogram.GetZaxis()->Copy(sparse->mZaxis);
+  for (TAxis* axis : { &sparse->mXaxis, &sparse->mYaxis, &sparse->mZaxis }) {
+    axis->SetParent(nullptr); // the axes do not belong to the histogram anymore
+  }
+
+  sparse->mHasSumw2 = histogram.GetSumw2N() > 0;
+  bool collected = collectBins<TArrayF>(histogram, sparse->mBins, sparse->mContents, sparse->mSumw2) ||
+                   collectBins<TArrayD>(histogram, sparse->mBins, sparse->mContents, sparse->mSumw2) ||
+                   collectBins<TArrayI>(histogram, sparse->mBins, sparse->mContents, sparse->mSumw2);
+  if (!collected) {
+    return nullptr;
+  }
+
+  sparse->mStats.resize(TH1::kNstat, 0);
+  histogram.GetStats(sparse->mStats.data());
+  sparse->mEntries = histogram.GetEntries();
+  sparse->mMinimum = histogram.GetMinimumStored();
+  sparse->mMaximum = histogram.GetMaximumStored();
+  return sparse;
+}
+
+TH1* SparseHistogram::densify() const
+{
+  TClass* histogramClass = TClass::GetClass(mHistogramClass.c_str());
+  if (histogramClass == nullptr || !histograms::isPlainHistogram(histogramClass)) {
+    LOG(ERROR) << "Cannot create the histogram " << GetName() << " of class " << mHistogramClass;
+    return nullptr;
+  }
+  auto* histogram = static_cast<TH1*>(histogramClass->DynamicCast(TH1::Class(), histogramClass->New()));
+  histogram->SetDirectory(nullptr);
+  histogram->SetNameTitle(GetName(), GetTitle());
+  mXaxis.Copy(*histogram->GetXaxis());
+  mYaxis.Copy(*histogram->GetYaxis());
+  mZaxis.Copy(*histogram->GetZaxis());
+  for (TAxis* axis : { histogram->GetXaxis(), histogram->GetYaxis(), histogram->GetZaxis() }) {
+    axis->SetParent(histogram);
+  }
+  // allocates the bins given by the axes
+  histogram->SetBinsLength(-1);
+  if (mHasSumw2) {
+    histogram->Sumw2();
+  }
+
+  if (!mBins.empty() && mBins.back() >= histogram->GetNcells()) {
+    LOG(ERROR) << "The bins of the sparse histogram " << GetName() << " do not match its axes";
+    return histogram;
+  }
+  bool filled = fillBins<TArrayF>(*histogram, mBins, mContents) || fillBins<TArrayD>(*histogram, mBins, mContents) ||
+                fillBins<TArrayI>(*histogram, mBins, mContents);
+  if (!filled) {
+    LOG(ERROR) << "Unexpected bin array in the histogram " << GetName() << " of class " << mHistogramClass;
+  }
+  if (mHasSumw2) {
+    Double_t* sumw2 = histogram->GetSumw2()->GetArray();
+    for (size_t i = 0; i < mBins.size(); i++) {
+      sumw2[mBins[i]] = mSumw2[i];
+    }
+  }
+
+  std::vector<Double_t> stats(mStats);
+  stats.resize(TH1::kNstat, 0);
+  histogram->PutStats(stats.data());
+  histogram->SetEntries(mEntries);
+  histogram->SetMinimum(mMinimum);
+  histogram->SetMaximum(mMaximum);
+  return histogram;
+}
+
+bool SparseHistogram::densify(MonitorObject& mo)
+{
+  auto* sparse = dynamic_cast<SparseHistogram*>(mo.getObject());
+  if (sparse == nullptr) {
+    return false;
+  }
+  TH1* dense = sparse->densify();
+  if (dense == nullptr) {
+    return false;
+  }
+  if (mo.isIsOwner()) {
+    delete sparse;
+  }
+  mo.setObject(dense);
+  mo.setIsOwner(true);
+  return true;
+}
+
+bool SparseHistogram::hasSameLayout(const SparseHistogram& other) const
+{
+  return mHistogramClass == other.mHistogramClass && sameBinning(mXaxis, other.mXaxis) &&
+         sameBinning(mYaxis, other.mYaxis) && sameBinning(mZaxis, other.mZaxis);
+}
+
+bool SparseHistogram::merge(const TObject* other)
+{
+  auto* otherSparse = dynamic_cast<const SparseHistogram*>(other);
+  if (otherSparse == nullptr || !hasSameLayout(*otherSparse)) {
+    return false;
+  }
+  const SparseHistogram& o = *otherSparse;
+
+  // without sumw2, the squared error of a bin is its content
+  bool withSumw2 = mHasSumw2 || o.mHasSumw2;
+  auto sumw2Of = [](const SparseHistogram& histogram, size_t i) {
+    return histogram.mHasSumw2 ? histogram.mSumw2[i] : std::abs(histogram.mContents[i]);
+  };
+
+  // both lists of bins are sorted, they are joined in one pass
+  std::vector<Int_t> bins;
+  std::vector<Double_t> contents;
+  std::vector<Double_t> sumw2;
+  bins.reserve(std::max(mBins.size(), o.mBins.size()));
+  contents.reserve(bins.capacity());
+  if (withSumw2) {
+    sumw2.reserve(bins.capacity());
+  }
+  size_t i = 0;
+  size_t j = 0;
+  while (i < mBins.size() || j < o.mBins.size()) {
+    if (j == o.mBins.size() || (i < mBins.size() && mBins[i] < o.mBins[j])) {
+      bins.push_back(mBins[i]);
+      contents.push_back(mContents[i]);
+      if (withSumw2) {
+        sumw2.push_back(sumw2Of(*this, i));
+      }
+      i++;
+    } else if (i == mBins.size() || o.mBins[j] < mBins[i]) {
+      bins.push_back(o.mBins[j]);
+      contents.push_back(o.mContents[j]);
+      if (withSumw2) {
+        sumw2.push_back(sumw2Of(o, j));
+      }
+      j++;
+    } else {
+      bins.push_back(mBins[i]);
+      contents.push_back(mContents[i] + o.mContents[j]);
+      if (withSumw2) {
+        sumw2.push_back(sumw2Of(*this, i) + sumw2Of(o, j));
+      }
+      i++;
+      j++;
+    }
+  }
+  mBins = std::move(bins);
+  mContents = std::move(contents);
+  mSumw2 = std::move(sumw2);
+  mHasSumw2 = withSumw2;
+
+  mStats.resize(TH1::kNstat, 0);
+  for (size_t s = 0; s < mStats.size() && s < o.mStats.size(); s++) {
+    mStats[s] += o.mStats[s];
+  }
+  mEntries += o.mEntries;
+  return true;
+}
+
+} // namespace o2::quality_control::core
@@ -0,0 +1,428 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   Spool.cxx
+///
+
+#include "QualityControl/Spool.h"
+#include "QualityControl/RecordCodec.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fairlogger/Logger.h>
+
+namespace o2::quality_control::repository
+{
+
+using namespace records;
+
+namespace
+{
+// a record is a header followed by a body, see RecordCodec.h:
+// header: magic (u32), crc32 of the body (u32), size of the body (u64), spool time in ms (i64)
+const uint32_t recordMagic = 0x51435350; // "QCSP"
+const size_t headerSize = 24;
+const char* const segmentSuffix = ".spool";
+// the period over which the rate of the appends is measured
+const auto ingestWindow = std::chrono::minutes(1);
+
+int64_t now()
+{
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+bool writeAll(int fd, const char* buffer, size_t size)
+{
+  while (size > 0) {
+    ssize_t written = write(fd, buffer, size);
+    if (written <= 0) {
+      return false;
+    }
+    buffer += written;
+    size -= written;
+  }
+  return true;
+}
+} // namespace
+
+Spool::Spool(std::string directory, uint64_t maxSize, uint64_t segmentSize)
+  : mDirectory(std::move(directory)), mMaxSize(maxSize), mSegmentSize(segmentSize)
+{
+  recover();
+  openNewSegment();
+  LOG(INFO) << "Spool in " << mDirectory << " opened with " << mPending.size() << " objects to send";
+}
+
+Spool::~Spool()
+{
+  stopReplay();
+  if (mWriteFd >= 0) {
+    fdatasync(mWriteFd);
+    close(mWriteFd);
+  }
+}
+
+std::string Spool::segmentPath(uint64_t segment) const
+{
+  // the names are padded so that their alphabetical order is the order of the segments
+  std::string number = std::to_string(segment);
+  return mDirectory + "/" + std::string(20 - number.size(), '0') + number + segmentSuffix;
+}
+
+void Spool::recover()
+{
+  if (mkdir(mDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+    LOG(ERROR) << "Cannot create the spool directory " << mDirectory << ": " << strerror(errno);
+  }
+
+  std::vector<uint64_t> segments;
+  if (DIR* dir = opendir(mDirectory.c_str())) {
+    while (dirent* entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      size_t suffix = name.find(segmentSuffix);
+      if (suffix != std::string::npos && suffix > 0 && suffix + strlen(segmentSuffix) == name.size() &&
+          std::all_of(name.begin(), name.begin() + suffix, ::isdigit)) {
+        segments.push_back(std::stoull(name.substr(0, suffix)));
+      }
+    }
+    closedir(dir);
+  }
+  std::sort(segments.begin(), segments.end());
+  mWriteSegment = segments.empty() ? 0 : segments.back();
+
+  // the objects before the cursor were sent by a previous process
+  uint64_t cursorSegment = 0;
+  uint64_t cursorOffset = 0;
+  std::ifstream cursor(mDirectory + "/cursor");
+  cursor >> cursorSegment >> cursorOffset;
+
+  for (uint64_t segment : segments) {
+    if (segment < cursorSegment) {
+      continue;
+    }
+    int fd = open(segmentPath(segment).c_str(), O_RDONLY);
+    struct stat status {
+    };
+    if (fd < 0 || fstat(fd, &status) != 0) {
+      LOG(ERROR) << "Cannot read the spool segment " << segmentPath(segment) << ": " << strerror(errno);
+      if (fd >= 0) {
+        close(fd);
+      }
+      continue;
+    }
+    Pending pending{ segment, segment == cursorSegment ? cursorOffset : 0, 0, 0 };
+    while (readHeader(fd, pending.offset, status.st_size, pending)) {
+      mPending.push_back(pending);
+      mPendingSize += pending.size;
+      pending.offset += pending.size;
+    }
+    if (pending.offset < static_cast<uint64_t>(status.st_size)) {
+      // the process stopped while writing the record
+      LOG(WARNING) << "The spool segment " << segmentPath(segment) << " ends with an incomplete record, ignoring it";
+    }
+    close(fd);
+  }
+
+  // the segments without any object to send are not needed anymore
+  uint64_t firstNeeded = mPending.empty() ? UINT64_MAX : mPending.front().segment;
+  for (uint64_t segment : segments) {
+    if (segment < firstNeeded) {
+      unlink(segmentPath(segment).c_str());
+    }
+  }
+}
+
+void Spool::openNewSegment()
+{
+  if (mWriteFd >= 0) {
+    fdatasync(mWriteFd);
+    close(mWriteFd);
+  }
+  mWriteSegment++;
+  mWriteOffset = 0;
+  mWriteFd = open(segmentPath(mWriteSegment).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+  if (mWriteFd < 0) {
+    LOG(ERROR) << "Cannot create the spool segment " << segmentPath(mWriteSegment) << ": " << strerror(errno);
+  }
+}
+
+bool Spool::append(const SerializedObject& object)
+{
+  std::vector<char> record(headerSize);
+  putBody(record, object);
+
+  uint64_t bodySize = record.size() - headerSize;
+  int64_t spoolTime = now();
+  uint32_t header[2] = { recordMagic, checksum(record.data() + headerSize, bodySize) };
+  std::memcpy(record.data(), header, sizeof(header));
+  std::memcpy(record.data() + 8, &bodySize, sizeof(bodySize));
+  std::memcpy(record.data() + 16, &spoolTime, sizeof(spoolTime));
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mPendingSize + record.size() > mMaxSize) {
+      LOG(ERROR) << "The spool is full (" << mPendingSize << " bytes), the object " << object.path << " is dropped";
+      return false;
+    }
+    if (mWriteOffset >= mSegmentSize) {
+      openNewSegment();
+    }
+    if (mWriteFd < 0) {
+      return false;
+    }
+    // one write per record, so that a crash leaves at most one incomplete record at the end of the segment, on the
+    // disk before the object is reported as spooled
+    ssize_t written = write(mWriteFd, record.data(), record.size());
+    if (written != static_cast<ssize_t>(record.size()) || fdatasync(mWriteFd) != 0) {
+      LOG(ERROR) << "Cannot write the object " << object.path << " to the spool: " << strerror(errno);
+      if (ftruncate(mWriteFd, mWriteOffset) != 0) {
+        openNewSegment(); // the partial record is left behind, the recovery ignores it
+      }
+      return false;
+    }
+    mPending.push_back({ mWriteSegment, mWriteOffset, record.size(), spoolTime });
+    mPendingSize += record.size();
+    mWriteOffset += record.size();
+    mNumberOfAppended++;
+  }
+  mReplayCondition.notify_one();
+  return true;
+}
+
+bool Spool::readHeader(int fd, uint64_t offset, uint64_t fileSize, Pending& pending)
+{
+  char header[headerSize];
+  if (offset + headerSize > fileSize || !readAt(fd, offset, header, headerSize)) {
+    return false;
+  }
+  uint32_t magic;
+  uint64_t bodySize;
+  std::memcpy(&magic, header, sizeof(magic));
+  std::memcpy(&bodySize, header + 8, sizeof(bodySize));
+  if (magic != recordMagic || bodySize > fileSize - offset - headerSize) {
+    return false;
+  }
+  pending.size = headerSize + bodySize;
+  std::memcpy(&pending.spoolTime, header + 16, sizeof(pending.spoolTime));
+  return true;
+}
+
+bool Spool::readRecord(int fd, const Pending& pending, SerializedObject& object)
+{
+  std::vector<char> record(pending.size);
+  if (pending.size < headerSize || !readAt(fd, pending.offset, record.data(), record.size())) {
+    return false;
+  }
+  uint32_t header[2];
+  std::memcpy(header, record.data(), sizeof(header));
+  if (header[0] != recordMagic || header[1] != checksum(record.data() + headerSize, record.size() - headerSize)) {
+    return false;
+  }
+  return getBody(record.data() + headerSize, record.size() - headerSize, true, object);
+}
+
+void Spool::saveCursor(uint64_t segment, uint64_t offset)
+{
+  // the new cursor replaces the previous one at once, a crash leaves one or the other
+  std::string path = mDirectory + "/cursor";
+  std::string content = std::to_string(segment) + " " + std::to_string(offset) + "\n";
+  int fd = open((path + ".tmp").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  bool written = fd >= 0 && writeAll(fd, content.data(), content.size()) && fdatasync(fd) == 0;
+  if (fd >= 0) {
+    close(fd);
+  }
+  if (!written || rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+    LOG(ERROR) << "Cannot save the spool cursor: " << strerror(errno);
+  }
+}
+
+void Spool::quarantine(int fd, const Pending& pending)
+{
+  std::string path = mDirectory + "/quarantine";
+  std::vector<char> record(pending.size);
+  int quarantineFd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  bool written = fd >= 0 && readAt(fd, pending.offset, record.data(), record.size()) && quarantineFd >= 0 &&
+                 writeAll(quarantineFd, record.data(), record.size()) && fdatasync(quarantineFd) == 0;
+  if (quarantineFd >= 0) {
+    close(quarantineFd);
+  }
+  if (!written) {
+    LOG(ERROR) << "Cannot write the object at " << pending.offset << " in the spool segment "
+               << segmentPath(pending.segment) << " to " << path << ", it is dropped: " << strerror(errno);
+  }
+}
+
+void Spool::startReplay(std::function<SendResult(const SerializedObject&)> send, double maxRate,
+                        std::chrono::milliseconds retryDelay, size_t maxAttempts)
+{
+  stopReplay();
+  {
+    std::lock_guard<std::mutex> lock(mReplayMutex);
+    mStopReplay = false;
+  }
+  mReplayThread = std::thread(&Spool::replay, this, std::move(send), maxRate, retryDelay, maxAttempts);
+}
+
+void Spool::stopReplay()
+{
+  {
+    std::lock_guard<std::mutex> lock(mReplayMutex);
+    mStopReplay = true;
+  }
+  mReplayCondition.notify_all();
+  if (mReplayThread.joinable()) {
+    mReplayThread.join();
+  }
+}
+
+bool Spool::waitFor(std::chrono::steady_clock::duration duration)
+{
+  std::unique_lock<std::mutex> lock(mReplayMutex);
+  return !mReplayCondition.wait_for(lock, duration, [this] { return mStopReplay; });
+}
+
+void Spool::replay(std::function<SendResult(const SerializedObject&)> send, double maxRate,
+                   std::chrono::milliseconds retryDelay, size_t maxAttempts)
+{
+  auto interval = maxRate > 0 ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                  std::chrono::duration<double>(1 / maxRate))
+                              : std::chrono::steady_clock::duration::zero();
+  auto nextSend = std::chrono::steady_clock::now();
+  auto delay = retryDelay;
+  size_t attempts = 0;
+  auto windowStart = std::chrono::steady_clock::now();
+  uint64_t windowAppended = 0;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    windowAppended = mNumberOfAppended;
+  }
+  int fd = -1;
+  uint64_t fdSegment = 0;
+
+  while (true) {
+    Pending next{};
+    bool available = false;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (!mPending.empty()) {
+        next = mPending.front();
+        available = true;
+      }
+    }
+    if (!available) {
+      std::unique_lock<std::mutex> lock(mReplayMutex);
+      mReplayCondition.wait_for(lock, std::chrono::seconds(1), [this] { return mStopReplay; });
+      if (mStopReplay) {
+        break;
+      }
+      continue;
+    }
+
+    if (fd < 0 || fdSegment != next.segment) {
+      if (fd >= 0) {
+        close(fd);
+        // the writer has moved to a later segment too, the previous one is entirely sent
+        unlink(segmentPath(fdSegment).c_str());
+      }
+      fdSegment = next.segment;
+      fd = open(segmentPath(fdSegment).c_str(), O_RDONLY);
+    }
+
+    SerializedObject object;
+    if (fd < 0 || !readRecord(fd, next, object)) {
+      LOG(ERROR) << "The object at " << next.offset << " in the spool segment " << segmentPath(next.segment)
+                 << " is corrupted, it is skipped";
+    } else {
+      if (!waitFor(nextSend - std::chrono::steady_clock::now())) {
+        break;
+      }
+      auto result = send(object);
+      attempts++;
+      if (result == SendResult::Retry && (maxAttempts == 0 || attempts < maxAttempts)) {
+        LOG(WARNING) << "Could not send the spooled object " << object.path << ", retrying in " << delay.count()
+                     << " ms";
+        if (!waitFor(delay)) {
+          break;
+        }
+        delay = std::min(delay * 2, retryDelay * 32);
+        continue;
+      }
+      if (result != SendResult::Sent) {
+        std::string reason = result == SendResult::Rejected ? "was rejected"
+                                                            : "could not be sent after " + std::to_string(attempts) + " attempts";
+        LOG(ERROR) << "The spooled object " << object.path << " " << reason << ", it is moved to the quarantine of "
+                   << mDirectory;
+        quarantine(fd, next);
+      }
+      attempts = 0;
+      delay = retryDelay;
+
+      // the objects must leave the spool faster than they arrive, or it never drains
+      auto now = std::chrono::steady_clock::now();
+      if (interval != std::chrono::steady_clock::duration::zero() && now - windowStart >= ingestWindow) {
+        uint64_t appended = 0;
+        {
+          std::lock_guard<std::mutex> lock(mMutex);
+          appended = mNumberOfAppended;
+        }
+        double ingestRate = (appended - windowAppended) / std::chrono::duration<double>(now - windowStart).count();
+        interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1 / std::max(maxRate, 2 * ingestRate)));
+        windowStart = now;
+        windowAppended = appended;
+      }
+      nextSend = now + interval;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mPending.pop_front();
+      mPendingSize -= next.size;
+    }
+    saveCursor(next.segment, next.offset + next.size);
+  }
+
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+size_t Spool::getNumberOfObjects() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mPending.size();
+}
+
+uint64_t Spool::getSize() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mPendingSize;
+}
+
+std::chrono::duration<double> Spool::getOldestAge() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mPending.empty()) {
+    return std::chrono::duration<double>(0);
+  }
+  return std::chrono::duration<double>((now() - mPending.front().spoolTime) / 1000.0);
+}
+
+} // namespace o2::quality_control::repository
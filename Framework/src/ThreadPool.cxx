@@ -0,0 +1,119 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ThreadPool.cxx
+///
+
+#include "QualityControl/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace o2::quality_control::core
+{
+
+ThreadPool::ThreadPool(size_t numberOfThreads)
+{
+  numberOfThreads = std::max<size_t>(numberOfThreads, 1);
+  mThreads.reserve(numberOfThreads);
+  for (size_t i = 0; i < numberOfThreads; i++) {
+    mThreads.emplace_back([this] { work(); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mCondition.notify_all();
+  for (auto& thread : mThreads) {
+    thread.join();
+  }
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task)
+{
+  auto packagedTask = std::make_shared<std::packaged_task<void()>>(std::move(task));
+  std::future<void> future = packagedTask->get_future();
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTasks.emplace_back([packagedTask] { (*packagedTask)(); });
+  }
+  mCondition.notify_one();
+  return future;
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& function)
+{
+  if (count == 0) {
+    return;
+  }
+  // the indices are handed out one by one, so that uneven calls are balanced among the threads
+  std::atomic<size_t> next{ 0 };
+  auto worker = [&next, count, &function] {
+    try {
+      for (size_t i = next++; i < count; i = next++) {
+        function(i);
+      }
+    } catch (...) {
+      next = count; // the other threads stop at their next index
+      throw;
+    }
+  };
+
+  std::vector<std::future<void>> helpers;
+  size_t numberOfHelpers = std::min(mThreads.size(), count - 1);
+  helpers.reserve(numberOfHelpers);
+  for (size_t h = 0; h < numberOfHelpers; h++) {
+    helpers.push_back(submit(worker));
+  }
+
+  std::exception_ptr exception;
+  try {
+    worker();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+  for (auto& helper : helpers) {
+    try {
+      helper.get();
+    } catch (...) {
+      if (!exception) {
+        exception = std::current_exception();
+      }
+    }
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+void ThreadPool::work()
+{
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mCondition.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+      if (mTasks.empty()) {
+        return; // stopping, and nothing left to do
+      }
+      task = std::move(mTasks.front());
+      mTasks.pop_front();
+    }
+    task();
+  }
+}
+
+} // namespace o2::quality_control::core
@@ -0,0 +1,124 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   TrendingExtractor.cxx
+///
+
+#include "QualityControl/TrendingExtractor.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <memory>
+#include <TH1.h>
+
+#include <Common/Exceptions.h>
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/SparseHistogram.h"
+
+using namespace AliceO2::Common;
+
+namespace o2::quality_control::core
+{
+
+TrendingExtractor::TrendingExtractor(std::string objectName, Type type, double from, double to)
+  : mObjectName(std::move(objectName)), mType(type), mFrom(from), mTo(to)
+{
+}
+
+TrendingExtractor TrendingExtractor::fromConfiguration(const boost::property_tree::ptree& config)
+{
+  return TrendingExtractor(config.get<std::string>("object"),
+                           typeFromString(config.get<std::string>("extractor")),
+                           config.get<double>("from", 0),
+                           config.get<double>("to", 0));
+}
+
+TrendingExtractor::Type TrendingExtractor::typeFromString(const std::string& type)
+{
+  if (type == "entries") {
+    return Type::Entries;
+  } else if (type == "mean") {
+    return Type::Mean;
+  } else if (type == "rms") {
+    return Type::RMS;
+  } else if (type == "integral") {
+    return Type::Integral;
+  } else if (type == "quality") {
+    return Type::Quality;
+  }
+  BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("Unknown trending extractor: " + type));
+}
+
+std::string TrendingExtractor::typeToString(Type type)
+{
+  switch (type) {
+    case Type::Entries:
+      return "entries";
+    case Type::Mean:
+      return "mean";
+    case Type::RMS:
+      return "rms";
+    case Type::Integral:
+      return "integral";
+    case Type::Quality:
+      return "quality";
+  }
+  return "unknown";
+}
+
+std::string TrendingExtractor::getSeriesName(const std::string& taskName) const
+{
+  std::string name = taskName + "/" + mObjectName + "/" + typeToString(mType);
+  if (mType == Type::Integral) {
+    name += "_" + std::to_string(mFrom) + "_" + std::to_string(mTo);
+  }
+  return name;
+}
+
+bool TrendingExtractor::extract(const MonitorObject& mo, double& value) const
+{
+  if (mType == Type::Quality) {
+    value = mo.getQuality().getLevel();
+    return true;
+  }
+
+  auto* histo = dynamic_cast<TH1*>(mo.getObject());
+  std::unique_ptr<TH1> dense;
+  if (auto* sparse = dynamic_cast<SparseHistogram*>(mo.getObject())) {
+    if (mType == Type::Entries) {
+      value = sparse->getEntries();
+      return true;
+    }
+    dense.reset(sparse->densify());
+    histo = dense.get();
+  }
+  if (histo == nullptr) {
+    return false;
+  }
+  switch (mType) {
+    case Type::Entries:
+      value = histo->GetEntries();
+      break;
+    case Type::Mean:
+      value = histo->GetMean();
+      break;
+    case Type::RMS:
+      value = histo->GetRMS();
+      break;
+    case Type::Integral:
+      value = histo->Integral(histo->GetXaxis()->FindFixBin(mFrom), histo->GetXaxis()->FindFixBin(mTo));
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+} // namespace o2::quality_control::core
@@ -0,0 +1,252 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   TrendingStore.cxx
+///
+
+#include "QualityControl/TrendingStore.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+// POSIX
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Common/Exceptions.h>
+#include <fairlogger/Logger.h>
+
+using namespace AliceO2::Common;
+
+namespace o2::quality_control::core
+{
+
+namespace
+{
+const uint32_t BlockMagic = 0x42544351; // "QCTB"
+
+// magic, rows, min and max timestamps, min and max runs
+const size_t BlockHeaderSize = sizeof(uint32_t) * 2 + sizeof(int64_t) * 2 + sizeof(int32_t) * 2;
+
+size_t columnsSize(uint32_t rows)
+{
+  return rows * (sizeof(int64_t) + sizeof(int32_t) + sizeof(double));
+}
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& in, T& value)
+{
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+} // namespace
+
+TrendingStore::TrendingStore(std::string directory, size_t blockSize)
+  : mDirectory(std::move(directory)), mBlockSize(blockSize == 0 ? 1 : blockSize)
+{
+  // create the directory and its parents if needed
+  for (size_t pos = mDirectory.find('/', 1); ; pos = mDirectory.find('/', pos + 1)) {
+    std::string subpath = mDirectory.substr(0, pos);
+    if (mkdir(subpath.c_str(), 0755) != 0 && errno != EEXIST) {
+      BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("Could not create the trending directory " + subpath));
+    }
+    if (pos == std::string::npos) {
+      break;
+    }
+  }
+}
+
+TrendingStore::~TrendingStore()
+{
+  try {
+    flush();
+  } catch (...) {
+    LOG(ERROR) << "Could not flush the trending store in " << mDirectory << ": "
+               << boost::current_exception_diagnostic_information();
+  }
+}
+
+std::string TrendingStore::getFilePath(const std::string& series) const
+{
+  // series names contain slashes and possibly other characters not welcome in file names
+  std::string fileName;
+  for (unsigned char c : series) {
+    if (std::isalnum(c) || c == '_' || c == '-' || c == '.') {
+      fileName += c;
+    } else {
+      char escaped[4];
+      snprintf(escaped, sizeof(escaped), "%%%02X", c);
+      fileName += escaped;
+    }
+  }
+  return mDirectory + "/" + fileName + ".trend";
+}
+
+void TrendingStore::append(const std::string& seriesName, int64_t timestamp, int32_t run, double value)
+{
+  Series& series = getSeries(seriesName);
+  series.buffer.push_back({ timestamp, run, value });
+  if (series.buffer.size() >= mBlockSize) {
+    flushSeries(series);
+  }
+}
+
+void TrendingStore::flush()
+{
+  for (auto& [name, series] : mSeries) {
+    flushSeries(series);
+  }
+}
+
+std::vector<TrendingPoint> TrendingStore::query(const std::string& seriesName, int64_t from, int64_t to, int32_t run)
+{
+  Series& series = getSeries(seriesName);
+  std::vector<TrendingPoint> result;
+  auto accept = [&](int64_t timestamp, int32_t pointRun) {
+    return timestamp >= from && timestamp <= to && (run < 0 || pointRun == run);
+  };
+
+  std::ifstream in(series.path, std::ios::binary);
+  std::vector<int64_t> timestamps;
+  std::vector<int32_t> runs;
+  std::vector<double> values;
+  for (const auto& block : series.blocks) {
+    if (block.maxTimestamp < from || block.minTimestamp > to || (run >= 0 && (run < block.minRun || run > block.maxRun))) {
+      continue;
+    }
+    timestamps.resize(block.rows);
+    runs.resize(block.rows);
+    values.resize(block.rows);
+    in.seekg(block.offset);
+    in.read(reinterpret_cast<char*>(timestamps.data()), block.rows * sizeof(int64_t));
+    in.read(reinterpret_cast<char*>(runs.data()), block.rows * sizeof(int32_t));
+    in.read(reinterpret_cast<char*>(values.data()), block.rows * sizeof(double));
+    if (!in) {
+      BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("Could not read a block of " + series.path));
+    }
+    for (uint32_t i = 0; i < block.rows; i++) {
+      if (accept(timestamps[i], runs[i])) {
+        result.push_back({ timestamps[i], runs[i], values[i] });
+      }
+    }
+  }
+
+  for (const auto& point : series.buffer) {
+    if (accept(point.timestamp, point.run)) {
+      result.push_back(point);
+    }
+  }
+  return result;
+}
+
+TrendingStore::Series& TrendingStore::getSeries(const std::string& name)
+{
+  auto series = mSeries.find(name);
+  if (series == mSeries.end()) {
+    series = mSeries.emplace(name, Series{}).first;
+    series->second.path = getFilePath(name);
+    loadIndex(series->second);
+  }
+  return series->second;
+}
+
+void TrendingStore::loadIndex(Series& series)
+{
+  std::ifstream in(series.path, std::ios::binary);
+  if (!in) {
+    return; // new series
+  }
+  in.seekg(0, std::ios::end);
+  int64_t fileSize = in.tellg();
+  in.seekg(0);
+
+  int64_t position = 0;
+  while (position + static_cast<int64_t>(BlockHeaderSize) <= fileSize) {
+    uint32_t magic = 0;
+    BlockInfo block{};
+    in.seekg(position);
+    if (!(readValue(in, magic) && magic == BlockMagic && readValue(in, block.rows) && readValue(in, block.minTimestamp) &&
+          readValue(in, block.maxTimestamp) && readValue(in, block.minRun) && readValue(in, block.maxRun))) {
+      break;
+    }
+    block.offset = position + BlockHeaderSize;
+    if (block.offset + static_cast<int64_t>(columnsSize(block.rows)) > fileSize) {
+      break;
+    }
+    series.blocks.push_back(block);
+    position = block.offset + columnsSize(block.rows);
+  }
+
+  if (position != fileSize) {
+    // the last block was not entirely written, we get rid of it so that new blocks can be appended
+    in.close();
+    if (::truncate(series.path.c_str(), position) != 0) {
+      BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("Could not repair " + series.path));
+    }
+  }
+}
+
+void TrendingStore::flushSeries(Series& series)
+{
+  if (series.buffer.empty()) {
+    return;
+  }
+
+  std::ofstream out(series.path, std::ios::binary | std::ios::app);
+  if (!out) {
+    BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("Could not open " + series.path));
+  }
+  int64_t position = out.tellp();
+
+  BlockInfo block{};
+  block.rows = series.buffer.size();
+  block.offset = position + BlockHeaderSize;
+  auto [minTs, maxTs] = std::minmax_element(series.buffer.begin(), series.buffer.end(),
+                                            [](const TrendingPoint& a, const TrendingPoint& b) { return a.timestamp < b.timestamp; });
+  auto [minRun, maxRun] = std::minmax_element(series.buffer.begin(), series.buffer.end(),
+                                              [](const TrendingPoint& a, const TrendingPoint& b) { return a.run < b.run; });
+  block.minTimestamp = minTs->timestamp;
+  block.maxTimestamp = maxTs->timestamp;
+  block.minRun = minRun->run;
+  block.maxRun = maxRun->run;
+
+  writeValue(out, BlockMagic);
+  writeValue(out, block.rows);
+  writeValue(out, block.minTimestamp);
+  writeValue(out, block.maxTimestamp);
+  writeValue(out, block.minRun);
+  writeValue(out, block.maxRun);
+  for (const auto& point : series.buffer) {
+    writeValue(out, point.timestamp);
+  }
+  for (const auto& point : series.buffer) {
+    writeValue(out, point.run);
+  }
+  for (const auto& point : series.buffer) {
+    writeValue(out, point.value);
+  }
+  out.flush();
+  if (!out) {
+    BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("Could not write a block to " + series.path));
+  }
+
+  series.blocks.push_back(block);
+  series.buffer.clear();
+}
+
+} // namespace o2::quality_control::core
@@ -0,0 +1,115 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   VersionCache.cxx
+///
+
+#include "QualityControl/VersionCache.h"
+
+namespace o2::quality_control::repository
+{
+
+VersionCache::VersionCache(size_t maxSize) : mMaxSize(maxSize) {}
+
+void VersionCache::setMaxSize(size_t maxSize)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mMaxSize = maxSize;
+  evict();
+}
+
+std::shared_ptr<const CachedVersion> VersionCache::find(const std::string& path, long timestamp)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  // the version of the path which started the latest before the timestamp
+  auto index = mIndex.upper_bound({ path, timestamp });
+  if (index == mIndex.begin()) {
+    return nullptr;
+  }
+  --index;
+  if (index->first.first != path || timestamp >= index->second->version->validUntil) {
+    return nullptr;
+  }
+  mEntries.splice(mEntries.begin(), mEntries, index->second);
+  return index->second->version;
+}
+
+void VersionCache::insert(const std::string& path, std::shared_ptr<const CachedVersion> version)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  Key key{ path, version->validFrom };
+  auto existing = mIndex.find(key);
+  if (existing != mIndex.end()) {
+    erase(existing);
+  }
+  size_t size = sizeof(Entry) + path.size() + version->etag.size() + version->content.size();
+  if (size > mMaxSize) {
+    return;
+  }
+  mEntries.push_front({ key, std::move(version), size });
+  mIndex.emplace(key, mEntries.begin());
+  mSize += size;
+  evict();
+}
+
+void VersionCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mEntries.clear();
+  mIndex.clear();
+  mSize = 0;
+}
+
+void VersionCache::erase(std::map<Key, std::list<Entry>::iterator>::iterator index)
+{
+  mSize -= index->second->size;
+  mEntries.erase(index->second);
+  mIndex.erase(index);
+}
+
+void VersionCache::evict()
+{
+  while (mSize > mMaxSize) {
+    erase(mIndex.find(mEntries.back().key));
+  }
+}
+
+void VersionCache::countHit()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mHits++;
+}
+
+void VersionCache::countMiss()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mMisses++;
+}
+
+double VersionCache::getHitRatio() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mHits + mMisses == 0 ? 0 : static_cast<double>(mHits) / (mHits + mMisses);
+}
+
+size_t VersionCache::getSize() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mSize;
+}
+
+size_t VersionCache::getNumberOfVersions() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mEntries.size();
+}
+
+} // namespace o2::quality_control::repository
@@ -0,0 +1,55 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   runFileRepositoryCompaction.cxx
+///
+/// \brief Compacts a file repository (see FileStore), while no other process uses it.
+///
+
+#include "QualityControl/CcdbDatabase.h"
+#include "QualityControl/FileStore.h"
+
+#include <climits>
+#include <iostream>
+#include <boost/program_options.hpp>
+
+namespace bpo = boost::program_options;
+using namespace o2::quality_control::repository;
+
+int main(int argc, char* argv[])
+{
+  bpo::options_description options("Options");
+  options.add_options()("help,h", "Print this help")(
+    "directory", bpo::value<std::string>()->required(), "Directory of the file repository")(
+    "keep-versions", bpo::value<size_t>()->default_value(1),
+    "Number of latest versions kept for each object, 0 keeps them all (default : 1)")(
+    "keep-days", bpo::value<long>()->default_value(0),
+    "The versions which started during the last days are kept too (default : 0)");
+
+  bpo::variables_map arguments;
+  try {
+    bpo::store(bpo::parse_command_line(argc, argv, options), arguments);
+    if (arguments.count("help")) {
+      std::cout << options << std::endl;
+      return 0;
+    }
+    bpo::notify(arguments);
+  } catch (bpo::error& e) {
+    std::cerr << e.what() << "\n"
+              << options << std::endl;
+    return 1;
+  }
+
+  long keepDays = arguments["keep-days"].as<long>();
+  long keepSince = keepDays > 0 ? CcdbDatabase::getCurrentTimestamp() - keepDays * 24 * 60 * 60 * 1000 : LONG_MAX;
+  bool compacted = FileStore::compact(arguments["directory"].as<std::string>(), arguments["keep-versions"].as<size_t>(), keepSince);
+  return compacted ? 0 : 1;
+}
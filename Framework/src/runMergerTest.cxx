@@ -13,24 +13,45 @@
 /// \author  Piotr Konopka
 ///
 /// \brief This is DPL workflow to see HistoMerger in action
+///
+/// N producers publish histograms which are merged by a tree of mergers, as generated by the InfrastructureGenerator.
+/// To see how the tree scales, run e.g.:
+/// \code
+/// o2-qc-run-merger-test --producers 250 --fan-in 16
+/// \endcode
 
 #include <fairlogger/Logger.h>
 #include <Framework/CompletionPolicy.h>
-#include <Framework/CompletionPolicyHelpers.h>
+#include <Framework/ConfigParamSpec.h>
 #include <TH1F.h>
+#include <TH2F.h>
+#include <algorithm>
 #include <memory>
 #include <random>
+
+#include "QualityControl/InfrastructureGenerator.h"
+
 using namespace o2::framework;
 
 // The customize() functions are used to declare the executable arguments and to specify custom completion and channel
 // configuration policies. They have to be above `#include "Framework/runDataProcessing.h"` - that header checks if
 // these functions are defined by user and if so, it invokes them. It uses a trick with SFINAE expressions to do that.
 
+void customize(std::vector<ConfigParamSpec>& workflowOptions)
+{
+  workflowOptions.push_back(
+    ConfigParamSpec{ "producers", VariantType::Int, 10, { "Number of producers of histograms." } });
+  workflowOptions.push_back(
+    ConfigParamSpec{ "fan-in", VariantType::Int, 0, { "Maximum number of inputs of a merger, 0 for no limit." } });
+  workflowOptions.push_back(
+    ConfigParamSpec{ "layers", VariantType::Int, 0, { "Number of layers of mergers, 0 to derive it from fan-in." } });
+  workflowOptions.push_back(
+    ConfigParamSpec{ "merger-threads", VariantType::Int, 1, { "Number of threads merging in each merger." } });
+}
+
 void customize(std::vector<CompletionPolicy>& policies)
 {
-  CompletionPolicy mergerConsumesASAP =
-    CompletionPolicyHelpers::defineByName("merger", CompletionPolicy::CompletionOp::Consume);
-  policies.push_back(mergerConsumesASAP);
+  o2::quality_control::customizeInfrastructure(policies);
 }
 
 #include <Framework/runDataProcessing.h>
@@ -43,11 +64,11 @@ using namespace o2::quality_control::checker;
 using namespace std::chrono;
 
 // clang-format off
-WorkflowSpec defineDataProcessing(ConfigContext const&)
+WorkflowSpec defineDataProcessing(ConfigContext const& config)
 {
   WorkflowSpec specs;
 
-  size_t producersAmount = 10;
+  size_t producersAmount = std::max(1, config.options().get<int>("producers"));
   for(size_t p = 0; p < producersAmount; p++) {
     DataProcessorSpec producer{
       "producer" + std::to_string(p),
@@ -69,6 +90,13 @@ WorkflowSpec defineDataProcessing(ConfigContext const&)
           array->SetOwner(true);
           array->Add(mo);
 
+          // only some of the producers publish this one, the merger matches the objects by name
+          if (p % 2 == 0) {
+            TH2F* map = new TH2F("map", "map", producersAmount, 0, 1, producersAmount, 0, 1);
+            map->Fill(p / (double)producersAmount, p / (double)producersAmount);
+            array->Add(new MonitorObject(map, "histo-task"));
+          }
+
           processingContext.outputs().adopt(Output{ "TST", "HISTO", static_cast<o2::framework::DataAllocator::SubSpecificationType>(p + 1) }, array);
         }
       }
@@ -76,15 +104,17 @@ WorkflowSpec defineDataProcessing(ConfigContext const&)
     specs.push_back(producer);
   }
 
-  HistoMerger merger("merger", 1);
-  merger.configureInputsOutputs("TST", "HISTO", { 1, producersAmount });
-  DataProcessorSpec mergerSpec{
-    merger.getName(),
-    merger.getInputSpecs(),
-    Outputs{merger.getOutputSpec()},
-    adaptFromTask<HistoMerger>(std::move(merger)),
-  };
-  specs.push_back(mergerSpec);
+  auto mergersPerLayer = InfrastructureGenerator::computeMergersTopology(producersAmount,
+                                                                          std::max(0, config.options().get<int>("fan-in")),
+                                                                          std::max(0, config.options().get<int>("layers")));
+  std::string topology;
+  for (auto mergers : mergersPerLayer) {
+    topology += " " + std::to_string(mergers);
+  }
+  LOG(INFO) << "Mergers in each layer:" << topology;
+  size_t mergerThreads = std::max(1, config.options().get<int>("merger-threads"));
+  InfrastructureGenerator::generateMergers(specs, "test-merger", "TST", "HISTO", producersAmount, mergersPerLayer,
+                                           [mergerThreads](HistoMerger& merger) { merger.setNumberOfThreads(mergerThreads); });
 
   DataProcessorSpec printer{
     "printer",
@@ -101,6 +131,7 @@ WorkflowSpec defineDataProcessing(ConfigContext const&)
 
           if (mo->getName() == "gauss") {
             auto* g = dynamic_cast<TH1F*>(mo->getObject());
+            LOG(INFO) << "ENTRIES: " << g->GetEntries();
             std::string bins = "BINS:";
             for (int i = 0; i <= g->GetNbinsX(); i++) {
               bins += " " + std::to_string((int) g->GetBinContent(i));
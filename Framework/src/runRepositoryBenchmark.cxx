@@ -39,13 +39,18 @@ void addCustomOptions(bpo::options_description& options)
     "delete", bpo::value<int>()->default_value(0),
     "Deletion mode (deletes all the versions of the object, 1:true, 0:false)")(
     "database-backend", bpo::value<std::string>()->default_value("CCDB"),
-    "Name of the database backend (\"CCDB\" (default) or \"MySql\"")(
+    "Name of the database backend (\"CCDB\" (default), \"MySql\" or \"File\", whose url is a directory)")(
     "monitoring-threaded", bpo::value<int>()->default_value(1),
     "Whether to send the objects rate from a dedicated thread (1, default) or directly from the main thread (0)")(
     "monitoring-threaded-interval", bpo::value<int>()->default_value(1),
     "In case we have a thread for the monitoring, interval in sec. between sending monitoring data")(
     "monitoring-url", bpo::value<std::string>()->default_value("infologger://"),
-    "The URL to the monitoring system (default : \"infologger://\")");
+    "The URL to the monitoring system (default : \"infologger://\")")(
+    "upload-threads", bpo::value<uint64_t>()->default_value(0),
+    "Number of concurrent uploads to the CCDB with storeAsync, 0 stores the objects one by one (default : 0)")(
+    "read", bpo::value<int>()->default_value(0),
+    "Read mode, retrieves the objects stored by a previous run instead of storing them: one by one with retrieve (1) "
+    "or all at once with retrieveMany (2), 0 stores them (default : 0)");
 }
 
 FairMQDevicePtr getDevice(const FairMQProgOptions& /*config*/)
@@ -0,0 +1,62 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkHistogramAdd.cxx
+///
+/// Compares the duration of the merge of histograms with the same layout with TH1::Add.
+/// It is built with the tests but not run by ctest, the results are checked in testMergeRegistry.
+///
+
+#include "QualityControl/HistogramAdd.h"
+
+#include <chrono>
+#include <iostream>
+#include <TH2F.h>
+#include <TRandom3.h>
+
+using namespace o2::quality_control::core;
+
+int main()
+{
+  // 100 updates of a TH2F of 1 MB
+  const int bins = 510;
+  const int updates = 100;
+  TRandom3 random(42);
+  TH2F update("update", "update", bins, 0, 1, bins, 0, 1);
+  for (int i = 0; i < 100000; i++) {
+    update.Fill(random.Rndm(), random.Rndm());
+  }
+  TH2F fast("fast", "fast", bins, 0, 1, bins, 0, 1);
+  TH2F root("root", "root", bins, 0, 1, bins, 0, 1);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < updates; i++) {
+    histograms::addSameLayout(fast, update);
+  }
+  auto fastDuration = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < updates; i++) {
+    root.Add(&update);
+  }
+  auto rootDuration = std::chrono::steady_clock::now() - start;
+
+  if (fast.GetEntries() != root.GetEntries()) {
+    std::cerr << "The merged histograms differ" << std::endl;
+    return 1;
+  }
+
+  using std::chrono::microseconds;
+  auto fastUs = std::chrono::duration_cast<microseconds>(fastDuration).count() / updates;
+  auto rootUs = std::chrono::duration_cast<microseconds>(rootDuration).count() / updates;
+  std::cout << "Merging a TH2F of " << (bins + 2) * (bins + 2) * sizeof(Float_t) / 1024 << " kB: same layout "
+            << fastUs << " us, TH1::Add " << rootUs << " us" << std::endl;
+  return 0;
+}
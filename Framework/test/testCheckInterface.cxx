@@ -14,12 +14,15 @@
 ///
 
 #include "QualityControl/CheckInterface.h"
+#include "QualityControl/TypedCheck.h"
 
 #define BOOST_TEST_MODULE CheckInterface test
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 
 #include <boost/test/unit_test.hpp>
+#include <TH1F.h>
+#include <TH1I.h>
 #include <TObjString.h>
 #include <string>
 
@@ -71,6 +74,28 @@ class TestCheck : public checker::CheckInterface
   string mValidString;
 };
 
+class TestTypedCheck : public checker::TypedCheck<TH1F>
+{
+ public:
+  void configure(std::string) override {}
+
+  int mChecked = 0;
+  int mBeautified = 0;
+
+ protected:
+  Quality checkObject(const MonitorObject*, const TH1F& histo) override
+  {
+    mChecked++;
+    return histo.GetEntries() > 0 ? Quality::Good : Quality::Bad;
+  }
+
+  void beautifyObject(MonitorObject*, TH1F& histo, Quality) override
+  {
+    mBeautified++;
+    histo.SetLineColor(kRed);
+  }
+};
+
 } /* namespace test */
 } /* namespace o2::quality_control */
 
@@ -92,4 +117,29 @@ BOOST_AUTO_TEST_CASE(test_invoke_all_methods)
   BOOST_CHECK_EQUAL(reinterpret_cast<TObjString*>(mo.getObject())->String(), "A string is beautiful now");
 
   BOOST_CHECK_EQUAL(testCheck.getAcceptedType(), "TObjString");
-}
\ No newline at end of file
+}
+BOOST_AUTO_TEST_CASE(test_typed_check)
+{
+  test::TestTypedCheck testCheck;
+  BOOST_CHECK_EQUAL(testCheck.getAcceptedType(), "TH1F");
+
+  auto* histo = new TH1F("histo", "histo", 10, 0, 10);
+  MonitorObject mo(histo, "task");
+  BOOST_CHECK(testCheck.isObjectCheckable(&mo));
+  BOOST_CHECK_EQUAL(testCheck.check(&mo), Quality::Bad);
+  histo->Fill(1);
+  BOOST_CHECK_EQUAL(testCheck.check(&mo), Quality::Good);
+  testCheck.beautify(&mo, Quality::Good);
+  BOOST_CHECK_EQUAL(histo->GetLineColor(), kRed);
+
+  // objects of other classes are neither checked nor beautified
+  MonitorObject moInt(new TH1I("histoInt", "histoInt", 10, 0, 10), "task");
+  MonitorObject moString(new TObjString("A string"), "task");
+  BOOST_CHECK(!testCheck.isObjectCheckable(&moInt));
+  BOOST_CHECK_EQUAL(testCheck.check(&moInt), Quality::Null);
+  BOOST_CHECK_EQUAL(testCheck.check(&moString), Quality::Null);
+  testCheck.beautify(&moString);
+  BOOST_CHECK_EQUAL(testCheck.check(&mo), Quality::Good);
+  BOOST_CHECK_EQUAL(testCheck.mChecked, 3);
+  BOOST_CHECK_EQUAL(testCheck.mBeautified, 1);
+}
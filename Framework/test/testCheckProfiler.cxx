@@ -0,0 +1,62 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    testCheckProfiler.cxx
+///
+
+#include "QualityControl/CheckProfiler.h"
+
+#define BOOST_TEST_MODULE CheckProfiler test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::checker;
+
+BOOST_AUTO_TEST_CASE(test_call_statistics)
+{
+  CallStatistics stats(100);
+  BOOST_CHECK_EQUAL(stats.getCount(), 0);
+  BOOST_CHECK_EQUAL(stats.getPercentile(99), 0);
+
+  for (int i = 1; i <= 200; i++) {
+    stats.add(i);
+  }
+  BOOST_CHECK_EQUAL(stats.getCount(), 200);
+  BOOST_CHECK_EQUAL(stats.getTotal(), 20100);
+  BOOST_CHECK_EQUAL(stats.getMax(), 200);
+  // only the last 100 calls are considered for percentiles
+  BOOST_CHECK_EQUAL(stats.getPercentile(99), 199);
+  BOOST_CHECK_EQUAL(stats.getPercentile(0), 101);
+  BOOST_CHECK_EQUAL(stats.getPercentile(100), 200);
+}
+
+BOOST_AUTO_TEST_CASE(test_check_profiler)
+{
+  CheckProfiler profiler;
+  profiler.record("checkA", "MeanIsAbove", CheckProfiler::Call::Check, 10);
+  profiler.record("checkB", "MeanIsAbove", CheckProfiler::Call::Check, 30);
+  profiler.record("checkB", "MeanIsAbove", CheckProfiler::Call::Beautify, 5);
+
+  const auto& checks = profiler.getChecksStatistics();
+  BOOST_REQUIRE_EQUAL(checks.size(), 3);
+  BOOST_CHECK_EQUAL(checks.at("checkA/check").getCount(), 1);
+  BOOST_CHECK_EQUAL(checks.at("checkB/check").getTotal(), 30);
+  BOOST_CHECK_EQUAL(checks.at("checkB/beautify").getMax(), 5);
+
+  const auto& classes = profiler.getClassesStatistics();
+  BOOST_REQUIRE_EQUAL(classes.size(), 2);
+  BOOST_CHECK_EQUAL(classes.at("MeanIsAbove/check").getCount(), 2);
+  BOOST_CHECK_EQUAL(classes.at("MeanIsAbove/check").getMax(), 30);
+
+  BOOST_CHECK(profiler.dump().find("checkB/beautify") != std::string::npos);
+}
@@ -46,6 +46,24 @@ BOOST_AUTO_TEST_CASE(test_checker_factory)
   BOOST_CHECK(checker.algorithm.onInit != nullptr);
 }
 
+BOOST_AUTO_TEST_CASE(test_checker_factory_many_tasks)
+{
+  std::string configFilePath{ "json://tests/testSharedConfig.json" };
+
+  CheckerFactory checkerFactory;
+  DataProcessorSpec checker = checkerFactory.create("QC-CHECKER-0", std::vector<std::string>{ "abcTask", "xyzTask" }, configFilePath);
+
+  BOOST_CHECK_EQUAL(checker.name, "QC-CHECKER-0");
+
+  BOOST_REQUIRE_EQUAL(checker.inputs.size(), 2);
+  BOOST_CHECK_EQUAL(checker.inputs[0], (InputSpec{ { "mo" }, "QC", "abcTask-mo", 0 }));
+  BOOST_CHECK_EQUAL(checker.inputs[1], (InputSpec{ { "mo" }, "QC", "xyzTask-mo", 0 }));
+
+  BOOST_REQUIRE_EQUAL(checker.outputs.size(), 2);
+  BOOST_CHECK_EQUAL(checker.outputs[0], (OutputSpec{ "QC", "abcTask-chk", 0 }));
+  BOOST_CHECK_EQUAL(checker.outputs[1], (OutputSpec{ "QC", "xyzTask-chk", 0 }));
+}
+
 BOOST_AUTO_TEST_CASE(test_checker_static)
 {
   BOOST_CHECK(Checker::createCheckerDataDescription("qwertyuiop") == DataDescription("qwertyuiop-chk"));
@@ -0,0 +1,102 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testContentDeduplicator.cxx
+///
+
+#include "QualityControl/ContentDeduplicator.h"
+
+#define BOOST_TEST_MODULE ContentDeduplicator test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::repository;
+
+namespace
+{
+const std::map<std::string, std::string> metadata = { { "quality", "1" }, { "RunNumber", "42" } };
+} // namespace
+
+BOOST_AUTO_TEST_CASE(deduplicator_disabled_by_default)
+{
+  ContentDeduplicator deduplicator;
+  BOOST_CHECK_EQUAL(deduplicator.getPeriod(), 0);
+  size_t hash = ContentDeduplicator::hash("content", metadata);
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 1000));
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 1001));
+  BOOST_CHECK_EQUAL(deduplicator.getSkipped(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(deduplicator_identical_skipped)
+{
+  ContentDeduplicator deduplicator(600);
+  size_t hash = ContentDeduplicator::hash("content", metadata);
+  BOOST_CHECK_EQUAL(hash, ContentDeduplicator::hash("content", metadata));
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 1000));
+  BOOST_CHECK(deduplicator.isDuplicate("qc/TST/task/a", hash, 2000));
+  // the same content in another path is not a duplicate
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/b", hash, 2000));
+  BOOST_CHECK_EQUAL(deduplicator.getSkipped(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(deduplicator_changed_stored)
+{
+  ContentDeduplicator deduplicator(600);
+  size_t hash = ContentDeduplicator::hash("content", metadata);
+  size_t changedContent = ContentDeduplicator::hash("content2", metadata);
+  size_t changedMetadata = ContentDeduplicator::hash("content", { { "quality", "3" }, { "RunNumber", "42" } });
+  BOOST_CHECK_NE(hash, changedContent);
+  BOOST_CHECK_NE(hash, changedMetadata);
+
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 1000));
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", changedContent, 2000));
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", changedMetadata, 3000));
+  // only the latest content is remembered, going back to the first one is a change
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 4000));
+  BOOST_CHECK(deduplicator.isDuplicate("qc/TST/task/a", hash, 5000));
+}
+
+BOOST_AUTO_TEST_CASE(deduplicator_period_expiry)
+{
+  ContentDeduplicator deduplicator(10);
+  size_t hash = ContentDeduplicator::hash("content", metadata);
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 1000));
+  BOOST_CHECK(deduplicator.isDuplicate("qc/TST/task/a", hash, 10999));
+  // stored again once the period is over, which starts a new period
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 11000));
+  BOOST_CHECK(deduplicator.isDuplicate("qc/TST/task/a", hash, 20999));
+
+  // a new period forgets the contents
+  deduplicator.setPeriod(20);
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 21000));
+  deduplicator.setPeriod(-1);
+  BOOST_CHECK_EQUAL(deduplicator.getPeriod(), 0);
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 21001));
+}
+
+BOOST_AUTO_TEST_CASE(deduplicator_forget_failed)
+{
+  ContentDeduplicator deduplicator(600);
+  size_t hash = ContentDeduplicator::hash("content", metadata);
+  size_t other = ContentDeduplicator::hash("other", metadata);
+
+  // the content could not be stored, the next identical one is stored
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 1000));
+  deduplicator.forget("qc/TST/task/a", hash);
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", hash, 2000));
+
+  // a failed content which is not the latest one anymore does not forget the latest one
+  BOOST_CHECK(!deduplicator.isDuplicate("qc/TST/task/a", other, 3000));
+  deduplicator.forget("qc/TST/task/a", hash);
+  BOOST_CHECK(deduplicator.isDuplicate("qc/TST/task/a", other, 4000));
+}
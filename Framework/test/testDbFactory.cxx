@@ -14,6 +14,7 @@
 ///
 
 #include "QualityControl/DatabaseFactory.h"
+#include "TestTemporaryDirectory.h"
 
 #ifdef _WITH_MYSQL
 
@@ -29,8 +30,13 @@
 //#include <iostream>
 
 #include <QualityControl/CcdbDatabase.h>
+#include <QualityControl/FileDatabase.h>
 #include <QualityControl/MonitorObject.h>
 #include <TH1F.h>
+#include <chrono>
+#include <climits>
+#include <map>
+#include <thread>
 //#include <fcntl.h>
 //#include <stdio.h>
 //#include <sys/stat.h>
@@ -58,6 +64,122 @@ BOOST_AUTO_TEST_CASE(db_factory_test)
   std::unique_ptr<DatabaseInterface> database3 = DatabaseFactory::create("CCDB");
   BOOST_CHECK(database3);
   BOOST_CHECK(dynamic_cast<CcdbDatabase*>(database3.get()));
+
+  std::unique_ptr<DatabaseInterface> database4 = DatabaseFactory::create("File");
+  BOOST_CHECK(database4);
+  BOOST_CHECK(dynamic_cast<FileDatabase*>(database4.get()));
+}
+
+BOOST_AUTO_TEST_CASE(db_file_store_retrieve)
+{
+  TestTemporaryDirectory directory("qc_file_database");
+  {
+    std::unique_ptr<DatabaseInterface> database = DatabaseFactory::create("File");
+    database->connect(directory.path, "", "", "");
+
+    auto* h1 = new TH1F("object1", "object1", 100, 0, 99);
+    h1->Fill(5);
+    shared_ptr<MonitorObject> mo1 = make_shared<MonitorObject>(h1, "functional_test", "TST");
+    database->store(mo1);
+    auto* h2 = new TH1F("path/to/object2", "object2", 100, 0, 99);
+    shared_ptr<MonitorObject> mo2 = make_shared<MonitorObject>(h2, "functional_test", "TST");
+    database->store(mo2);
+    database->flush();
+
+    unique_ptr<MonitorObject> retrieved(database->retrieve("qc/TST/functional_test", "object1"));
+    BOOST_REQUIRE(retrieved != nullptr);
+    BOOST_CHECK_EQUAL(dynamic_cast<TH1F*>(retrieved->getObject())->GetEntries(), 1);
+    BOOST_CHECK(database->retrieve("qc/TST/functional_test", "object1", 1000) == nullptr);
+    BOOST_CHECK(!database->retrieveJson("qc/TST/functional_test", "object1").empty());
+
+    auto names = database->getPublishedObjectNames("qc/TST/functional_test");
+    BOOST_CHECK(names == std::vector<std::string>({ "object1", "path/to/object2" }));
+
+    auto versions = database->retrieveVersions("qc/TST/functional_test", "object1", 0, LONG_MAX, { { "quality", "3" } });
+    BOOST_CHECK(!versions->next());
+    database->truncate("qc/TST/functional_test", "object1");
+    BOOST_CHECK(database->retrieve("qc/TST/functional_test", "object1") == nullptr);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(db_file_retrieve_many)
+{
+  TestTemporaryDirectory directory("qc_file_database");
+  std::unique_ptr<DatabaseInterface> database = DatabaseFactory::create("File");
+  database->connect(directory.path, "", "", "");
+  for (const auto& name : { "object1", "object2" }) {
+    auto* h = new TH1F(name, name, 100, 0, 99);
+    database->store(make_shared<MonitorObject>(h, "functional_test", "TST"));
+  }
+
+  // exactly one call per requested name, with nullptr for the missing object
+  std::map<std::string, int> calls;
+  std::map<std::string, bool> found;
+  database->retrieveMany("qc/TST/functional_test", { "object1", "missing", "object2" }, 0,
+                         [&](const std::string& objectName, std::unique_ptr<MonitorObject> mo) {
+                           calls[objectName]++;
+                           found[objectName] = mo != nullptr;
+                           if (mo) {
+                             BOOST_CHECK_EQUAL(mo->getName(), objectName);
+                           }
+                         });
+  BOOST_CHECK(calls == (std::map<std::string, int>{ { "object1", 1 }, { "missing", 1 }, { "object2", 1 } }));
+  BOOST_CHECK(found["object1"]);
+  BOOST_CHECK(found["object2"]);
+  BOOST_CHECK(!found["missing"]);
+}
+
+BOOST_AUTO_TEST_CASE(db_file_retrieve_versions)
+{
+  TestTemporaryDirectory directory("qc_file_database");
+  std::unique_ptr<DatabaseInterface> database = DatabaseFactory::create("File");
+  database->connect(directory.path, "", "", "");
+  // 3 versions, the version i has i entries
+  for (int i = 1; i <= 3; i++) {
+    auto* h = new TH1F("object", "object", 100, 0, 99);
+    h->FillRandom("gaus", i);
+    auto mo = make_shared<MonitorObject>(h, "functional_test", "TST");
+    mo->addMetadata(runMetadataKey, std::to_string(i));
+    mo->addMetadata("beam", i == 2 ? "off" : "on");
+    database->store(mo);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5)); // the versions start at different times
+  }
+
+  // lists the runs of the versions, checking that they are in the order of their validity start
+  auto runs = [&](long from, long to, const std::map<std::string, std::string>& filter) {
+    std::vector<std::string> listed;
+    long previous = 0;
+    auto versions = database->retrieveVersions("qc/TST/functional_test", "object", from, to, filter);
+    while (versions->next()) {
+      BOOST_CHECK_GT(versions->version().validFrom, previous);
+      previous = versions->version().validFrom;
+      listed.push_back(versions->version().metadata.at(runMetadataKey));
+    }
+    return listed;
+  };
+  using Runs = std::vector<std::string>;
+
+  std::vector<long> starts;
+  auto versions = database->retrieveVersions("qc/TST/functional_test", "object", 0, LONG_MAX);
+  while (versions->next()) {
+    starts.push_back(versions->version().validFrom);
+    std::unique_ptr<MonitorObject> mo = versions->object();
+    BOOST_REQUIRE(mo != nullptr);
+    BOOST_CHECK_EQUAL(dynamic_cast<TH1F*>(mo->getObject())->GetEntries(), starts.size());
+  }
+  BOOST_REQUIRE_EQUAL(starts.size(), 3);
+  BOOST_CHECK(runs(0, LONG_MAX, {}) == Runs({ "1", "2", "3" }));
+
+  // the bounds are included
+  BOOST_CHECK(runs(starts[0], starts[1], {}) == Runs({ "1", "2" }));
+  BOOST_CHECK(runs(starts[0] + 1, starts[2] - 1, {}) == Runs({ "2" }));
+  BOOST_CHECK(runs(starts[2] + 1, LONG_MAX, {}).empty());
+
+  // all the metadata of the filter must match
+  BOOST_CHECK(runs(0, LONG_MAX, { { runMetadataKey, "2" } }) == Runs({ "2" }));
+  BOOST_CHECK(runs(0, LONG_MAX, { { "beam", "on" } }) == Runs({ "1", "3" }));
+  BOOST_CHECK(runs(0, LONG_MAX, { { "beam", "on" }, { runMetadataKey, "2" } }).empty());
+  BOOST_CHECK(runs(0, LONG_MAX, { { "unknown", "1" } }).empty());
 }
 
 BOOST_AUTO_TEST_CASE(db_ccdb_listing)
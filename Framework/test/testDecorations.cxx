@@ -0,0 +1,80 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testDecorations.cxx
+///
+
+#include "QualityControl/Decorations.h"
+
+#define BOOST_TEST_MODULE Decorations test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <TGraph.h>
+#include <TH1F.h>
+#include <TLine.h>
+#include <TNamed.h>
+#include <TPaveText.h>
+
+using namespace o2::quality_control::checker;
+
+BOOST_AUTO_TEST_CASE(decorations_reused)
+{
+  auto* histo = new TH1F("histo", "histo", 10, 0, 10);
+  MonitorObject mo(histo, "task"); // mo owns the histo
+  auto* line = new TLine(0, 1, 10, 1);
+  histo->GetListOfFunctions()->Add(line); // not a decoration, it must be left alone
+
+  for (int cycle = 0; cycle < 100; cycle++) {
+    auto* msg = getDecoration<TPaveText>(&mo, "msg", 0.5, 0.5, 0.9, 0.75, "NDC");
+    BOOST_REQUIRE(msg != nullptr);
+    msg->Clear();
+    msg->AddText(Form("cycle %d", cycle));
+    getDecoration<TLine>(&mo, "threshold")->SetY1(cycle);
+  }
+  BOOST_CHECK_EQUAL(histo->GetListOfFunctions()->GetEntries(), 3);
+  auto* msg = dynamic_cast<TPaveText*>(decorations::find(histo, "msg"));
+  BOOST_REQUIRE(msg != nullptr);
+  BOOST_CHECK_EQUAL(msg->GetSize(), 1);
+  BOOST_CHECK(decorations::isDecoration(msg));
+  BOOST_CHECK(!decorations::isDecoration(line));
+
+  // a decoration of another type under the same name is replaced
+  BOOST_CHECK(getDecoration<TLine>(&mo, "msg") != nullptr);
+  BOOST_CHECK_EQUAL(histo->GetListOfFunctions()->GetEntries(), 3);
+
+  BOOST_CHECK(decorations::remove(histo, "threshold"));
+  BOOST_CHECK(!decorations::remove(histo, "threshold"));
+  BOOST_CHECK_EQUAL(histo->GetListOfFunctions()->GetEntries(), 2);
+
+  BOOST_CHECK_EQUAL(decorations::strip(histo), 1u);
+  BOOST_CHECK_EQUAL(histo->GetListOfFunctions()->GetEntries(), 1);
+  BOOST_CHECK_EQUAL(histo->GetListOfFunctions()->First(), line);
+}
+
+BOOST_AUTO_TEST_CASE(decorations_objects)
+{
+  auto* graph = new TGraph();
+  MonitorObject moGraph(graph, "task");
+  BOOST_CHECK(getDecoration<TPaveText>(&moGraph, "msg", 0.3, 0.8, 0.7, 0.95, "NDC") != nullptr);
+  BOOST_CHECK_EQUAL(graph->GetListOfFunctions()->GetEntries(), 1);
+  BOOST_CHECK_EQUAL(decorations::strip(graph), 1u);
+
+  auto* named = new TNamed("named", "named");
+  MonitorObject moNamed(named, "task");
+  BOOST_CHECK(getDecoration<TPaveText>(&moNamed, "msg") == nullptr);
+  BOOST_CHECK(setDecoration(&moNamed, "msg", new TLine()) == nullptr);
+  BOOST_CHECK_EQUAL(decorations::strip(named), 0u);
+
+  BOOST_CHECK_EQUAL(decorations::getId("msg"), decorations::getId("msg"));
+  BOOST_CHECK_NE(decorations::getId("msg"), decorations::getId("threshold"));
+}
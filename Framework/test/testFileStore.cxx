@@ -0,0 +1,294 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testFileStore.cxx
+///
+
+#include "QualityControl/FileStore.h"
+#include "TestTemporaryDirectory.h"
+
+#define BOOST_TEST_MODULE FileStore test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <atomic>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace o2::quality_control::repository;
+
+namespace
+{
+SerializedObject makeObject(const std::string& path, long from, long to, char value = 'x', size_t size = 100)
+{
+  SerializedObject object;
+  object.path = path;
+  object.metadata = { { "quality", "1" }, { "from", std::to_string(from) } };
+  object.validFrom = from;
+  object.validTo = to;
+  object.fileName = "object_" + std::to_string(from) + ".root";
+  object.content.assign(size, value);
+  return object;
+}
+
+// the value of the content of the version found, 0 if none is
+char found(const FileStore& store, const std::string& path, long timestamp)
+{
+  SerializedObject object;
+  return store.find(path, timestamp, object) ? object.content.at(0) : 0;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(file_store_find)
+{
+  TestTemporaryDirectory directory("qc_file_store");
+  FileStore store(directory.path, 1024, 3); // the index is rewritten after the third version
+  BOOST_REQUIRE(store.append(makeObject("qc/TST/task/a", 100, 1000, 'a')));
+  BOOST_REQUIRE(store.append(makeObject("qc/TST/task/a", 200, 300, 'b')));
+  BOOST_REQUIRE(store.append(makeObject("qc/TST/task/b", 150, 1000, 'c')));
+  BOOST_CHECK_EQUAL(store.getNumberOfVersions(), 3);
+
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 50), 0);
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 100), 'a');
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 250), 'b');
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 300), 'a'); // the later one has expired
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 1000), 0);
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/b", 999), 'c');
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task", 500), 0);
+
+  // the versions stored later with the same start replace the previous ones, in the index and before
+  BOOST_REQUIRE(store.append(makeObject("qc/TST/task/a", 200, 300, 'd')));
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 250), 'd');
+
+  SerializedObject object;
+  BOOST_REQUIRE(store.find("qc/TST/task/b", 500, object));
+  auto expected = makeObject("qc/TST/task/b", 150, 1000, 'c');
+  BOOST_CHECK_EQUAL(object.path, expected.path);
+  BOOST_CHECK(object.metadata == expected.metadata);
+  BOOST_CHECK_EQUAL(object.validFrom, expected.validFrom);
+  BOOST_CHECK_EQUAL(object.validTo, expected.validTo);
+  BOOST_CHECK_EQUAL(object.fileName, expected.fileName);
+  BOOST_CHECK(object.content == expected.content);
+}
+
+BOOST_AUTO_TEST_CASE(file_store_list_and_remove)
+{
+  TestTemporaryDirectory directory("qc_file_store");
+  FileStore store(directory.path, 1024, 52); // several segments, the index is rewritten once
+  for (long i = 0; i < 50; i++) {
+    BOOST_REQUIRE(store.append(makeObject("qc/TST/task/a", i * 10, 100000, 'a' + i % 20)));
+    BOOST_REQUIRE(store.append(makeObject("qc/TST/task/b", i * 10, 100000)));
+  }
+  BOOST_CHECK(store.paths() == std::vector<std::string>({ "qc/TST/task/a", "qc/TST/task/b" }));
+  BOOST_CHECK(store.paths("qc/TST/task/b") == std::vector<std::string>({ "qc/TST/task/b" }));
+  BOOST_CHECK(store.paths("qc/OTHER").empty());
+
+  auto versions = store.list("qc/TST/task/a", 100, 300);
+  BOOST_REQUIRE_EQUAL(versions.size(), 21);
+  for (size_t i = 0; i < versions.size(); i++) {
+    BOOST_CHECK_EQUAL(versions[i].validFrom, 100 + 10 * i);
+    BOOST_CHECK_EQUAL(versions[i].metadata.at("from"), std::to_string(100 + 10 * i));
+  }
+  SerializedObject object;
+  BOOST_REQUIRE(store.read(versions[3], object));
+  BOOST_CHECK_EQUAL(object.validFrom, 130);
+  BOOST_CHECK_EQUAL(object.content.at(0), 'a' + 13);
+
+  BOOST_REQUIRE(store.remove("qc/TST/task/a"));
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 200), 0);
+  BOOST_CHECK(store.list("qc/TST/task/a", 0, 1000).empty());
+  BOOST_CHECK(store.paths() == std::vector<std::string>({ "qc/TST/task/b" }));
+  BOOST_CHECK_EQUAL(store.list("qc/TST/task/b", 0, 1000).size(), 50);
+
+  // the versions stored after the removal are kept
+  BOOST_REQUIRE(store.append(makeObject("qc/TST/task/a", 10, 100000, 'z')));
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 200), 'z');
+  BOOST_REQUIRE(store.flush());
+  BOOST_CHECK_EQUAL(store.getNumberOfVersions(), 101); // until the index is rewritten
+}
+
+BOOST_AUTO_TEST_CASE(file_store_flush)
+{
+  TestTemporaryDirectory directory("qc_file_store");
+  std::string index = directory.path + "/g1/index";
+  {
+    FileStore store(directory.path);
+    BOOST_REQUIRE(store.append(makeObject("qc/TST/task/a", 0, 1000, 'a')));
+    // the appended versions are on the disk, the index is rewritten only when the store is closed
+    BOOST_REQUIRE(store.flush());
+    BOOST_CHECK(!boost::filesystem::exists(index));
+  }
+  BOOST_REQUIRE(boost::filesystem::exists(index));
+  auto written = boost::filesystem::last_write_time(index);
+  boost::filesystem::last_write_time(index, written - 100);
+  {
+    // nothing changed, the index is left as it is
+    FileStore store(directory.path);
+    BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 500), 'a');
+    BOOST_REQUIRE(store.flush());
+  }
+  BOOST_CHECK_EQUAL(boost::filesystem::last_write_time(index), written - 100);
+}
+
+BOOST_AUTO_TEST_CASE(file_store_reopen)
+{
+  TestTemporaryDirectory directory("qc_file_store");
+  {
+    FileStore store(directory.path, 4096, 7); // the index is rewritten every 7 versions
+    for (long i = 0; i < 30; i++) {
+      store.append(makeObject("qc/TST/task/a", i * 10, i * 10 + 10, 'a' + i));
+    }
+    store.remove("qc/TST/task/b");
+    store.append(makeObject("qc/TST/task/b", 0, 1000, 'b'));
+    store.remove("qc/TST/task/b");
+    // only one process at a time
+    BOOST_CHECK_THROW(FileStore(directory.path), std::runtime_error);
+  }
+
+  FileStore store(directory.path);
+  BOOST_CHECK_EQUAL(store.getNumberOfVersions(), 30);
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 125), 'a' + 12);
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/b", 10), 0);
+  BOOST_CHECK(store.paths() == std::vector<std::string>({ "qc/TST/task/a" }));
+}
+
+BOOST_AUTO_TEST_CASE(file_store_recovery)
+{
+  TestTemporaryDirectory directory("qc_file_store");
+  std::string index = directory.path + "/g1/index";
+  {
+    FileStore store(directory.path, 4096, 1); // the index is rewritten after each version
+    store.append(makeObject("qc/TST/task/a", 0, 1000, 'a'));
+    boost::filesystem::copy_file(index, index + ".first");
+    store.append(makeObject("qc/TST/task/a", 100, 1000, 'b'));
+    store.append(makeObject("qc/TST/task/a", 200, 1000, 'c'));
+  }
+  // a crash after the first version was indexed, while writing the last one
+  BOOST_REQUIRE_EQUAL(rename((index + ".first").c_str(), index.c_str()), 0);
+  std::string segment = directory.path + "/g1/00000001.seg";
+  int fd = open(segment.c_str(), O_RDONLY);
+  off_t size = lseek(fd, 0, SEEK_END);
+  close(fd);
+  BOOST_REQUIRE_EQUAL(truncate(segment.c_str(), size - 10), 0);
+
+  {
+    FileStore store(directory.path);
+    BOOST_CHECK_EQUAL(store.getNumberOfVersions(), 2);
+    BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 150), 'b');
+    BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 250), 'b');
+    BOOST_REQUIRE(store.append(makeObject("qc/TST/task/a", 300, 1000, 'd')));
+  }
+
+  // a corrupted index is rebuilt from the segments
+  BOOST_REQUIRE_EQUAL(truncate(index.c_str(), 70), 0);
+  FileStore store(directory.path);
+  BOOST_CHECK_EQUAL(store.getNumberOfVersions(), 3);
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 350), 'd');
+}
+
+BOOST_AUTO_TEST_CASE(file_store_recovery_of_corrupted_records)
+{
+  TestTemporaryDirectory directory("qc_file_store");
+  {
+    FileStore store(directory.path, 1000); // 5 versions per segment
+    for (long i = 0; i < 20; i++) {
+      store.append(makeObject("qc/TST/task/a", i * 10, i * 10 + 10, 'a' + i));
+    }
+  }
+  BOOST_REQUIRE_EQUAL(unlink((directory.path + "/g1/index").c_str()), 0);
+  auto segmentSize = [&](const std::string& name) { return boost::filesystem::file_size(directory.path + "/g1/" + name); };
+  auto corrupt = [&](const std::string& name, off_t offset) {
+    int fd = open((directory.path + "/g1/" + name).c_str(), O_WRONLY);
+    BOOST_REQUIRE_EQUAL(pwrite(fd, "!", 1, offset), 1);
+    close(fd);
+  };
+  // the content of the first version of the first segment, the header of the first version of the second one
+  corrupt("00000001.seg", 150);
+  corrupt("00000002.seg", 0);
+  auto size = segmentSize("00000002.seg");
+
+  // only the corrupted versions are lost, the segments before the last one are not truncated
+  FileStore store(directory.path);
+  BOOST_CHECK_EQUAL(store.getNumberOfVersions(), 18);
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 5), 0);
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 15), 'b');
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 55), 0);
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 65), 'g');
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 195), 'a' + 19);
+  BOOST_CHECK_EQUAL(segmentSize("00000002.seg"), size);
+}
+
+BOOST_AUTO_TEST_CASE(file_store_concurrent_readers)
+{
+  TestTemporaryDirectory directory("qc_file_store");
+  FileStore store(directory.path, 64 * 1024, 100);
+  for (long i = 0; i < 100; i++) {
+    store.append(makeObject("qc/TST/task/" + std::to_string(i % 10), i, 1000000, 'a' + i % 10));
+  }
+
+  std::atomic<bool> stop = false;
+  std::atomic<int> errors = 0;
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; r++) {
+    readers.emplace_back([&]() {
+      while (!stop) {
+        for (int p = 0; p < 10; p++) {
+          if (found(store, "qc/TST/task/" + std::to_string(p), 500000) != 'a' + p) {
+            errors++;
+          }
+        }
+      }
+    });
+  }
+  // the index is rewritten several times meanwhile
+  for (long i = 100; i < 1000; i++) {
+    store.append(makeObject("qc/TST/task/" + std::to_string(i % 10), i, 1000000, 'a' + i % 10));
+  }
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  BOOST_CHECK_EQUAL(errors, 0);
+  BOOST_CHECK_EQUAL(store.getNumberOfVersions(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(file_store_compaction)
+{
+  TestTemporaryDirectory directory("qc_file_store");
+  uint64_t sizeBefore = 0;
+  {
+    FileStore store(directory.path, 2048);
+    for (long i = 0; i < 20; i++) {
+      store.append(makeObject("qc/TST/task/a", i * 10, 100000, 'a' + i));
+      store.append(makeObject("qc/TST/task/b", i * 10, 100000, 'a' + i));
+    }
+    store.append(makeObject("qc/TST/task/c", 0, 100000, 'c'));
+    store.remove("qc/TST/task/c");
+    sizeBefore = store.getSize();
+    // not while the directory is used
+    BOOST_CHECK(!FileStore::compact(directory.path, 3, 150));
+  }
+
+  // the 3 latest versions are kept, and the ones starting at 150 or later
+  BOOST_REQUIRE(FileStore::compact(directory.path, 3, 150));
+  FileStore store(directory.path);
+  BOOST_CHECK_LT(store.getSize(), sizeBefore);
+  BOOST_CHECK_EQUAL(store.getNumberOfVersions(), 10);
+  BOOST_CHECK(store.paths() == std::vector<std::string>({ "qc/TST/task/a", "qc/TST/task/b" }));
+  BOOST_CHECK_EQUAL(store.list("qc/TST/task/a", 0, 100000).front().validFrom, 150);
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/b", 175), 'a' + 17);
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/b", 100), 0);
+  BOOST_CHECK_EQUAL(access((directory.path + "/g1").c_str(), F_OK), -1);
+  BOOST_REQUIRE(store.append(makeObject("qc/TST/task/a", 500, 100000, 'z')));
+  BOOST_CHECK_EQUAL(found(store, "qc/TST/task/a", 600), 'z');
+}
@@ -0,0 +1,239 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testHistoMerger.cxx
+///
+
+#include "QualityControl/HistoMerger.h"
+
+#define BOOST_TEST_MODULE HistoMerger test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <map>
+#include <set>
+#include <thread>
+#include <TH1F.h>
+#include <TObjArray.h>
+
+using namespace o2::quality_control::core;
+using SubSpecificationType = o2::header::DataHeader::SubSpecificationType;
+
+namespace
+{
+// an array as published by a task, with one entry in each histogram
+std::unique_ptr<TObjArray> makeArray(const std::vector<std::string>& names, const std::string& contributors = "")
+{
+  auto array = std::make_unique<TObjArray>();
+  array->SetOwner(true);
+  for (const auto& name : names) {
+    auto* histo = new TH1F(name.c_str(), name.c_str(), 10, 0, 10);
+    histo->SetDirectory(nullptr);
+    histo->Fill(5);
+    auto* mo = new MonitorObject(histo, "task");
+    if (!contributors.empty()) {
+      mo->addMetadata("contributors", contributors);
+    }
+    array->Add(mo);
+  }
+  return array;
+}
+
+// the published objects by name
+std::map<std::string, MonitorObject*> byName(const TObjArray& published)
+{
+  std::map<std::string, MonitorObject*> objects;
+  for (int i = 0; i <= published.GetLast(); i++) {
+    auto* mo = dynamic_cast<MonitorObject*>(published.At(i));
+    BOOST_REQUIRE(mo != nullptr);
+    objects[mo->getName()] = mo;
+  }
+  return objects;
+}
+
+double entries(const MonitorObject* mo) { return dynamic_cast<TH1*>(mo->getObject())->GetEntries(); }
+
+std::string contributors(const MonitorObject* mo) { return mo->getMetadataMap().at("contributors"); }
+
+HistoMerger makeMerger(double cycleDeadline)
+{
+  HistoMerger merger("merger");
+  merger.setCycleDeadline(cycleDeadline);
+  merger.configureInputsOutputs(o2::header::DataOrigin{ "TST" }, o2::header::DataDescription{ "HISTOS" }, { 1, 3 });
+  return merger;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(merger_contributors_parsing)
+{
+  using Contributors = std::set<SubSpecificationType>;
+  BOOST_CHECK(HistoMerger::parseContributors("1,2,30") == Contributors({ 1, 2, 30 }));
+  BOOST_CHECK(HistoMerger::parseContributors("").empty());
+  BOOST_CHECK(HistoMerger::parseContributors("1,x,-2,3a,,99999999999,4") == Contributors({ 1, 4 }));
+
+  // the objects without a valid list are counted for the producer which sent them
+  auto merger = makeMerger(10);
+  merger.receive(*makeArray({ "a" }, "x,y"), 2);
+  merger.receive(*makeArray({ "a" }, "5,z"), 3);
+  merger.mergeReceived();
+  auto published = byName(*merger.preparePublication());
+  BOOST_REQUIRE_EQUAL(published.size(), 1);
+  BOOST_CHECK_EQUAL(contributors(published["a"]), "2,5");
+  BOOST_CHECK_EQUAL(entries(published["a"]), 2);
+}
+
+BOOST_AUTO_TEST_CASE(merger_cycle_all_producers)
+{
+  auto merger = makeMerger(10);
+  BOOST_CHECK(!merger.isPublicationTime()); // nothing received
+  merger.receive(*makeArray({ "a" }), 1);
+  merger.receive(*makeArray({ "a" }), 2);
+  merger.mergeReceived();
+  BOOST_CHECK(!merger.isPublicationTime());
+
+  // published as soon as all the producers contributed, before the deadline
+  merger.receive(*makeArray({ "a" }), 3);
+  merger.mergeReceived();
+  BOOST_CHECK(merger.isPublicationTime());
+  auto published = byName(*merger.preparePublication());
+  BOOST_CHECK_EQUAL(contributors(published["a"]), "1,2,3");
+  BOOST_CHECK_EQUAL(published["a"]->getMetadataMap().at("numberOfContributors"), "3");
+  BOOST_CHECK_EQUAL(entries(published["a"]), 3);
+  BOOST_CHECK(!merger.isPublicationTime()); // the next cycle starts with the next input
+}
+
+BOOST_AUTO_TEST_CASE(merger_cycle_deadline)
+{
+  auto merger = makeMerger(0.2);
+  merger.receive(*makeArray({ "a" }), 1);
+  merger.receive(*makeArray({ "a" }), 2);
+  merger.mergeReceived();
+  BOOST_CHECK(!merger.isPublicationTime());
+
+  // what arrived is published once the deadline is over
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  BOOST_CHECK(merger.isPublicationTime());
+  auto published = byName(*merger.preparePublication());
+  BOOST_CHECK_EQUAL(contributors(published["a"]), "1,2");
+  BOOST_CHECK_EQUAL(entries(published["a"]), 2);
+
+  // the late producer is counted in the next cycle, which it starts
+  merger.receive(*makeArray({ "a" }), 3);
+  merger.mergeReceived();
+  BOOST_CHECK(!merger.isPublicationTime());
+  merger.receive(*makeArray({ "a" }), 1);
+  merger.receive(*makeArray({ "a" }), 2);
+  merger.mergeReceived();
+  BOOST_CHECK(merger.isPublicationTime());
+  published = byName(*merger.preparePublication());
+  BOOST_CHECK_EQUAL(contributors(published["a"]), "1,2,3");
+  BOOST_CHECK_EQUAL(entries(published["a"]), 5);
+}
+
+BOOST_AUTO_TEST_CASE(merger_objects_of_some_producers)
+{
+  HistoMerger merger("merger");
+  merger.receive(*makeArray({ "a", "b" }), 1);
+  merger.receive(*makeArray({ "b", "c" }), 2);
+  merger.receive(*makeArray({ "c" }), 3);
+  merger.mergeReceived();
+
+  // each object is merged among the producers which have it
+  auto published = byName(*merger.preparePublication());
+  BOOST_REQUIRE_EQUAL(published.size(), 3);
+  BOOST_CHECK_EQUAL(entries(published["a"]), 1);
+  BOOST_CHECK_EQUAL(contributors(published["a"]), "1");
+  BOOST_CHECK_EQUAL(entries(published["b"]), 2);
+  BOOST_CHECK_EQUAL(contributors(published["b"]), "1,2");
+  BOOST_CHECK_EQUAL(entries(published["c"]), 2);
+  BOOST_CHECK_EQUAL(contributors(published["c"]), "2,3");
+
+  // an object appearing later starts its own merged object
+  merger.receive(*makeArray({ "a", "d" }), 3);
+  merger.mergeReceived();
+  published = byName(*merger.preparePublication());
+  BOOST_REQUIRE_EQUAL(published.size(), 4);
+  BOOST_CHECK_EQUAL(entries(published["a"]), 2);
+  BOOST_CHECK_EQUAL(entries(published["d"]), 1);
+  BOOST_CHECK_EQUAL(contributors(published["d"]), "3");
+}
+
+BOOST_AUTO_TEST_CASE(merger_objects_expiry)
+{
+  HistoMerger merger("merger");
+  merger.setObjectsLifetime(0.2);
+  merger.receive(*makeArray({ "a", "b", "c", "d" }), 1);
+  merger.mergeReceived();
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  merger.receive(*makeArray({ "b", "d" }), 1);
+  merger.mergeReceived();
+
+  // "a" is replaced by the last one, "d", and "c" is then the last one
+  auto published = byName(*merger.preparePublication());
+  BOOST_REQUIRE_EQUAL(published.size(), 2);
+  BOOST_CHECK_EQUAL(entries(published["b"]), 2);
+  BOOST_CHECK_EQUAL(entries(published["d"]), 2);
+
+  // the moved objects are still found by their names
+  merger.receive(*makeArray({ "d", "b", "a" }), 1);
+  merger.receive(*makeArray({ "d" }), 2);
+  merger.mergeReceived();
+  published = byName(*merger.preparePublication());
+  BOOST_REQUIRE_EQUAL(published.size(), 3);
+  BOOST_CHECK_EQUAL(entries(published["b"]), 3);
+  BOOST_CHECK_EQUAL(entries(published["d"]), 4);
+  BOOST_CHECK_EQUAL(contributors(published["d"]), "1,2");
+  BOOST_CHECK_EQUAL(entries(published["a"]), 1);
+}
+
+BOOST_AUTO_TEST_CASE(merger_publish_only_updated)
+{
+  HistoMerger merger("merger");
+  merger.setPublishOnlyUpdated(true);
+  merger.receive(*makeArray({ "a", "b" }), 1);
+  merger.mergeReceived();
+  BOOST_CHECK_EQUAL(byName(*merger.preparePublication()).size(), 2);
+
+  merger.receive(*makeArray({ "a" }), 1);
+  merger.mergeReceived();
+  auto published = byName(*merger.preparePublication());
+  BOOST_REQUIRE_EQUAL(published.size(), 1);
+  BOOST_CHECK_EQUAL(entries(published["a"]), 2);
+
+  // nothing received, nothing published
+  BOOST_CHECK(merger.preparePublication()->IsEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(merger_reset_after_publication)
+{
+  HistoMerger merger("merger");
+  merger.setResetAfterPublication(true);
+  merger.receive(*makeArray({ "a", "b" }), 1);
+  merger.receive(*makeArray({ "a" }), 2);
+  merger.mergeReceived();
+  auto first = merger.preparePublication();
+  BOOST_CHECK(first->IsOwner()); // the objects are handed over
+  auto published = byName(*first);
+  BOOST_REQUIRE_EQUAL(published.size(), 2);
+  BOOST_CHECK_EQUAL(entries(published["a"]), 2);
+
+  // the next cycle starts from an empty set
+  merger.receive(*makeArray({ "a" }), 1);
+  merger.mergeReceived();
+  auto second = merger.preparePublication();
+  published = byName(*second);
+  BOOST_REQUIRE_EQUAL(published.size(), 1);
+  BOOST_CHECK_EQUAL(entries(published["a"]), 1);
+  BOOST_CHECK_EQUAL(contributors(published["a"]), "1");
+  BOOST_CHECK(merger.preparePublication()->IsEmpty());
+}
@@ -107,3 +107,37 @@ BOOST_AUTO_TEST_CASE(qc_factory_remote_test)
     });
   BOOST_CHECK(checkerAbcTask != workflow.end());
 }
+
+BOOST_AUTO_TEST_CASE(qc_factory_merger_tree_test)
+{
+  BOOST_CHECK(InfrastructureGenerator::computeMergersTopology(250, 0, 0) == std::vector<size_t>({ 1 }));
+  BOOST_CHECK(InfrastructureGenerator::computeMergersTopology(250, 16, 0) == std::vector<size_t>({ 16, 1 }));
+  BOOST_CHECK(InfrastructureGenerator::computeMergersTopology(250, 0, 2) == std::vector<size_t>({ 16, 1 }));
+  BOOST_CHECK(InfrastructureGenerator::computeMergersTopology(10, 3, 0) == std::vector<size_t>({ 4, 2, 1 }));
+  BOOST_CHECK(InfrastructureGenerator::computeMergersTopology(0, 3, 0).empty());
+
+  WorkflowSpec workflow;
+  InfrastructureGenerator::generateMergers(workflow, "tree-merger", "TST", "HISTO", 10, { 4, 2, 1 });
+  BOOST_REQUIRE_EQUAL(workflow.size(), 7);
+
+  // every producer and every merger output is consumed by exactly one merger
+  std::vector<int> consumers(10 + 4 + 2 + 1, 0);
+  for (const auto& merger : workflow) {
+    for (const auto& input : merger.inputs) {
+      consumers[DataSpecUtils::asConcreteDataMatcher(input).subSpec]++;
+    }
+  }
+  BOOST_CHECK_EQUAL(consumers[0], 0);
+  for (size_t subSpec = 1; subSpec < consumers.size(); subSpec++) {
+    BOOST_CHECK_EQUAL(consumers[subSpec], 1);
+  }
+
+  BOOST_CHECK_EQUAL(workflow[0].name, "tree-merger-0-0");
+  BOOST_CHECK_EQUAL(workflow[0].inputs.size(), 2);
+  BOOST_CHECK_EQUAL(DataSpecUtils::getOptionalSubSpec(workflow[0].outputs[0]).value_or(-1), 11);
+  BOOST_CHECK_EQUAL(workflow[4].name, "tree-merger-1-0");
+  BOOST_CHECK_EQUAL(DataSpecUtils::asConcreteDataMatcher(workflow[4].inputs[0]).subSpec, 11);
+  BOOST_CHECK_EQUAL(workflow[6].name, "tree-merger");
+  BOOST_CHECK_EQUAL(workflow[6].inputs.size(), 2);
+  BOOST_CHECK_EQUAL(DataSpecUtils::getOptionalSubSpec(workflow[6].outputs[0]).value_or(-1), 0);
+}
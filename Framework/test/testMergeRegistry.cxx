@@ -0,0 +1,207 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testMergeRegistry.cxx
+///
+
+#include "QualityControl/HistogramAdd.h"
+#include "QualityControl/MergeRegistry.h"
+#include "QualityControl/Mergeable.h"
+
+#define BOOST_TEST_MODULE MergeRegistry test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <TClass.h>
+#include <TGraph.h>
+#include <TH1F.h>
+#include <TH2F.h>
+#include <TH3D.h>
+#include <THnSparse.h>
+#include <TObjString.h>
+#include <TProfile.h>
+#include <TRandom3.h>
+#include <TTree.h>
+
+using namespace o2::quality_control::core;
+
+namespace
+{
+class Counter : public TObject, public Mergeable
+{
+ public:
+  explicit Counter(int value = 0) : mValue(value) {}
+  bool merge(const TObject* other) override
+  {
+    auto* otherCounter = dynamic_cast<const Counter*>(other);
+    if (otherCounter == nullptr) {
+      return false;
+    }
+    mValue += otherCounter->mValue;
+    return true;
+  }
+  int mValue;
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(merge_histograms)
+{
+  MergeRegistry registry;
+
+  TH1F h1("h1", "h1", 10, 0, 10), h1Other("h1o", "h1o", 10, 0, 10);
+  h1.Fill(1);
+  h1Other.Fill(1);
+  h1Other.Fill(5);
+  BOOST_CHECK(registry.merge(&h1, &h1Other));
+  BOOST_CHECK_EQUAL(h1.GetBinContent(2), 2);
+  BOOST_CHECK_EQUAL(h1.GetBinContent(6), 1);
+
+  TH2F h2("h2", "h2", 10, 0, 10, 10, 0, 10), h2Other("h2o", "h2o", 10, 0, 10, 10, 0, 10);
+  h2.Fill(1, 1);
+  h2Other.Fill(1, 1);
+  BOOST_CHECK(registry.merge(&h2, &h2Other));
+  BOOST_CHECK_EQUAL(h2.GetBinContent(2, 2), 2);
+
+  TH3D h3("h3", "h3", 5, 0, 5, 5, 0, 5, 5, 0, 5), h3Other("h3o", "h3o", 5, 0, 5, 5, 0, 5, 5, 0, 5);
+  h3Other.Fill(1, 2, 3);
+  BOOST_CHECK(registry.merge(&h3, &h3Other));
+  BOOST_CHECK_EQUAL(h3.GetBinContent(2, 3, 4), 1);
+
+  TProfile profile("p", "p", 10, 0, 10), profileOther("po", "po", 10, 0, 10);
+  profile.Fill(1, 2);
+  profileOther.Fill(1, 4);
+  BOOST_CHECK(registry.merge(&profile, &profileOther));
+  BOOST_CHECK_EQUAL(profile.GetBinContent(2), 3);
+
+  Int_t bins[2] = { 10, 10 };
+  Double_t mins[2] = { 0, 0 };
+  Double_t maxs[2] = { 10, 10 };
+  THnSparseF sparse("s", "s", 2, bins, mins, maxs), sparseOther("so", "so", 2, bins, mins, maxs);
+  Double_t point[2] = { 1, 1 };
+  sparse.Fill(point);
+  sparseOther.Fill(point);
+  BOOST_CHECK(registry.merge(&sparse, &sparseOther));
+  BOOST_CHECK_EQUAL(sparse.GetEntries(), 2);
+
+  // the strategy is resolved by class, once
+  BOOST_CHECK(registry.resolve(TH2F::Class()) != nullptr);
+  BOOST_CHECK_EQUAL(registry.resolve(TH2F::Class()), registry.resolve(TH1F::Class()));
+  // objects of different kinds are not merged
+  BOOST_CHECK(!registry.merge(&h1, &sparse));
+}
+
+BOOST_AUTO_TEST_CASE(merge_graphs_trees)
+{
+  MergeRegistry registry;
+
+  TGraph graph, graphOther;
+  graph.SetPoint(0, 1, 1);
+  graphOther.SetPoint(0, 2, 2);
+  graphOther.SetPoint(1, 3, 3);
+  BOOST_CHECK(registry.merge(&graph, &graphOther));
+  BOOST_CHECK_EQUAL(graph.GetN(), 3);
+
+  int value = 0;
+  TTree tree("tree", "tree");
+  tree.SetDirectory(nullptr);
+  tree.Branch("value", &value);
+  TTree treeOther("treeOther", "treeOther");
+  treeOther.SetDirectory(nullptr);
+  treeOther.Branch("value", &value);
+  tree.Fill();
+  treeOther.Fill();
+  treeOther.Fill();
+  BOOST_CHECK(registry.merge(&tree, &treeOther));
+  BOOST_CHECK_EQUAL(tree.GetEntries(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(merge_custom)
+{
+  MergeRegistry registry;
+
+  Counter counter(1), counterOther(2);
+  BOOST_CHECK(registry.merge(&counter, &counterOther));
+  BOOST_CHECK_EQUAL(counter.mValue, 3);
+
+  // objects which cannot be merged
+  TObjString string("a"), stringOther("b");
+  BOOST_CHECK(registry.resolve(&string) == nullptr);
+  BOOST_CHECK(!registry.merge(&string, &stringOther));
+
+  // custom strategy
+  registry.add("TObjString", [](TObject* target, TObject* other) {
+    static_cast<TObjString*>(target)->String() += static_cast<TObjString*>(other)->String();
+    return true;
+  });
+  BOOST_CHECK(registry.merge(&string, &stringOther));
+  BOOST_CHECK_EQUAL(string.String(), "ab");
+
+  // a registered strategy takes precedence over the default one
+  registry.add(TH1::Class(), [](TObject*, TObject*) { return false; });
+  TH1F h1("h1", "h1", 10, 0, 10), h1Other("h1o", "h1o", 10, 0, 10);
+  BOOST_CHECK(!registry.merge(&h1, &h1Other));
+}
+
+BOOST_AUTO_TEST_CASE(histograms_same_layout)
+{
+  TRandom3 random(42);
+  auto compare = [](const TH1& a, const TH1& b) {
+    BOOST_CHECK_EQUAL(a.GetEntries(), b.GetEntries());
+    BOOST_CHECK_CLOSE(a.GetMean(), b.GetMean(), 1e-9);
+    BOOST_CHECK_CLOSE(a.GetRMS(), b.GetRMS(), 1e-9);
+    for (int bin = 0; bin < a.GetNcells(); bin++) {
+      BOOST_REQUIRE_EQUAL(a.GetBinContent(bin), b.GetBinContent(bin));
+      BOOST_REQUIRE_CLOSE(a.GetBinError(bin), b.GetBinError(bin), 1e-4);
+    }
+  };
+
+  // with and without sumw2, in 1 and 2 dimensions
+  TH1F h1("h1", "h1", 100, -3, 3), h1Other("h1o", "h1o", 100, -3, 3);
+  h1.Sumw2();
+  h1.FillRandom("gaus", 1000);
+  h1Other.FillRandom("gaus", 500);
+  std::unique_ptr<TH1> h1Expected(dynamic_cast<TH1*>(h1.Clone("h1e")));
+  BOOST_CHECK(histograms::addSameLayout(h1, h1Other));
+  h1Expected->Add(&h1Other);
+  compare(h1, *h1Expected);
+
+  TH2I h2("h2", "h2", 20, 0, 1, 30, 0, 1), h2Other("h2o", "h2o", 20, 0, 1, 30, 0, 1);
+  for (int i = 0; i < 1000; i++) {
+    h2.Fill(random.Rndm(), random.Rndm());
+    h2Other.Fill(random.Rndm(), random.Rndm());
+  }
+  std::unique_ptr<TH1> h2Expected(dynamic_cast<TH1*>(h2.Clone("h2e")));
+  BOOST_CHECK(histograms::addSameLayout(h2, h2Other));
+  h2Expected->Add(&h2Other);
+  compare(h2, *h2Expected);
+
+  // not the same layout, TH1::Add is needed
+  TH1F h1Binning("h1b", "h1b", 50, -3, 3);
+  TH1F h1Labels("h1l", "h1l", 100, -3, 3);
+  h1Labels.Fill("a", 1);
+  TH1D h1Double("h1d", "h1d", 100, -3, 3);
+  TProfile profile("p", "p", 100, -3, 3), profileOther("po", "po", 100, -3, 3);
+  BOOST_CHECK(!histograms::haveSameLayout(h1, h1Binning));
+  BOOST_CHECK(!histograms::haveSameLayout(h1, h1Labels));
+  BOOST_CHECK(!histograms::haveSameLayout(h1, h1Double));
+  BOOST_CHECK(!histograms::haveSameLayout(profile, profileOther));
+  BOOST_CHECK(!histograms::addSameLayout(h1, h1Binning));
+  compare(h1, *h1Expected);
+
+  // the other histogram has sumw2, the target not
+  TH1F noSumw2("ns", "ns", 100, -3, 3);
+  BOOST_CHECK(!histograms::addSameLayout(noSumw2, h1));
+
+  MergeRegistry registry;
+  BOOST_CHECK(registry.merge(&h1, &h1Double)); // falls back to TH1::Add
+}
@@ -14,6 +14,7 @@
 ///
 
 #include "QualityControl/ObjectsManager.h"
+#include "QualityControl/SparseHistogram.h"
 
 #define BOOST_TEST_MODULE ObjectManager test
 #define BOOST_TEST_MAIN
@@ -100,6 +101,41 @@ BOOST_AUTO_TEST_CASE(getters_test)
   BOOST_CHECK_NO_THROW(objectsManager.getMonitorObject("histo"));
 }
 
+BOOST_AUTO_TEST_CASE(sparse_test)
+{
+  TaskConfig config;
+  config.taskName = "test";
+  ObjectsManager objectsManager(config);
+
+  TObjString s("content");
+  TH1F h("histo", "h", 100, 0, 99);
+  h.Fill(10);
+  objectsManager.startPublishing(&s);
+  objectsManager.startPublishing(&h);
+  objectsManager.setSparse("histo");
+  objectsManager.setSparse("content"); // not a histogram, published as it is
+  BOOST_CHECK_THROW(objectsManager.setSparse("unexisting object"), ObjectNotFoundError);
+
+  // the array carries a copy of the MonitorObject with the sparse histogram, the task keeps the dense one
+  std::unique_ptr<TObjArray> array(objectsManager.getNonOwningArray());
+  BOOST_REQUIRE_EQUAL(array->GetEntries(), 2);
+  auto* content = dynamic_cast<MonitorObject*>(array->FindObject("content"));
+  BOOST_REQUIRE(content != nullptr);
+  BOOST_CHECK_EQUAL(content->getObject(), &s);
+  auto* histo = dynamic_cast<MonitorObject*>(array->FindObject("histo"));
+  BOOST_REQUIRE(histo != nullptr);
+  BOOST_CHECK_NE(histo, objectsManager.getMonitorObject("histo"));
+  auto* sparse = dynamic_cast<SparseHistogram*>(histo->getObject());
+  BOOST_REQUIRE(sparse != nullptr);
+  BOOST_CHECK_EQUAL(sparse->getNumberOfFilledBins(), 1);
+  BOOST_CHECK_EQUAL(sparse->getEntries(), 1);
+  BOOST_CHECK_EQUAL(objectsManager.getObject("histo"), &h);
+
+  objectsManager.setSparse("histo", false);
+  array.reset(objectsManager.getNonOwningArray());
+  BOOST_CHECK_EQUAL(array->FindObject("histo"), objectsManager.getMonitorObject("histo"));
+}
+
 BOOST_AUTO_TEST_CASE(metadata_test)
 {
   TaskConfig config;
@@ -0,0 +1,80 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    testQualityTree.cxx
+///
+
+#include "QualityControl/QualityTree.h"
+#include <Common/Exceptions.h>
+
+#define BOOST_TEST_MODULE QualityTree test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace o2::quality_control::core
+{
+
+BOOST_AUTO_TEST_CASE(quality_tree_aggregation)
+{
+  QualityTree tree;
+  BOOST_CHECK_EQUAL(tree.getQuality("global"), Quality::Null);
+
+  auto changed = tree.update({ "TPC", "clusters", "histo1" }, Quality::Good);
+  BOOST_CHECK_EQUAL(changed.size(), 3);
+  BOOST_CHECK_EQUAL(changed[0], "global/TPC/clusters");
+  BOOST_CHECK_EQUAL(changed[2], "global");
+  BOOST_CHECK_EQUAL(tree.getQuality("global"), Quality::Good);
+  BOOST_CHECK_EQUAL(tree.getQuality("global/TPC/clusters/histo1"), Quality::Good);
+
+  changed = tree.update({ "TPC", "clusters", "histo2" }, Quality::Bad);
+  BOOST_CHECK_EQUAL(changed.size(), 3);
+  BOOST_CHECK_EQUAL(tree.getQuality("global/TPC"), Quality::Bad);
+
+  // does not change anything above the task, the task is Bad anyway
+  changed = tree.update({ "TPC", "clusters", "histo1" }, Quality::Medium);
+  BOOST_CHECK(changed.empty());
+
+  changed = tree.update({ "ITS", "hits", "histo" }, Quality::Medium);
+  BOOST_REQUIRE_EQUAL(changed.size(), 2);
+  BOOST_CHECK_EQUAL(changed[1], "global/ITS");
+  BOOST_CHECK_EQUAL(tree.getQuality("global"), Quality::Bad);
+
+  // the Bad object recovers, the worst remaining is Medium
+  changed = tree.update({ "TPC", "clusters", "histo2" }, Quality::Good);
+  BOOST_CHECK_EQUAL(changed.size(), 3);
+  BOOST_CHECK_EQUAL(tree.getQuality("global/TPC/clusters"), Quality::Medium);
+  BOOST_CHECK_EQUAL(tree.getQuality("global"), Quality::Medium);
+
+  // the same quality again is a no-op
+  BOOST_CHECK(tree.update({ "TPC", "clusters", "histo2" }, Quality::Good).empty());
+  BOOST_CHECK_EQUAL(tree.size(), 8);
+}
+
+BOOST_AUTO_TEST_CASE(quality_tree_null)
+{
+  QualityTree tree("root");
+  tree.update({ "task", "histo1" }, Quality::Good);
+  tree.update({ "task", "histo2" }, Quality::Null);
+  // Null is ignored as long as there are other qualities
+  BOOST_CHECK_EQUAL(tree.getQuality("root/task"), Quality::Good);
+
+  tree.update({ "task", "histo1" }, Quality::Null);
+  BOOST_CHECK_EQUAL(tree.getQuality("root/task"), Quality::Null);
+  BOOST_CHECK_EQUAL(tree.getQuality("root"), Quality::Null);
+
+  BOOST_CHECK_THROW(tree.getQuality("root/nothing"), AliceO2::Common::ObjectNotFoundError);
+}
+
+} // namespace o2::quality_control::core
@@ -0,0 +1,125 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testSparseHistogram.cxx
+///
+
+#include "QualityControl/MergeRegistry.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/SparseHistogram.h"
+
+#define BOOST_TEST_MODULE SparseHistogram test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <TBufferFile.h>
+#include <TH1F.h>
+#include <TH2F.h>
+#include <TProfile.h>
+
+using namespace o2::quality_control::core;
+
+namespace
+{
+void checkSameHistograms(const TH1& expected, const TH1& actual)
+{
+  BOOST_CHECK_EQUAL(expected.IsA(), actual.IsA());
+  BOOST_CHECK_EQUAL(std::string(expected.GetName()), std::string(actual.GetName()));
+  BOOST_REQUIRE_EQUAL(expected.GetNcells(), actual.GetNcells());
+  BOOST_CHECK_EQUAL(expected.GetSumw2N(), actual.GetSumw2N());
+  for (int bin = 0; bin < expected.GetNcells(); bin++) {
+    BOOST_REQUIRE_EQUAL(expected.GetBinContent(bin), actual.GetBinContent(bin));
+    BOOST_REQUIRE_CLOSE(expected.GetBinError(bin), actual.GetBinError(bin), 1e-9);
+  }
+  BOOST_CHECK_EQUAL(expected.GetEntries(), actual.GetEntries());
+  BOOST_CHECK_CLOSE(expected.GetMean(1), actual.GetMean(1), 1e-9);
+  BOOST_CHECK_CLOSE(expected.GetMean(2), actual.GetMean(2), 1e-9);
+  BOOST_CHECK_CLOSE(expected.GetRMS(1), actual.GetRMS(1), 1e-9);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(sparse_histogram_round_trip)
+{
+  TH2F dense("map", "map", 100, 0, 100, 2000, 0, 2000);
+  dense.Fill(5.5, 10.5);
+  dense.Fill(5.5, 10.5);
+  dense.Fill(99.5, 1999.5, 3);
+  dense.Fill(-1, 500); // underflow
+
+  auto sparse = SparseHistogram::fromHistogram(dense);
+  BOOST_REQUIRE(sparse != nullptr);
+  BOOST_CHECK_EQUAL(sparse->getNumberOfFilledBins(), 3);
+  BOOST_CHECK_EQUAL(sparse->getHistogramClass(), "TH2F");
+
+  // the sparse form is much smaller than the dense one once serialized
+  TBufferFile denseBuffer(TBuffer::kWrite);
+  denseBuffer.WriteObject(&dense);
+  TBufferFile sparseBuffer(TBuffer::kWrite);
+  sparseBuffer.WriteObject(sparse.get());
+  BOOST_CHECK_LT(sparseBuffer.Length() * 100, denseBuffer.Length());
+
+  std::unique_ptr<TH1> densified(sparse->densify());
+  BOOST_REQUIRE(densified != nullptr);
+  checkSameHistograms(dense, *densified);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_histogram_merge)
+{
+  TH1F a("histo", "histo", 100, 0, 100);
+  TH1F b("histo", "histo", 100, 0, 100);
+  b.Sumw2();
+  a.Fill(1);
+  a.Fill(50);
+  b.Fill(50, 2);
+  b.Fill(70);
+  auto sparseA = SparseHistogram::fromHistogram(a);
+  auto sparseB = SparseHistogram::fromHistogram(b);
+
+  // the mergers resolve it as any Mergeable
+  MergeRegistry registry;
+  BOOST_REQUIRE(registry.merge(sparseA.get(), sparseB.get()));
+  BOOST_CHECK_EQUAL(sparseA->getNumberOfFilledBins(), 3);
+
+  a.Add(&b);
+  std::unique_ptr<TH1> merged(sparseA->densify());
+  checkSameHistograms(a, *merged);
+
+  TH1F otherBinning("histo", "histo", 50, 0, 100);
+  otherBinning.Fill(1);
+  BOOST_CHECK(!sparseA->merge(SparseHistogram::fromHistogram(otherBinning).get()));
+  BOOST_CHECK(!sparseA->merge(&a));
+}
+
+BOOST_AUTO_TEST_CASE(sparse_histogram_unsupported)
+{
+  TProfile profile("profile", "profile", 10, 0, 10);
+  BOOST_CHECK(SparseHistogram::fromHistogram(profile) == nullptr);
+
+  // the alphanumeric bins are merged by label, they could not be merged as sparse bins
+  TH1F labelled("labelled", "labelled", 3, 0, 3);
+  labelled.Fill("a", 1);
+  BOOST_CHECK(SparseHistogram::fromHistogram(labelled) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_histogram_densify_monitor_object)
+{
+  TH1F histo("histo", "histo", 10, 0, 10);
+  histo.Fill(3);
+  MonitorObject mo(SparseHistogram::fromHistogram(histo).release(), "task");
+  BOOST_REQUIRE(SparseHistogram::densify(mo));
+  auto* densified = dynamic_cast<TH1F*>(mo.getObject());
+  BOOST_REQUIRE(densified != nullptr);
+  BOOST_CHECK_EQUAL(densified->GetBinContent(4), 1);
+  BOOST_CHECK(mo.isIsOwner());
+  BOOST_CHECK(!SparseHistogram::densify(mo));
+}
@@ -0,0 +1,219 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testSpool.cxx
+///
+
+#include "QualityControl/Spool.h"
+#include "TestTemporaryDirectory.h"
+
+#define BOOST_TEST_MODULE Spool test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace o2::quality_control::repository;
+
+namespace
+{
+SerializedObject makeObject(int i, size_t size = 100)
+{
+  SerializedObject object;
+  object.path = "qc/TST/task/object" + std::to_string(i);
+  object.metadata = { { "quality", "1" }, { "run", std::to_string(i) } };
+  object.validFrom = 1000 + i;
+  object.validTo = 2000 + i;
+  object.fileName = "object" + std::to_string(i) + ".root";
+  object.content.assign(size, static_cast<char>(i));
+  return object;
+}
+
+// collects the objects sent by the replay, failing the first ones and the ones above the capacity if asked to, and
+// rejecting the ones with the rejected path
+struct Receiver {
+  std::mutex mutex;
+  std::vector<SerializedObject> objects;
+  int failures = 0;
+  size_t capacity = SIZE_MAX;
+  std::string rejected;
+  int attempts = 0;
+
+  std::function<Spool::SendResult(const SerializedObject&)> send()
+  {
+    return [this](const SerializedObject& object) {
+      std::lock_guard<std::mutex> lock(mutex);
+      attempts++;
+      if (object.path == rejected) {
+        return Spool::SendResult::Rejected;
+      }
+      if (failures > 0) {
+        failures--;
+        return Spool::SendResult::Retry;
+      }
+      if (objects.size() >= capacity) {
+        return Spool::SendResult::Retry;
+      }
+      objects.push_back(object);
+      return Spool::SendResult::Sent;
+    };
+  }
+
+  size_t size()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return objects.size();
+  }
+};
+
+bool waitUntilEmpty(const Spool& spool)
+{
+  for (int i = 0; i < 500 && !spool.empty(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return spool.empty();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(spool_replay_in_order)
+{
+  TestTemporaryDirectory directory("qc_spool");
+  Spool spool(directory.path, 1024 * 1024, 1000);
+  for (int i = 0; i < 20; i++) {
+    BOOST_REQUIRE(spool.append(makeObject(i)));
+  }
+  BOOST_CHECK_EQUAL(spool.getNumberOfObjects(), 20);
+  BOOST_CHECK_GT(spool.getSize(), 20 * 100);
+
+  Receiver receiver;
+  receiver.failures = 2;
+  spool.startReplay(receiver.send(), 0, std::chrono::milliseconds(1));
+  BOOST_REQUIRE(waitUntilEmpty(spool));
+  spool.stopReplay();
+
+  BOOST_REQUIRE_EQUAL(receiver.objects.size(), 20);
+  for (int i = 0; i < 20; i++) {
+    auto expected = makeObject(i);
+    BOOST_CHECK_EQUAL(receiver.objects[i].path, expected.path);
+    BOOST_CHECK(receiver.objects[i].metadata == expected.metadata);
+    BOOST_CHECK_EQUAL(receiver.objects[i].validFrom, expected.validFrom);
+    BOOST_CHECK_EQUAL(receiver.objects[i].validTo, expected.validTo);
+    BOOST_CHECK_EQUAL(receiver.objects[i].fileName, expected.fileName);
+    BOOST_CHECK(receiver.objects[i].content == expected.content);
+  }
+  BOOST_CHECK_EQUAL(spool.getSize(), 0);
+  BOOST_CHECK_EQUAL(spool.getOldestAge().count(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(spool_restart)
+{
+  TestTemporaryDirectory directory("qc_spool");
+  {
+    Spool spool(directory.path, 1024 * 1024, 1000);
+    for (int i = 0; i < 10; i++) {
+      spool.append(makeObject(i));
+    }
+    // the database goes down again after 4 objects
+    Receiver receiver;
+    receiver.capacity = 4;
+    spool.startReplay(receiver.send(), 0, std::chrono::seconds(10));
+    while (spool.getNumberOfObjects() > 6) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    spool.stopReplay();
+  }
+
+  // the next process continues after the objects already sent
+  Spool spool(directory.path, 1024 * 1024, 1000);
+  BOOST_REQUIRE_EQUAL(spool.getNumberOfObjects(), 6);
+  spool.append(makeObject(10));
+
+  Receiver receiver;
+  spool.startReplay(receiver.send(), 0);
+  BOOST_REQUIRE(waitUntilEmpty(spool));
+  spool.stopReplay();
+  BOOST_REQUIRE_EQUAL(receiver.objects.size(), 7);
+  BOOST_CHECK_EQUAL(receiver.objects.front().path, makeObject(4).path);
+  BOOST_CHECK_EQUAL(receiver.objects.back().path, makeObject(10).path);
+}
+
+BOOST_AUTO_TEST_CASE(spool_incomplete_record)
+{
+  TestTemporaryDirectory directory("qc_spool");
+  {
+    Spool spool(directory.path, 1024 * 1024);
+    spool.append(makeObject(0));
+    spool.append(makeObject(1));
+  }
+  // a crash while writing the last record
+  std::string segment = directory.path + "/00000000000000000001.spool";
+  int fd = open(segment.c_str(), O_RDONLY);
+  off_t size = lseek(fd, 0, SEEK_END);
+  close(fd);
+  BOOST_REQUIRE_EQUAL(truncate(segment.c_str(), size - 10), 0);
+
+  Spool spool(directory.path, 1024 * 1024);
+  BOOST_CHECK_EQUAL(spool.getNumberOfObjects(), 1);
+  Receiver receiver;
+  spool.startReplay(receiver.send(), 0);
+  BOOST_REQUIRE(waitUntilEmpty(spool));
+  spool.stopReplay();
+  BOOST_REQUIRE_EQUAL(receiver.objects.size(), 1);
+  BOOST_CHECK(receiver.objects[0].content == makeObject(0).content);
+}
+
+BOOST_AUTO_TEST_CASE(spool_max_size)
+{
+  TestTemporaryDirectory directory("qc_spool");
+  Spool spool(directory.path, 2500);
+  BOOST_CHECK(spool.append(makeObject(0, 1000)));
+  BOOST_CHECK(spool.append(makeObject(1, 1000)));
+  BOOST_CHECK(!spool.append(makeObject(2, 1000)));
+  BOOST_CHECK_EQUAL(spool.getNumberOfObjects(), 2);
+  BOOST_CHECK_GE(spool.getOldestAge().count(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(spool_quarantine)
+{
+  TestTemporaryDirectory directory("qc_spool");
+  std::string quarantine = directory.path + "/quarantine";
+  Spool spool(directory.path, 1024 * 1024);
+  for (int i = 0; i < 5; i++) {
+    spool.append(makeObject(i));
+  }
+
+  // a refused object does not hold the ones after it
+  Receiver receiver;
+  receiver.rejected = makeObject(1).path;
+  spool.startReplay(receiver.send(), 0, std::chrono::milliseconds(1));
+  BOOST_REQUIRE(waitUntilEmpty(spool));
+  spool.stopReplay();
+  BOOST_REQUIRE_EQUAL(receiver.objects.size(), 4);
+  BOOST_CHECK_EQUAL(receiver.objects[1].path, makeObject(2).path);
+  BOOST_CHECK_EQUAL(receiver.attempts, 5);
+  auto quarantined = boost::filesystem::file_size(quarantine);
+  BOOST_CHECK_GT(quarantined, 100);
+
+  // neither does one which cannot be sent after the given number of attempts
+  spool.append(makeObject(5));
+  spool.append(makeObject(6));
+  Receiver failing;
+  failing.failures = 3;
+  spool.startReplay(failing.send(), 0, std::chrono::milliseconds(1), 3);
+  BOOST_REQUIRE(waitUntilEmpty(spool));
+  spool.stopReplay();
+  BOOST_REQUIRE_EQUAL(failing.objects.size(), 1);
+  BOOST_CHECK_EQUAL(failing.objects[0].path, makeObject(6).path);
+  BOOST_CHECK_GT(boost::filesystem::file_size(quarantine), quarantined);
+}
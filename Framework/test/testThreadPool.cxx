@@ -0,0 +1,63 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testThreadPool.cxx
+///
+
+#include "QualityControl/ThreadPool.h"
+
+#define BOOST_TEST_MODULE ThreadPool test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <stdexcept>
+
+using namespace o2::quality_control::core;
+
+BOOST_AUTO_TEST_CASE(thread_pool_parallel_for)
+{
+  ThreadPool pool(4);
+  BOOST_CHECK_EQUAL(pool.size(), 4);
+
+  std::vector<int> calls(10000, 0);
+  for (int repetition = 0; repetition < 10; repetition++) {
+    pool.parallelFor(calls.size(), [&calls](size_t i) { calls[i]++; });
+  }
+  for (auto c : calls) {
+    BOOST_REQUIRE_EQUAL(c, 10);
+  }
+
+  std::atomic<int> single{ 0 };
+  pool.parallelFor(1, [&single](size_t) { single++; });
+  pool.parallelFor(0, [&single](size_t) { single++; });
+  BOOST_CHECK_EQUAL(single, 1);
+
+  BOOST_CHECK_THROW(pool.parallelFor(1000, [](size_t i) { if (i == 500) throw std::runtime_error("failed"); }),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_submit)
+{
+  std::atomic<int> done{ 0 };
+  {
+    ThreadPool pool(2);
+    auto future = pool.submit([&done] { done++; });
+    future.get();
+    BOOST_CHECK_EQUAL(done, 1);
+    BOOST_CHECK_THROW(pool.submit([] { throw std::runtime_error("failed"); }).get(), std::runtime_error);
+    for (int i = 0; i < 100; i++) {
+      pool.submit([&done] { done++; });
+    }
+  } // the pending tasks are done before the threads are joined
+  BOOST_CHECK_EQUAL(done, 101);
+}
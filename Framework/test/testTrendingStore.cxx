@@ -0,0 +1,90 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    testTrendingStore.cxx
+///
+
+#include "QualityControl/TrendingStore.h"
+#include "TestTemporaryDirectory.h"
+
+#define BOOST_TEST_MODULE TrendingStore test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+using namespace std;
+
+namespace o2::quality_control::core
+{
+
+BOOST_AUTO_TEST_CASE(trending_store_append_query)
+{
+  TestTemporaryDirectory directory("qc_trending");
+  string series = "TST/task/histo/mean";
+  {
+    TrendingStore store(directory.path, 10);
+    for (int i = 0; i < 25; i++) {
+      store.append(series, 1000 + i, i < 15 ? 1 : 2, i * 0.5);
+    }
+    // two full blocks were written, 5 values are still in the buffer, but they are queried as well
+    auto all = store.query(series, 0, 10000);
+    BOOST_REQUIRE_EQUAL(all.size(), 25);
+    BOOST_CHECK_EQUAL(all[24].value, 12);
+
+    auto range = store.query(series, 1005, 1012);
+    BOOST_REQUIRE_EQUAL(range.size(), 8);
+    BOOST_CHECK_EQUAL(range.front().timestamp, 1005);
+    BOOST_CHECK_EQUAL(range.back().timestamp, 1012);
+
+    auto run2 = store.query(series, 0, 10000, 2);
+    BOOST_CHECK_EQUAL(run2.size(), 10);
+  }
+
+  // the values should have been flushed on destruction and be readable again
+  {
+    TrendingStore store(directory.path, 10);
+    BOOST_CHECK_EQUAL(store.query(series, 0, 10000).size(), 25);
+    BOOST_CHECK_EQUAL(store.query(series, 0, 10000, 1).size(), 15);
+    BOOST_CHECK(store.query("TST/task/histo/nothing", 0, 10000).empty());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(trending_store_broken_block)
+{
+  TestTemporaryDirectory directory("qc_trending");
+  string series = "TST/task/histo/entries";
+  string path;
+  {
+    TrendingStore store(directory.path, 4);
+    path = store.getFilePath(series);
+    for (int i = 0; i < 8; i++) {
+      store.append(series, i, 1, i);
+    }
+  }
+  // simulate a crash in the middle of writing a block
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    out.write("QCTB-garbage", 12);
+  }
+  {
+    TrendingStore store(directory.path, 4);
+    BOOST_CHECK_EQUAL(store.query(series, 0, 100).size(), 8);
+    store.append(series, 8, 1, 8);
+  }
+  {
+    TrendingStore store(directory.path, 4);
+    BOOST_CHECK_EQUAL(store.query(series, 0, 100).size(), 9);
+  }
+}
+
+} // namespace o2::quality_control::core
@@ -0,0 +1,88 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testVersionCache.cxx
+///
+
+#include "QualityControl/VersionCache.h"
+
+#define BOOST_TEST_MODULE VersionCache test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::repository;
+
+namespace
+{
+std::shared_ptr<const CachedVersion> makeVersion(const std::string& etag, long from, long until, size_t size = 10)
+{
+  return std::make_shared<CachedVersion>(CachedVersion{ etag, from, until, std::string(size, 'x') });
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(version_cache_find)
+{
+  VersionCache cache(1024 * 1024);
+  cache.insert("qc/TST/task/a", makeVersion("a1", 100, 200));
+  cache.insert("qc/TST/task/a", makeVersion("a2", 200, 300));
+  cache.insert("qc/TST/task/b", makeVersion("b1", 150, 1000));
+  BOOST_CHECK_EQUAL(cache.getNumberOfVersions(), 3);
+
+  BOOST_CHECK(cache.find("qc/TST/task/a", 50) == nullptr);
+  BOOST_CHECK_EQUAL(cache.find("qc/TST/task/a", 100)->etag, "a1");
+  BOOST_CHECK_EQUAL(cache.find("qc/TST/task/a", 199)->etag, "a1");
+  BOOST_CHECK_EQUAL(cache.find("qc/TST/task/a", 250)->etag, "a2");
+  BOOST_CHECK(cache.find("qc/TST/task/a", 300) == nullptr);
+  BOOST_CHECK_EQUAL(cache.find("qc/TST/task/b", 900)->etag, "b1");
+  BOOST_CHECK(cache.find("qc/TST/task", 900) == nullptr);
+  BOOST_CHECK(cache.find("qc/TST/task/c", 900) == nullptr);
+
+  // a new version with the same validity replaces the previous one
+  cache.insert("qc/TST/task/a", makeVersion("a3", 200, 300));
+  BOOST_CHECK_EQUAL(cache.find("qc/TST/task/a", 250)->etag, "a3");
+  BOOST_CHECK_EQUAL(cache.getNumberOfVersions(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(version_cache_eviction)
+{
+  VersionCache cache(3000);
+  cache.insert("a", makeVersion("a", 0, 100, 1000));
+  cache.insert("b", makeVersion("b", 0, 100, 1000));
+  BOOST_CHECK(cache.find("a", 10) != nullptr); // "b" becomes the least recently used
+  cache.insert("c", makeVersion("c", 0, 100, 1000));
+
+  BOOST_CHECK(cache.find("a", 10) != nullptr);
+  BOOST_CHECK(cache.find("b", 10) == nullptr);
+  BOOST_CHECK(cache.find("c", 10) != nullptr);
+  BOOST_CHECK_LE(cache.getSize(), 3000);
+
+  // too large to be cached
+  cache.insert("d", makeVersion("d", 0, 100, 5000));
+  BOOST_CHECK(cache.find("d", 10) == nullptr);
+  BOOST_CHECK_EQUAL(cache.getNumberOfVersions(), 2);
+
+  cache.setMaxSize(0);
+  BOOST_CHECK_EQUAL(cache.getNumberOfVersions(), 0);
+  BOOST_CHECK_EQUAL(cache.getSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(version_cache_statistics)
+{
+  VersionCache cache(1024);
+  BOOST_CHECK_EQUAL(cache.getHitRatio(), 0);
+  cache.countHit();
+  cache.countHit();
+  cache.countHit();
+  cache.countMiss();
+  BOOST_CHECK_CLOSE(cache.getHitRatio(), 0.75, 1e-9);
+}
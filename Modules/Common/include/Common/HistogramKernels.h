@@ -0,0 +1,551 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   HistogramKernels.h
+///
+
+#ifndef QC_MODULE_COMMON_HISTOGRAMKERNELS_H
+#define QC_MODULE_COMMON_HISTOGRAMKERNELS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+// ROOT
+#include <TArrayC.h>
+#include <TArrayD.h>
+#include <TArrayF.h>
+#include <TArrayI.h>
+#include <TArrayS.h>
+#include <TH1.h>
+#include <TMath.h>
+
+/// \brief Statistics computed directly on the bin arrays of histograms.
+///
+/// The checks typically need a handful of numbers out of large histograms (integrals, number of empty bins,
+/// maximum...). TH1 computes them bin by bin through virtual GetBinContent() calls. The kernels below run over
+/// the contiguous arrays backing the histograms instead. The loops use independent accumulators and no
+/// branches so that the compiler can vectorize them for the target instruction set.
+///
+/// The bin type is resolved at compile time when the concrete histogram class is known (TH1F, TH2I, ...),
+/// otherwise once per call through the TArray base of the histogram. A histogram without such a base is read
+/// through the TH1 API into a temporary array.
+namespace o2::quality_control_modules::common::kernels
+{
+
+/// Number of independent accumulators used by the reductions.
+constexpr size_t Lanes = 8;
+
+/// \brief Sum of data[0..n).
+template <typename T>
+double sum(const T* data, size_t n)
+{
+  double acc[Lanes] = {};
+  size_t i = 0;
+  for (; i + Lanes <= n; i += Lanes) {
+    for (size_t l = 0; l < Lanes; ++l) {
+      acc[l] += data[i + l];
+    }
+  }
+  for (; i < n; ++i) {
+    acc[0] += data[i];
+  }
+  double total = 0;
+  for (double a : acc) {
+    total += a;
+  }
+  return total;
+}
+
+/// \brief Number of elements of data[0..n) equal to 0.
+template <typename T>
+size_t countEmpty(const T* data, size_t n)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < n; ++i) {
+    count += (data[i] == 0);
+  }
+  return count;
+}
+
+/// \brief Number of elements of data[0..n) strictly above the threshold.
+template <typename T, typename V>
+size_t countAbove(const T* data, size_t n, V threshold)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < n; ++i) {
+    count += (data[i] > threshold);
+  }
+  return count;
+}
+
+/// \brief Index of the first maximum of data[0..n), 0 if n is 0.
+template <typename T>
+size_t maxIndex(const T* data, size_t n)
+{
+  if (n == 0) {
+    return 0;
+  }
+  T lanes[Lanes];
+  for (size_t l = 0; l < Lanes; ++l) {
+    lanes[l] = data[0];
+  }
+  size_t i = 0;
+  for (; i + Lanes <= n; i += Lanes) {
+    for (size_t l = 0; l < Lanes; ++l) {
+      lanes[l] = data[i + l] > lanes[l] ? data[i + l] : lanes[l];
+    }
+  }
+  T maximum = lanes[0];
+  for (size_t l = 1; l < Lanes; ++l) {
+    maximum = lanes[l] > maximum ? lanes[l] : maximum;
+  }
+  for (; i < n; ++i) {
+    maximum = data[i] > maximum ? data[i] : maximum;
+  }
+  // second pass to get the first occurrence, it stops early
+  for (i = 0; i < n && data[i] != maximum; ++i) {
+  }
+  return i;
+}
+
+/// \brief Weighted moments of a distribution, in the units of the positions which were used to compute them.
+struct Moments {
+  double sumw = 0;
+  double sumwx = 0;
+  double sumwx2 = 0;
+
+  double mean() const { return sumw == 0 ? 0 : sumwx / sumw; }
+  double rms() const
+  {
+    if (sumw == 0) {
+      return 0;
+    }
+    double m = mean();
+    double variance = sumwx2 / sumw - m * m;
+    return variance > 0 ? std::sqrt(variance) : 0;
+  }
+};
+
+/// \brief Moments of data[0..n), the position of element i being x0 + i * dx.
+template <typename T>
+Moments moments(const T* data, size_t n, double x0, double dx)
+{
+  double w[Lanes] = {}, wi[Lanes] = {}, wi2[Lanes] = {};
+  size_t i = 0;
+  for (; i + Lanes <= n; i += Lanes) {
+    for (size_t l = 0; l < Lanes; ++l) {
+      double content = data[i + l];
+      double index = static_cast<double>(i + l);
+      w[l] += content;
+      wi[l] += content * index;
+      wi2[l] += content * index * index;
+    }
+  }
+  for (; i < n; ++i) {
+    double content = data[i];
+    double index = static_cast<double>(i);
+    w[0] += content;
+    wi[0] += content * index;
+    wi2[0] += content * index * index;
+  }
+  // moments in units of indices, converted afterwards so that the loop stays simple
+  double sw = 0, swi = 0, swi2 = 0;
+  for (size_t l = 0; l < Lanes; ++l) {
+    sw += w[l];
+    swi += wi[l];
+    swi2 += wi2[l];
+  }
+  Moments result;
+  result.sumw = sw;
+  result.sumwx = x0 * sw + dx * swi;
+  result.sumwx2 = x0 * x0 * sw + 2 * x0 * dx * swi + dx * dx * swi2;
+  return result;
+}
+
+/// \brief Sums of the chi2 test of compatibility of two unweighted distributions.
+struct Chi2Sums {
+  double sum = 0;      ///< sum of (sumB * a_i - sumA * b_i)^2 / (a_i + b_i)
+  size_t nonEmpty = 0; ///< number of elements where a_i + b_i > 0
+};
+
+/// \brief Adds the terms of the chi2 test of a[0..n) and b[0..n) with totals sumA and sumB to the sums.
+/// The contents are expected to be positive, elements empty in both distributions do not contribute.
+template <typename T, typename U>
+void chi2(const T* a, const U* b, size_t n, double sumA, double sumB, Chi2Sums& sums)
+{
+  double acc[Lanes] = {};
+  size_t nonEmpty = 0;
+  size_t i = 0;
+  for (; i + Lanes <= n; i += Lanes) {
+    for (size_t l = 0; l < Lanes; ++l) {
+      double ai = a[i + l], bi = b[i + l];
+      double total = ai + bi;
+      double diff = sumB * ai - sumA * bi;
+      // diff is 0 when total is, dividing by 1 instead avoids a branch
+      acc[l] += diff * diff / (total + (total == 0));
+      nonEmpty += (total != 0);
+    }
+  }
+  for (; i < n; ++i) {
+    double ai = a[i], bi = b[i];
+    double total = ai + bi;
+    double diff = sumB * ai - sumA * bi;
+    acc[0] += diff * diff / (total + (total == 0));
+    nonEmpty += (total != 0);
+  }
+  for (double value : acc) {
+    sums.sum += value;
+  }
+  sums.nonEmpty += nonEmpty;
+}
+
+/// \brief Maximum distance between the cumulative distributions of a[0..n) and b[0..n) with totals sumA and sumB.
+template <typename T, typename U>
+double maxCumulativeDistance(const T* a, const U* b, size_t n, double sumA, double sumB)
+{
+  // prefix sums are sequential by nature, at least the loop runs on the arrays without virtual calls
+  double cumulativeA = 0, cumulativeB = 0, distance = 0;
+  const double scaleA = 1. / sumA, scaleB = 1. / sumB;
+  for (size_t i = 0; i < n; ++i) {
+    cumulativeA += a[i] * scaleA;
+    cumulativeB += b[i] * scaleB;
+    double d = std::fabs(cumulativeA - cumulativeB);
+    distance = d > distance ? d : distance;
+  }
+  return distance;
+}
+
+/// \brief Counts of the comparison of the ratios of two distributions with bounds.
+struct RatioCounts {
+  size_t compared = 0; ///< number of elements where the reference is above the minimum
+  size_t outside = 0;  ///< number of compared elements with a ratio outside of the bounds
+};
+
+/// \brief Compares a_i * scale / b_i with [minRatio, maxRatio] where b_i > minReference (minReference >= 0).
+template <typename T, typename U>
+void countRatiosOutside(const T* a, const U* b, size_t n, double scale, double minRatio, double maxRatio,
+                        double minReference, RatioCounts& counts)
+{
+  size_t compared = 0, outside = 0;
+  for (size_t i = 0; i < n; ++i) {
+    double reference = b[i];
+    bool used = reference > minReference;
+    double ratio = a[i] * scale / (used ? reference : 1.);
+    compared += used;
+    outside += used & ((ratio < minRatio) | (ratio > maxRatio));
+  }
+  counts.compared += compared;
+  counts.outside += outside;
+}
+
+/// \brief Calls f(const T* bins, size_t size) with the bin array of the histogram and its element type.
+///
+/// The array type is resolved at compile time for the concrete histogram classes, at runtime for TH1 and the
+/// other base classes.
+template <typename Histo, typename F>
+decltype(auto) visitBins(const Histo& histo, F&& f)
+{
+  if constexpr (std::is_base_of_v<TArrayD, Histo>) {
+    return f(static_cast<const TArrayD&>(histo).GetArray(), static_cast<size_t>(histo.GetNcells()));
+  } else if constexpr (std::is_base_of_v<TArrayF, Histo>) {
+    return f(static_cast<const TArrayF&>(histo).GetArray(), static_cast<size_t>(histo.GetNcells()));
+  } else if constexpr (std::is_base_of_v<TArrayI, Histo>) {
+    return f(static_cast<const TArrayI&>(histo).GetArray(), static_cast<size_t>(histo.GetNcells()));
+  } else if constexpr (std::is_base_of_v<TArrayS, Histo>) {
+    return f(static_cast<const TArrayS&>(histo).GetArray(), static_cast<size_t>(histo.GetNcells()));
+  } else if constexpr (std::is_base_of_v<TArrayC, Histo>) {
+    return f(static_cast<const TArrayC&>(histo).GetArray(), static_cast<size_t>(histo.GetNcells()));
+  } else {
+    static_assert(std::is_base_of_v<TH1, Histo>, "visitBins expects a histogram");
+    auto size = static_cast<size_t>(histo.GetNcells());
+    if (auto* array = dynamic_cast<const TArrayD*>(&histo)) {
+      return f(array->GetArray(), size);
+    } else if (auto* array = dynamic_cast<const TArrayF*>(&histo)) {
+      return f(array->GetArray(), size);
+    } else if (auto* array = dynamic_cast<const TArrayI*>(&histo)) {
+      return f(array->GetArray(), size);
+    } else if (auto* array = dynamic_cast<const TArrayS*>(&histo)) {
+      return f(array->GetArray(), size);
+    } else if (auto* array = dynamic_cast<const TArrayC*>(&histo)) {
+      return f(array->GetArray(), size);
+    }
+    // unknown storage (e.g. a user class), the contents are copied with the virtual calls the kernels avoid otherwise
+    std::vector<Double_t> contents(size);
+    for (size_t bin = 0; bin < size; ++bin) {
+      contents[bin] = histo.GetBinContent(static_cast<int>(bin));
+    }
+    return f(static_cast<const Double_t*>(contents.data()), size);
+  }
+}
+
+/// \brief Calls f(firstCell, lastCell) for each row of consecutive cells along X within [xFirst, xLast], and
+/// within the regular bins of the other axes (the under- and overflows of Y and Z are skipped).
+template <typename Histo, typename F>
+void forEachRow(const Histo& histo, int xFirst, int xLast, F&& f)
+{
+  const size_t rowLength = histo.GetNbinsX() + 2;
+  const bool hasY = histo.GetDimension() > 1;
+  const bool hasZ = histo.GetDimension() > 2;
+  const int yFirst = hasY ? 1 : 0, yLast = hasY ? histo.GetNbinsY() : 0;
+  const int zFirst = hasZ ? 1 : 0, zLast = hasZ ? histo.GetNbinsZ() : 0;
+  const size_t planeLength = rowLength * (hasY ? histo.GetNbinsY() + 2 : 1);
+  for (int z = zFirst; z <= zLast; ++z) {
+    for (int y = yFirst; y <= yLast; ++y) {
+      size_t rowStart = z * planeLength + y * rowLength;
+      f(rowStart + xFirst, rowStart + xLast);
+    }
+  }
+}
+
+/// \brief Sum of the bins [binFrom, binTo] along X, over the regular bins of the other axes.
+/// The range is clamped as TH1::Integral(binFrom, binTo) does for 1D histograms, it is 0 if the range is empty.
+template <typename Histo>
+double integral(const Histo& histo, int binFrom, int binTo)
+{
+  const int nbins = histo.GetNbinsX();
+  binFrom = binFrom < 0 ? 0 : binFrom;
+  binTo = (binTo >= nbins + 2 || binTo < binFrom) ? nbins + 1 : binTo;
+  if (binFrom > binTo) {
+    return 0;
+  }
+  return visitBins(histo, [&](const auto* bins, size_t size) {
+    double total = 0;
+    if (size == 0) {
+      return total;
+    }
+    forEachRow(histo, binFrom, binTo, [&](size_t first, size_t last) { total += sum(bins + first, last - first + 1); });
+    return total;
+  });
+}
+
+/// \brief Sum of the contents of the regular bins, i.e. TH1::Integral().
+template <typename Histo>
+double integral(const Histo& histo)
+{
+  return integral(histo, 1, histo.GetNbinsX());
+}
+
+/// \brief Number of regular bins with a content of exactly 0.
+template <typename Histo>
+size_t countEmptyBins(const Histo& histo)
+{
+  return visitBins(histo, [&](const auto* bins, size_t size) {
+    size_t count = 0;
+    if (size == 0) {
+      return count;
+    }
+    forEachRow(histo, 1, histo.GetNbinsX(), [&](size_t first, size_t last) { count += countEmpty(bins + first, last - first + 1); });
+    return count;
+  });
+}
+
+/// \brief Number of regular bins with a content strictly above the threshold.
+template <typename Histo>
+size_t countBinsAbove(const Histo& histo, double threshold)
+{
+  return visitBins(histo, [&](const auto* bins, size_t size) {
+    size_t count = 0;
+    if (size == 0) {
+      return count;
+    }
+    using BinType = std::remove_cv_t<std::remove_pointer_t<decltype(bins)>>;
+    if constexpr (std::is_integral_v<BinType>) {
+      // content > threshold <=> content > floor(threshold) for integers, it keeps the comparison in the bin type
+      double floored = std::floor(threshold);
+      if (floored >= static_cast<double>(std::numeric_limits<BinType>::max())) {
+        return count;
+      }
+      if (floored < static_cast<double>(std::numeric_limits<BinType>::lowest())) {
+        forEachRow(histo, 1, histo.GetNbinsX(), [&](size_t first, size_t last) { count += last - first + 1; });
+        return count;
+      }
+      auto t = static_cast<BinType>(floored);
+      forEachRow(histo, 1, histo.GetNbinsX(), [&](size_t first, size_t last) { count += countAbove(bins + first, last - first + 1, t); });
+    } else {
+      forEachRow(histo, 1, histo.GetNbinsX(), [&](size_t first, size_t last) { count += countAbove(bins + first, last - first + 1, threshold); });
+    }
+    return count;
+  });
+}
+
+/// \brief Global bin number of the first regular bin with the maximum content, as TH1::GetMaximumBin().
+template <typename Histo>
+int maximumBin(const Histo& histo)
+{
+  return visitBins(histo, [&](const auto* bins, size_t size) {
+    int best = 0;
+    if (size == 0) {
+      return best;
+    }
+    bool first = true;
+    std::remove_cv_t<std::remove_pointer_t<decltype(bins)>> maximum{};
+    forEachRow(histo, 1, histo.GetNbinsX(), [&](size_t begin, size_t last) {
+      size_t index = begin + maxIndex(bins + begin, last - begin + 1);
+      if (first || bins[index] > maximum) {
+        first = false;
+        maximum = bins[index];
+        best = static_cast<int>(index);
+      }
+    });
+    return best;
+  });
+}
+
+/// \brief Moments along X of a 1D histogram computed from the bin contents and the bin centers.
+///
+/// Unlike TH1::GetMean() and TH1::GetRMS(), it does not rely on the statistics accumulated at filling time,
+/// which are lost e.g. after TH1::SetBinContent() or when a histogram is rebuilt from its bins.
+template <typename Histo>
+Moments binnedMoments(const Histo& histo)
+{
+  const TAxis* axis = histo.GetXaxis();
+  const int nbins = histo.GetNbinsX();
+  return visitBins(histo, [&](const auto* bins, size_t size) {
+    Moments result;
+    if (size == 0 || nbins == 0) {
+      return result;
+    }
+    if (axis->GetXbins()->GetSize() == 0) { // fixed bins, the centers are linear in the bin number
+      return moments(bins + 1, nbins, axis->GetBinCenter(1), axis->GetBinWidth(1));
+    }
+    for (int bin = 1; bin <= nbins; ++bin) {
+      double content = bins[bin];
+      double center = axis->GetBinCenter(bin);
+      result.sumw += content;
+      result.sumwx += content * center;
+      result.sumwx2 += content * center * center;
+    }
+    return result;
+  });
+}
+
+/// \brief Returns true if the histograms have the same number of dimensions and the same bins on each axis.
+inline bool sameBinning(const TH1& a, const TH1& b)
+{
+  if (a.GetDimension() != b.GetDimension() || a.GetNcells() != b.GetNcells()) {
+    return false;
+  }
+  const TAxis* axesA[] = { a.GetXaxis(), a.GetYaxis(), a.GetZaxis() };
+  const TAxis* axesB[] = { b.GetXaxis(), b.GetYaxis(), b.GetZaxis() };
+  for (int axis = 0; axis < a.GetDimension(); axis++) {
+    const TArrayD* edgesA = axesA[axis]->GetXbins();
+    const TArrayD* edgesB = axesB[axis]->GetXbins();
+    if (axesA[axis]->GetNbins() != axesB[axis]->GetNbins() ||
+        axesA[axis]->GetXmin() != axesB[axis]->GetXmin() ||
+        axesA[axis]->GetXmax() != axesB[axis]->GetXmax() ||
+        edgesA->GetSize() != edgesB->GetSize() ||
+        !std::equal(edgesA->GetArray(), edgesA->GetArray() + edgesA->GetSize(), edgesB->GetArray())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \brief Calls f(const T* a, const U* b) with the bin arrays of two histograms with the same binning.
+template <typename HistoA, typename HistoB, typename F>
+decltype(auto) visitBins(const HistoA& a, const HistoB& b, F&& f)
+{
+  return visitBins(a, [&](const auto* binsA, size_t) {
+    return visitBins(b, [&](const auto* binsB, size_t) { return f(binsA, binsB); });
+  });
+}
+
+/// \brief Result of the chi2 test of two histograms.
+struct Chi2Result {
+  double chi2 = 0;
+  int ndf = 0;
+  double pValue = 0;
+};
+
+/// \brief Chi2 test of the compatibility of the shapes of two unweighted histograms with the same binning, over the
+/// regular bins. It gives the same results as TH1::Chi2Test(reference, "UU").
+template <typename Histo, typename Reference>
+Chi2Result chi2Test(const Histo& histo, const Reference& reference)
+{
+  Chi2Result result;
+  const double sumA = integral(histo), sumB = integral(reference);
+  if (sumA <= 0 || sumB <= 0) {
+    return result;
+  }
+  Chi2Sums sums;
+  visitBins(histo, reference, [&](const auto* a, const auto* b) {
+    if (a != nullptr && b != nullptr) {
+      forEachRow(histo, 1, histo.GetNbinsX(), [&](size_t first, size_t last) { chi2(a + first, b + first, last - first + 1, sumA, sumB, sums); });
+    }
+    return 0;
+  });
+  result.chi2 = sums.sum / (sumA * sumB);
+  result.ndf = static_cast<int>(sums.nonEmpty) - 1;
+  result.pValue = result.ndf > 0 ? TMath::Prob(result.chi2, result.ndf) : 0;
+  return result;
+}
+
+/// \brief Number of entries of the histogram as if it was unweighted, i.e. (sum w)^2 / (sum w^2).
+template <typename Histo>
+double effectiveEntries(const Histo& histo)
+{
+  const double sumw = integral(histo);
+  if (histo.GetSumw2N() == 0) {
+    return sumw;
+  }
+  double sumw2 = 0;
+  const double* errors = histo.GetSumw2()->GetArray();
+  forEachRow(histo, 1, histo.GetNbinsX(), [&](size_t first, size_t last) { sumw2 += sum(errors + first, last - first + 1); });
+  return sumw2 > 0 ? sumw * sumw / sumw2 : 0;
+}
+
+/// \brief Kolmogorov-Smirnov test of two 1D histograms with the same binning, over the regular bins. Returns the
+/// probability of compatibility as TH1::KolmogorovTest(reference) does.
+template <typename Histo, typename Reference>
+double kolmogorovTest(const Histo& histo, const Reference& reference)
+{
+  const double sumA = integral(histo), sumB = integral(reference);
+  if (sumA <= 0 || sumB <= 0) {
+    return 0;
+  }
+  const int nbins = histo.GetNbinsX();
+  double distance = visitBins(histo, reference, [&](const auto* a, const auto* b) {
+    return (a != nullptr && b != nullptr) ? maxCumulativeDistance(a + 1, b + 1, nbins, sumA, sumB) : 1.;
+  });
+  const double entriesA = effectiveEntries(histo), entriesB = effectiveEntries(reference);
+  return TMath::KolmogorovProb(distance * std::sqrt(entriesA * entriesB / (entriesA + entriesB)));
+}
+
+/// \brief Compares the ratios of the regular bins of two histograms with the same binning, once normalised to the
+/// same integral, with [minRatio, maxRatio]. Only the bins where the reference is above minReference are compared.
+template <typename Histo, typename Reference>
+RatioCounts binRatioTest(const Histo& histo, const Reference& reference, double minRatio, double maxRatio,
+                         double minReference = 0)
+{
+  RatioCounts counts;
+  const double sumA = integral(histo), sumB = integral(reference);
+  if (sumA <= 0 || sumB <= 0) {
+    return counts;
+  }
+  const double scale = sumB / sumA;
+  minReference = minReference < 0 ? 0 : minReference;
+  visitBins(histo, reference, [&](const auto* a, const auto* b) {
+    if (a != nullptr && b != nullptr) {
+      forEachRow(histo, 1, histo.GetNbinsX(), [&](size_t first, size_t last) {
+        countRatiosOutside(a + first, b + first, last - first + 1, scale, minRatio, maxRatio, minReference, counts);
+      });
+    }
+    return 0;
+  });
+  return counts;
+}
+
+} // namespace o2::quality_control_modules::common::kernels
+
+#endif // QC_MODULE_COMMON_HISTOGRAMKERNELS_H
@@ -5,4 +5,8 @@
 
 #pragma link C++ class o2::quality_control_modules::common::NonEmpty + ;
 #pragma link C++ class o2::quality_control_modules::common::MeanIsAbove + ;
+#pragma link C++ class o2::quality_control_modules::common::ReferenceComparison + ;
+#pragma link C++ class o2::quality_control_modules::common::ReferenceChi2 + ;
+#pragma link C++ class o2::quality_control_modules::common::ReferenceKolmogorov + ;
+#pragma link C++ class o2::quality_control_modules::common::ReferenceBinRatio + ;
 #endif
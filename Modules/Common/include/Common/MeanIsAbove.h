@@ -16,7 +16,7 @@
 #ifndef QC_MODULE_COMMON_MEANISABOVE_H
 #define QC_MODULE_COMMON_MEANISABOVE_H
 
-#include "QualityControl/CheckInterface.h"
+#include "QualityControl/TypedCheck.h"
 
 using namespace o2::quality_control::core;
 
@@ -26,7 +26,7 @@ namespace o2::quality_control_modules::common
 /// \brief  Check whether the mean of the plot is above a certain limit.
 ///
 /// \author Barthelemy von Haller
-class MeanIsAbove : public o2::quality_control::checker::CheckInterface
+class MeanIsAbove : public o2::quality_control::checker::TypedCheck<TH1>
 {
  public:
   /// Default constructor
@@ -35,9 +35,8 @@ class MeanIsAbove : public o2::quality_control::checker::CheckInterface
   ~MeanIsAbove() override = default;
 
   void configure(std::string name) override;
-  Quality check(const MonitorObject* mo) override;
-  void beautify(MonitorObject* mo, Quality checkResult) override;
-  std::string getAcceptedType() override;
+  Quality checkObject(const MonitorObject* mo, const TH1& histo) override;
+  void beautifyObject(MonitorObject* mo, TH1& histo, Quality checkResult) override;
 
  private:
   float mThreshold = 0.0f;
@@ -16,7 +16,7 @@
 #ifndef QC_MODULE_COMMON_NONEMPTY_H
 #define QC_MODULE_COMMON_NONEMPTY_H
 
-#include "QualityControl/CheckInterface.h"
+#include "QualityControl/TypedCheck.h"
 
 namespace o2::quality_control_modules::common
 {
@@ -24,7 +24,7 @@ namespace o2::quality_control_modules::common
 /// \brief  Check whether a plot is empty or not.
 ///
 /// \author Barthelemy von Haller
-class NonEmpty : public o2::quality_control::checker::CheckInterface
+class NonEmpty : public o2::quality_control::checker::TypedCheck<TH1>
 {
  public:
   /// Default constructor
@@ -33,9 +33,8 @@ class NonEmpty : public o2::quality_control::checker::CheckInterface
   ~NonEmpty() override = default;
 
   void configure(std::string name) override;
-  Quality check(const MonitorObject* mo) override;
-  void beautify(MonitorObject* mo, Quality checkResult) override;
-  std::string getAcceptedType() override;
+  Quality checkObject(const MonitorObject* mo, const TH1& histo) override;
+  void beautifyObject(MonitorObject* mo, TH1& histo, Quality checkResult) override;
 
   ClassDefOverride(NonEmpty, 1);
 };
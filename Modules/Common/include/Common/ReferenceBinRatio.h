@@ -0,0 +1,52 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ReferenceBinRatio.h
+///
+
+#ifndef QC_MODULE_COMMON_REFERENCEBINRATIO_H
+#define QC_MODULE_COMMON_REFERENCEBINRATIO_H
+
+#include "Common/ReferenceComparison.h"
+
+namespace o2::quality_control_modules::common
+{
+
+/// \brief  Compares the bins of the histogram with the ones of its reference, once normalised to the same integral.
+///
+/// Only the bins with a reference content above "minReferenceContent" (default 10) are compared. The quality is Bad
+/// if the fraction of bins with a ratio outside of ["minRatio", "maxRatio"] (default [0.8, 1.2]) is above
+/// "maxFractionOutside" (default 0.05), Good otherwise.
+class ReferenceBinRatio : public ReferenceComparison
+{
+ public:
+  /// Default constructor
+  ReferenceBinRatio() = default;
+  /// Destructor
+  ~ReferenceBinRatio() override = default;
+
+  void configure(std::string name) override;
+
+ protected:
+  Quality compare(const TH1& histo, const TH1& reference) override;
+
+ private:
+  double mMinRatio = 0.8;
+  double mMaxRatio = 1.2;
+  double mMinReferenceContent = 10;
+  double mMaxFractionOutside = 0.05;
+
+  ClassDefOverride(ReferenceBinRatio, 1)
+};
+
+} // namespace o2::quality_control_modules::common
+
+#endif /* QC_MODULE_COMMON_REFERENCEBINRATIO_H */
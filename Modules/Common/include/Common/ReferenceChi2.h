@@ -0,0 +1,48 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ReferenceChi2.h
+///
+
+#ifndef QC_MODULE_COMMON_REFERENCECHI2_H
+#define QC_MODULE_COMMON_REFERENCECHI2_H
+
+#include "Common/ReferenceComparison.h"
+
+namespace o2::quality_control_modules::common
+{
+
+/// \brief  Chi2 test of the compatibility of the shape of the histogram with its reference.
+///
+/// The histograms are expected to be unweighted. The quality is Bad if the p-value is below the parameter
+/// "minPValue" (default 0.05), Good otherwise.
+class ReferenceChi2 : public ReferenceComparison
+{
+ public:
+  /// Default constructor
+  ReferenceChi2() = default;
+  /// Destructor
+  ~ReferenceChi2() override = default;
+
+  void configure(std::string name) override;
+
+ protected:
+  Quality compare(const TH1& histo, const TH1& reference) override;
+
+ private:
+  double mMinPValue = 0.05;
+
+  ClassDefOverride(ReferenceChi2, 1)
+};
+
+} // namespace o2::quality_control_modules::common
+
+#endif /* QC_MODULE_COMMON_REFERENCECHI2_H */
@@ -0,0 +1,83 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ReferenceComparison.h
+///
+
+#ifndef QC_MODULE_COMMON_REFERENCECOMPARISON_H
+#define QC_MODULE_COMMON_REFERENCECOMPARISON_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "QualityControl/CheckInterface.h"
+
+class TH1;
+
+using namespace o2::quality_control::core;
+
+namespace o2::quality_control_modules::common
+{
+
+/// \brief  Base of the checks comparing histograms with reference histograms.
+///
+/// The references are retrieved from the QC repository, or else from the conditions database, at the path given by
+/// the parameter "referencePath" where "{detector}", "{task}" and "{object}" are replaced with those of the checked
+/// object (default: "qc/{detector}/{task}/{object}"). If the parameter "referenceRun" is set, the reference of this
+/// run is used (metadata repository::runMetadataKey), otherwise the latest one. The references are retrieved once and
+/// cached for the current activity. Missing references are cached as well, the objects without reference get a Null
+/// quality. The result of the comparison is displayed on the object in the decoration "reference_<check name>".
+///
+/// Derived classes implement the comparison itself on histograms with the same binning.
+class ReferenceComparison : public o2::quality_control::checker::CheckInterface
+{
+ public:
+  /// Default constructor
+  ReferenceComparison() = default;
+  /// Destructor
+  ~ReferenceComparison() override = default;
+
+  void configure(std::string name) override;
+  Quality check(const MonitorObject* mo) override;
+  void beautify(MonitorObject* mo, Quality checkResult) override;
+  std::string getAcceptedType() override;
+
+  /// \brief Sets the reference of the object for the current activity, instead of retrieving it.
+  void setReference(const MonitorObject* mo, std::shared_ptr<TH1> reference);
+
+ protected:
+  /// \brief Compares the histogram with its reference, which has the same binning. Sets mMessage.
+  virtual Quality compare(const TH1& histo, const TH1& reference) = 0;
+
+  /// \brief Returns the parameter of the check as a double, or the default value if it is not set.
+  double getParameter(const std::string& key, double defaultValue) const;
+
+  /// Summary of the last comparison, displayed by beautify()
+  std::string mMessage;
+
+ private:
+  std::string getReferencePath(const MonitorObject* mo) const;
+  std::shared_ptr<TH1> getReference(const MonitorObject* mo);
+  void dropReferencesOfOtherActivities();
+
+  std::string mReferencePath;
+  std::string mReferenceRun;
+  std::string mDecorationName = "reference";
+  std::unordered_map<std::string /*path*/, std::shared_ptr<TH1>> mReferences; //!
+  Activity mReferencesActivity;                                              //!
+
+  ClassDefOverride(ReferenceComparison, 2)
+};
+
+} // namespace o2::quality_control_modules::common
+
+#endif /* QC_MODULE_COMMON_REFERENCECOMPARISON_H */
@@ -0,0 +1,48 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ReferenceKolmogorov.h
+///
+
+#ifndef QC_MODULE_COMMON_REFERENCEKOLMOGOROV_H
+#define QC_MODULE_COMMON_REFERENCEKOLMOGOROV_H
+
+#include "Common/ReferenceComparison.h"
+
+namespace o2::quality_control_modules::common
+{
+
+/// \brief  Kolmogorov-Smirnov test of the compatibility of the 1D histogram with its reference.
+///
+/// The quality is Bad if the probability of compatibility is below the parameter "minPValue" (default 0.05),
+/// Good otherwise.
+class ReferenceKolmogorov : public ReferenceComparison
+{
+ public:
+  /// Default constructor
+  ReferenceKolmogorov() = default;
+  /// Destructor
+  ~ReferenceKolmogorov() override = default;
+
+  void configure(std::string name) override;
+
+ protected:
+  Quality compare(const TH1& histo, const TH1& reference) override;
+
+ private:
+  double mMinPValue = 0.05;
+
+  ClassDefOverride(ReferenceKolmogorov, 1)
+};
+
+} // namespace o2::quality_control_modules::common
+
+#endif /* QC_MODULE_COMMON_REFERENCEKOLMOGOROV_H */
@@ -22,12 +22,14 @@
 #include <TLine.h>
 #include <TList.h>
 // QC
+#include "QualityControl/Decorations.h"
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/Quality.h"
 
 ClassImp(o2::quality_control_modules::common::MeanIsAbove)
 
   using namespace std;
+using o2::quality_control::checker::getDecoration;
 
 namespace o2::quality_control_modules::common
 {
@@ -45,38 +47,27 @@ void MeanIsAbove::configure(std::string /*name*/)
   mThreshold = 1.0f; // std::stof(configFile.getValue<string>("Checks.checkMeanIsAbove/threshold"));
 }
 
-std::string MeanIsAbove::getAcceptedType() { return "TH1"; }
-
-Quality MeanIsAbove::check(const MonitorObject* mo)
+Quality MeanIsAbove::checkObject(const MonitorObject* /*mo*/, const TH1& histo)
 {
-  auto* th1 = dynamic_cast<TH1*>(mo->getObject());
-  if (!th1) {
-    // TODO
-    return Quality::Null;
-  }
-  if (th1->GetMean() > mThreshold) {
+  if (histo.GetMean() > mThreshold) {
     return Quality::Good;
   }
   return Quality::Bad;
 }
 
-void MeanIsAbove::beautify(MonitorObject* mo, Quality checkResult)
+void MeanIsAbove::beautifyObject(MonitorObject* mo, TH1& histo, Quality checkResult)
 {
   // A line is drawn at the level of the threshold.
   // Its colour depends on the quality.
 
-  if (!this->isObjectCheckable(mo)) {
-    cerr << "object not checkable" << endl;
-    return;
-  }
-
-  auto* th1 = dynamic_cast<TH1*>(mo->getObject());
-
-  Double_t xMin = th1->GetXaxis()->GetXmin();
-  Double_t xMax = th1->GetXaxis()->GetXmax();
-  auto* lineMin = new TLine(xMin, mThreshold, xMax, mThreshold);
+  Double_t xMin = histo.GetXaxis()->GetXmin();
+  Double_t xMax = histo.GetXaxis()->GetXmax();
+  auto* lineMin = getDecoration<TLine>(mo, "threshold");
+  lineMin->SetX1(xMin);
+  lineMin->SetY1(mThreshold);
+  lineMin->SetX2(xMax);
+  lineMin->SetY2(mThreshold);
   lineMin->SetLineWidth(2);
-  th1->GetListOfFunctions()->Add(lineMin);
 
   // set the colour according to the quality
   if (checkResult == Quality::Good) {
@@ -28,28 +28,12 @@ ClassImp(o2::quality_control_modules::common::NonEmpty)
 
   void NonEmpty::configure(std::string /*name*/) {}
 
-  Quality NonEmpty::check(const MonitorObject* mo)
+  Quality NonEmpty::checkObject(const MonitorObject* /*mo*/, const TH1& histo)
   {
-    auto result = Quality::Null;
-
-    // The framework guarantees that the encapsulated object is of the accepted type.
-    auto* histo = dynamic_cast<TH1*>(mo->getObject());
-
-    // assert(histo != nullptr);
-    if (histo != nullptr) {
-      if (histo->GetEntries() > 0) {
-        result = Quality::Good;
-      } else {
-        result = Quality::Bad;
-      }
-    }
-
-    return result;
+    return histo.GetEntries() > 0 ? Quality::Good : Quality::Bad;
   }
 
-  std::string NonEmpty::getAcceptedType() { return "TH1"; }
-
-  void NonEmpty::beautify(MonitorObject* /*mo*/, Quality /*checkResult*/)
+  void NonEmpty::beautifyObject(MonitorObject* /*mo*/, TH1& /*histo*/, Quality /*checkResult*/)
   {
     // NOOP
   }
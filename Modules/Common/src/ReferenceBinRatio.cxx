@@ -0,0 +1,48 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ReferenceBinRatio.cxx
+///
+
+#include "Common/ReferenceBinRatio.h"
+#include "Common/HistogramKernels.h"
+
+// ROOT
+#include <TH1.h>
+#include <TString.h>
+
+ClassImp(o2::quality_control_modules::common::ReferenceBinRatio)
+
+namespace o2::quality_control_modules::common
+{
+
+void ReferenceBinRatio::configure(std::string name)
+{
+  ReferenceComparison::configure(name);
+  mMinRatio = getParameter("minRatio", 0.8);
+  mMaxRatio = getParameter("maxRatio", 1.2);
+  mMinReferenceContent = getParameter("minReferenceContent", 10);
+  mMaxFractionOutside = getParameter("maxFractionOutside", 0.05);
+}
+
+Quality ReferenceBinRatio::compare(const TH1& histo, const TH1& reference)
+{
+  auto counts = kernels::binRatioTest(histo, reference, mMinRatio, mMaxRatio, mMinReferenceContent);
+  if (counts.compared == 0) {
+    mMessage = "No bin to compare with the reference";
+    return Quality::Null;
+  }
+  double fraction = static_cast<double>(counts.outside) / counts.compared;
+  mMessage = Form("%zu/%zu bins outside of [%.2f, %.2f] x reference", counts.outside, counts.compared, mMinRatio, mMaxRatio);
+  return fraction > mMaxFractionOutside ? Quality::Bad : Quality::Good;
+}
+
+} // namespace o2::quality_control_modules::common
@@ -0,0 +1,44 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ReferenceChi2.cxx
+///
+
+#include "Common/ReferenceChi2.h"
+#include "Common/HistogramKernels.h"
+
+// ROOT
+#include <TH1.h>
+#include <TString.h>
+
+ClassImp(o2::quality_control_modules::common::ReferenceChi2)
+
+namespace o2::quality_control_modules::common
+{
+
+void ReferenceChi2::configure(std::string name)
+{
+  ReferenceComparison::configure(name);
+  mMinPValue = getParameter("minPValue", 0.05);
+}
+
+Quality ReferenceChi2::compare(const TH1& histo, const TH1& reference)
+{
+  auto result = kernels::chi2Test(histo, reference);
+  if (result.ndf <= 0) {
+    mMessage = "Empty histogram or reference";
+    return Quality::Null;
+  }
+  mMessage = Form("chi2/ndf = %.2f/%d, p = %.3g", result.chi2, result.ndf, result.pValue);
+  return result.pValue < mMinPValue ? Quality::Bad : Quality::Good;
+}
+
+} // namespace o2::quality_control_modules::common
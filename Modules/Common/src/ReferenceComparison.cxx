@@ -0,0 +1,154 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ReferenceComparison.cxx
+///
+
+#include "Common/ReferenceComparison.h"
+#include "Common/HistogramKernels.h"
+
+// ROOT
+#include <TH1.h>
+#include <TList.h>
+#include <TPaveText.h>
+// QC
+#include "QualityControl/DatabaseInterface.h"
+#include "QualityControl/Decorations.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/Quality.h"
+
+#include <fairlogger/Logger.h>
+#include <boost/algorithm/string/replace.hpp>
+
+ClassImp(o2::quality_control_modules::common::ReferenceComparison)
+
+  using o2::quality_control::checker::getDecoration;
+
+namespace o2::quality_control_modules::common
+{
+
+void ReferenceComparison::configure(std::string name)
+{
+  // several comparisons of the same object each have their decoration
+  mDecorationName = "reference_" + name;
+  mReferencePath = mCustomParameters.count("referencePath") ? mCustomParameters["referencePath"]
+                                                            : "qc/{detector}/{task}/{object}";
+  mReferenceRun = mCustomParameters.count("referenceRun") ? mCustomParameters["referenceRun"] : "";
+}
+
+std::string ReferenceComparison::getAcceptedType() { return "TH1"; }
+
+double ReferenceComparison::getParameter(const std::string& key, double defaultValue) const
+{
+  auto parameter = mCustomParameters.find(key);
+  return parameter != mCustomParameters.end() ? std::stod(parameter->second) : defaultValue;
+}
+
+std::string ReferenceComparison::getReferencePath(const MonitorObject* mo) const
+{
+  std::string path = mReferencePath;
+  boost::algorithm::replace_all(path, "{detector}", mo->getDetectorName());
+  boost::algorithm::replace_all(path, "{task}", mo->getTaskName());
+  boost::algorithm::replace_all(path, "{object}", mo->getName());
+  return path;
+}
+
+void ReferenceComparison::dropReferencesOfOtherActivities()
+{
+  // the references of another activity are not valid anymore
+  if (mReferencesActivity.mId != getActivity().mId || mReferencesActivity.mType != getActivity().mType) {
+    mReferences.clear();
+    mReferencesActivity = getActivity();
+  }
+}
+
+void ReferenceComparison::setReference(const MonitorObject* mo, std::shared_ptr<TH1> reference)
+{
+  dropReferencesOfOtherActivities();
+  mReferences[getReferencePath(mo)] = reference;
+}
+
+std::shared_ptr<TH1> ReferenceComparison::getReference(const MonitorObject* mo)
+{
+  dropReferencesOfOtherActivities();
+  const std::string path = getReferencePath(mo);
+  auto cached = mReferences.find(path);
+  if (cached != mReferences.end()) {
+    return cached->second;
+  }
+
+  std::map<std::string, std::string> metadata;
+  if (!mReferenceRun.empty()) {
+    metadata[o2::quality_control::repository::runMetadataKey] = mReferenceRun;
+  }
+  // the references stored by QC are in its repository, the ones uploaded by hand in the conditions database
+  std::unique_ptr<MonitorObject> referenceMo = retrieveObject(path, metadata);
+  TObject* condition = nullptr;
+  if (referenceMo == nullptr) {
+    condition = retrieveCondition(path, metadata);
+    referenceMo.reset(dynamic_cast<MonitorObject*>(condition));
+  }
+  if (referenceMo != nullptr) {
+    referenceMo->setIsOwner(false);
+    condition = referenceMo->getObject();
+  }
+  std::shared_ptr<TH1> reference;
+  if (auto* histo = dynamic_cast<TH1*>(condition)) {
+    histo->SetDirectory(nullptr);
+    reference.reset(histo);
+  } else {
+    LOG(WARNING) << "No reference histogram found at " << path << ", objects compared with it will have a Null quality";
+    delete condition;
+  }
+  mReferences[path] = reference; // missing references are not retrieved again for this activity
+  return reference;
+}
+
+Quality ReferenceComparison::check(const MonitorObject* mo)
+{
+  mMessage.clear();
+  auto* histo = dynamic_cast<TH1*>(mo->getObject());
+  if (histo == nullptr) {
+    return Quality::Null;
+  }
+  auto reference = getReference(mo);
+  if (!reference) {
+    mMessage = "No reference";
+    return Quality::Null;
+  }
+  if (!kernels::sameBinning(*histo, *reference)) {
+    LOG(ERROR) << "The binning of " << mo->getName() << " differs from the one of its reference";
+    mMessage = "Binning differs from the reference";
+    return Quality::Null;
+  }
+  return compare(*histo, *reference);
+}
+
+void ReferenceComparison::beautify(MonitorObject* mo, Quality checkResult)
+{
+  auto* msg = getDecoration<TPaveText>(mo, mDecorationName, 0.6, 0.75, 0.9, 0.9, "NDC");
+  if (msg == nullptr) {
+    return;
+  }
+  msg->Clear();
+  msg->AddText(mMessage.c_str());
+  if (checkResult == Quality::Good) {
+    msg->SetFillColor(kGreen);
+  } else if (checkResult == Quality::Medium) {
+    msg->SetFillColor(kOrange);
+  } else if (checkResult == Quality::Bad) {
+    msg->SetFillColor(kRed);
+  } else {
+    msg->SetFillColor(kWhite);
+  }
+}
+
+} // namespace o2::quality_control_modules::common
@@ -0,0 +1,48 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ReferenceKolmogorov.cxx
+///
+
+#include "Common/ReferenceKolmogorov.h"
+#include "Common/HistogramKernels.h"
+
+// ROOT
+#include <TH1.h>
+#include <TString.h>
+
+ClassImp(o2::quality_control_modules::common::ReferenceKolmogorov)
+
+namespace o2::quality_control_modules::common
+{
+
+void ReferenceKolmogorov::configure(std::string name)
+{
+  ReferenceComparison::configure(name);
+  mMinPValue = getParameter("minPValue", 0.05);
+}
+
+Quality ReferenceKolmogorov::compare(const TH1& histo, const TH1& reference)
+{
+  if (histo.GetDimension() != 1) {
+    mMessage = "Only 1D histograms are supported";
+    return Quality::Null;
+  }
+  if (kernels::integral(histo) <= 0 || kernels::integral(reference) <= 0) {
+    mMessage = "Empty histogram or reference";
+    return Quality::Null;
+  }
+  double pValue = kernels::kolmogorovTest(histo, reference);
+  mMessage = Form("KS p = %.3g", pValue);
+  return pValue < mMinPValue ? Quality::Bad : Quality::Good;
+}
+
+} // namespace o2::quality_control_modules::common
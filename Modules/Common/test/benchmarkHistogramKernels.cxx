@@ -0,0 +1,74 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkHistogramKernels.cxx
+///
+/// Compares the duration of the histogram kernels with the TH1 methods on a histogram of 1M bins.
+/// It is built with the tests but not run by ctest, the results are checked in testHistogramKernels.
+///
+
+#include "Common/HistogramKernels.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <TH1.h>
+#include <TRandom3.h>
+
+using namespace o2::quality_control_modules::common::kernels;
+
+namespace
+{
+// the average duration (us) of the function over the repetitions
+template <typename Function>
+long long timeIt(int repetitions, Function function)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; i++) {
+    function();
+  }
+  auto duration = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / repetitions;
+}
+} // namespace
+
+int main()
+{
+  const int nbins = 1000000;
+  const int repetitions = 20;
+  TH1F histo("benchmark", "benchmark", nbins, 0, nbins);
+  TRandom3 random(42);
+  for (int bin = 1; bin <= nbins; bin++) {
+    histo.SetBinContent(bin, random.Poisson(3));
+  }
+
+  // the results are accumulated, so that the calls are not optimised away
+  double kernelIntegral = 0, rootIntegral = 0;
+  auto kernelUs = timeIt(repetitions, [&]() { kernelIntegral += integral(histo, 2, nbins); });
+  auto rootUs = timeIt(repetitions, [&]() { rootIntegral += histo.Integral(2, nbins); });
+  std::cout << "Integral of " << nbins << " bins: kernel " << kernelUs << " us, TH1::Integral " << rootUs << " us"
+            << std::endl;
+
+  size_t empty = 0;
+  auto emptyUs = timeIt(repetitions, [&]() { empty += countEmptyBins(histo); });
+  std::cout << "Empty bins: kernel " << emptyUs << " us (" << empty / repetitions << " bins)" << std::endl;
+
+  int kernelMaximum = 0, rootMaximum = 0;
+  auto maximumUs = timeIt(repetitions, [&]() { kernelMaximum += maximumBin(histo); });
+  auto rootMaximumUs = timeIt(repetitions, [&]() { rootMaximum += histo.GetMaximumBin(); });
+  std::cout << "Maximum bin: kernel " << maximumUs << " us, TH1::GetMaximumBin " << rootMaximumUs << " us" << std::endl;
+
+  if (std::abs(kernelIntegral - rootIntegral) > 1e-6 * rootIntegral || kernelMaximum != rootMaximum) {
+    std::cerr << "The kernels and the TH1 methods differ" << std::endl;
+    return 1;
+  }
+  return 0;
+}
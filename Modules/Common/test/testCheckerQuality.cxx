@@ -0,0 +1,149 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCheckerQuality.cxx
+///
+
+#include "Common/NonEmpty.h"
+#include "QualityControl/Checker.h"
+#include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/QualityAggregator.h"
+#include "QualityControl/SparseHistogram.h"
+#include "QualityControl/TrendingExtractor.h"
+#include "TestTemporaryDirectory.h"
+
+#define BOOST_TEST_MODULE CheckerQuality test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <climits>
+#include <TH1F.h>
+#include <TObjArray.h>
+
+using namespace o2::quality_control::checker;
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository;
+
+namespace
+{
+// a histogram of the task "checkedTask" of the detector "TST", checked by NonEmpty
+std::shared_ptr<MonitorObject> makeObject(const char* name, int entries)
+{
+  auto* histo = new TH1F(name, name, 10, 0, 10);
+  histo->SetDirectory(nullptr);
+  for (int i = 0; i < entries; i++) {
+    histo->Fill(5);
+  }
+  auto mo = std::make_shared<MonitorObject>(histo, "checkedTask", "TST");
+  mo->addCheck("nonEmpty", "o2::quality_control_modules::common::NonEmpty");
+  return mo;
+}
+
+// the metadata of the latest stored version of the object
+std::map<std::string, std::string> storedMetadata(DatabaseInterface& database, const std::string& objectName)
+{
+  std::map<std::string, std::string> metadata;
+  auto versions = database.retrieveVersions("qc/TST/checkedTask", objectName, 0, LONG_MAX);
+  while (versions->next()) {
+    metadata = versions->version().metadata;
+  }
+  return metadata;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(checker_quality_aggregation)
+{
+  // the check is found by its dictionary, in the library linked to the test
+  BOOST_REQUIRE(o2::quality_control_modules::common::NonEmpty::Class() != nullptr);
+
+  TestTemporaryDirectory directory("qc_checker_quality");
+  std::shared_ptr<DatabaseInterface> database = DatabaseFactory::create("File");
+  database->connect(directory.path, "", "", "");
+  Checker checker("checker", "checkedTask", "json://unused");
+  checker.setDatabase(database);
+
+  auto filled = makeObject("filled", 10);
+  auto empty = makeObject("empty", 0);
+  checker.process(filled);
+  checker.process(empty);
+  database->flush();
+
+  // the qualities of the checks are kept in the objects
+  BOOST_CHECK_EQUAL(filled->getQuality(), Quality::Good);
+  BOOST_CHECK_EQUAL(empty->getQuality(), Quality::Bad);
+  BOOST_CHECK_EQUAL(storedMetadata(*database, "filled").at("quality"), std::to_string(Quality::Good.getLevel()));
+  BOOST_CHECK_EQUAL(storedMetadata(*database, "empty").at("quality"), std::to_string(Quality::Bad.getLevel()));
+
+  // the aggregator gets the checked objects as the Checker sends them
+  QualityAggregator aggregator("aggregator", { "checkedTask" }, "json://unused");
+  TObjArray checked;
+  checked.Add(new MonitorObject(*filled));
+  checked.Add(new MonitorObject(*empty));
+  auto changed = aggregator.aggregate(checked);
+  BOOST_CHECK_EQUAL(changed.count("global"), 1);
+  BOOST_CHECK_EQUAL(aggregator.getQuality("global/TST/checkedTask/filled"), Quality::Good);
+  BOOST_CHECK_EQUAL(aggregator.getQuality("global/TST/checkedTask"), Quality::Bad);
+  BOOST_CHECK_EQUAL(aggregator.getQuality("global"), Quality::Bad);
+  for (auto* object : checked) {
+    static_cast<MonitorObject*>(object)->setIsOwner(false); // the histograms belong to filled and empty
+  }
+  checked.SetOwner(true);
+}
+
+BOOST_AUTO_TEST_CASE(checker_quality_trending)
+{
+  BOOST_REQUIRE(o2::quality_control_modules::common::NonEmpty::Class() != nullptr);
+
+  TestTemporaryDirectory directory("qc_checker_quality");
+  std::shared_ptr<DatabaseInterface> database = DatabaseFactory::create("File");
+  database->connect(directory.path, "", "", "");
+  Checker checker("checker", "checkedTask", "json://unused");
+  checker.setDatabase(database);
+
+  // the Checker trends the objects once checked, the quality trended is the one of the checks, not Null
+  auto filled = makeObject("filled", 10);
+  auto empty = makeObject("empty", 0);
+  checker.process(filled);
+  checker.process(empty);
+  double value = 0;
+  BOOST_REQUIRE(TrendingExtractor("filled", TrendingExtractor::Type::Quality).extract(*filled, value));
+  BOOST_CHECK_NE(value, Quality::Null.getLevel());
+  BOOST_CHECK_EQUAL(value, Quality::Good.getLevel());
+  BOOST_REQUIRE(TrendingExtractor("empty", TrendingExtractor::Type::Quality).extract(*empty, value));
+  BOOST_CHECK_EQUAL(value, Quality::Bad.getLevel());
+}
+
+BOOST_AUTO_TEST_CASE(checker_quality_sparse)
+{
+  BOOST_REQUIRE(o2::quality_control_modules::common::NonEmpty::Class() != nullptr);
+
+  TestTemporaryDirectory directory("qc_checker_quality");
+  std::shared_ptr<DatabaseInterface> database = DatabaseFactory::create("File");
+  database->connect(directory.path, "", "", "");
+  Checker checker("checker", "checkedTask", "json://unused");
+  checker.setDatabase(database);
+
+  // NonEmpty only accepts TH1, it checks the dense copy of a sparse histogram as the dense histogram itself
+  for (int entries : { 0, 10 }) {
+    auto dense = makeObject(entries == 0 ? "empty" : "filled", entries);
+    auto sparse = std::make_shared<MonitorObject>(*dense);
+    sparse->setObject(SparseHistogram::fromHistogram(*static_cast<TH1*>(dense->getObject())).release());
+    sparse->setIsOwner(true);
+    BOOST_REQUIRE(sparse->getObject() != nullptr);
+    checker.process(dense);
+    checker.process(sparse);
+    BOOST_CHECK_EQUAL(sparse->getQuality(), dense->getQuality());
+    BOOST_CHECK_EQUAL(sparse->getQuality(), entries == 0 ? Quality::Bad : Quality::Good);
+    // the sparse histogram is kept in the object, the dense copy is only checked
+    BOOST_CHECK(dynamic_cast<SparseHistogram*>(sparse->getObject()) != nullptr);
+  }
+}
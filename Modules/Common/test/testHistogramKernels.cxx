@@ -0,0 +1,199 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testHistogramKernels.cxx
+///
+
+#include "Common/HistogramKernels.h"
+
+#define BOOST_TEST_MODULE HistogramKernels test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <TH1.h>
+#include <TH2.h>
+#include <TRandom3.h>
+
+namespace o2::quality_control_modules::common::kernels
+{
+
+// a histogram whose bins are not in a TArray, read through the TH1 API only
+class VectorHistogram : public TH1
+{
+ public:
+  VectorHistogram(const char* name, int nbins, double xlow, double xup)
+    : TH1(name, name, nbins, xlow, xup), mContents(fNcells)
+  {
+  }
+  Double_t RetrieveBinContent(Int_t bin) const override { return mContents.at(bin); }
+  void UpdateBinContent(Int_t bin, Double_t content) override { mContents.at(bin) = content; }
+
+ private:
+  std::vector<double> mContents;
+};
+
+BOOST_AUTO_TEST_CASE(raw_kernels)
+{
+  std::vector<int> data{ 0, 3, 0, 7, 7, 1, 0, 2, 5, 0, 4 };
+  BOOST_CHECK_EQUAL(sum(data.data(), data.size()), 29);
+  BOOST_CHECK_EQUAL(sum(data.data() + 3, 2), 14);
+  BOOST_CHECK_EQUAL(countEmpty(data.data(), data.size()), 4u);
+  BOOST_CHECK_EQUAL(countAbove(data.data(), data.size(), 3), 4u);
+  BOOST_CHECK_EQUAL(maxIndex(data.data(), data.size()), 3u);
+  BOOST_CHECK_EQUAL(maxIndex(data.data(), 0), 0u);
+
+  Moments m = moments(data.data(), data.size(), 0.5, 1.0);
+  double sumwx = 0, sumwx2 = 0;
+  for (size_t i = 0; i < data.size(); i++) {
+    sumwx += data[i] * (i + 0.5);
+    sumwx2 += data[i] * (i + 0.5) * (i + 0.5);
+  }
+  BOOST_CHECK_EQUAL(m.sumw, 29);
+  BOOST_CHECK_CLOSE(m.sumwx, sumwx, 1e-9);
+  BOOST_CHECK_CLOSE(m.sumwx2, sumwx2, 1e-9);
+}
+
+template <typename Histo>
+void compareWithRoot(Histo& histo)
+{
+  TRandom3 random(42);
+  for (int i = 0; i < 10000; i++) {
+    if constexpr (std::is_base_of_v<TH2, Histo>) {
+      histo.Fill(random.Gaus(50, 20), random.Gaus(50, 20));
+    } else {
+      histo.Fill(random.Gaus(50, 20));
+    }
+  }
+  const TH1& base = histo;
+
+  BOOST_CHECK_CLOSE(integral(histo), histo.Integral(), 1e-6);
+  BOOST_CHECK_CLOSE(integral(base), histo.Integral(), 1e-6);
+  BOOST_CHECK_EQUAL(maximumBin(histo), histo.GetMaximumBin());
+  BOOST_CHECK_EQUAL(maximumBin(base), histo.GetMaximumBin());
+
+  size_t empty = 0, above = 0;
+  for (int y = 1; y <= (histo.GetDimension() > 1 ? histo.GetNbinsY() : 1); y++) {
+    for (int x = 1; x <= histo.GetNbinsX(); x++) {
+      int bin = histo.GetDimension() > 1 ? histo.GetBin(x, y) : x;
+      empty += histo.GetBinContent(bin) == 0;
+      above += histo.GetBinContent(bin) > 10.5;
+    }
+  }
+  BOOST_CHECK_EQUAL(countEmptyBins(histo), empty);
+  BOOST_CHECK_EQUAL(countBinsAbove(histo, 10.5), above);
+  BOOST_CHECK_EQUAL(countBinsAbove(base, 10.5), above);
+}
+
+BOOST_AUTO_TEST_CASE(histograms)
+{
+  TH1F th1f("th1f", "th1f", 100, 0, 100);
+  compareWithRoot(th1f);
+  BOOST_CHECK_CLOSE(integral(th1f, 10, 20), th1f.Integral(10, 20), 1e-6);
+  BOOST_CHECK_CLOSE(integral(th1f, 0, 101), th1f.Integral(0, 101), 1e-6);
+  BOOST_CHECK_CLOSE(integral(th1f, -5, 500), th1f.Integral(-5, 500), 1e-6);
+  // nothing left after the clamping
+  BOOST_CHECK_EQUAL(integral(th1f, 200, 300), 0);
+  BOOST_CHECK_EQUAL(th1f.Integral(200, 300), 0);
+
+  TH1I th1i("th1i", "th1i", 123, 0, 100);
+  compareWithRoot(th1i);
+  BOOST_CHECK_EQUAL(countBinsAbove(th1i, -1e12), 123u);
+  BOOST_CHECK_EQUAL(countBinsAbove(th1i, 1e12), 0u);
+
+  TH1D th1d("th1d", "th1d", 77, -20, 120);
+  compareWithRoot(th1d);
+
+  TH2F th2f("th2f", "th2f", 40, 0, 100, 30, 0, 100);
+  compareWithRoot(th2f);
+  BOOST_CHECK_CLOSE(integral(th2f, 5, 15), th2f.Integral(5, 15, 1, 30), 1e-6);
+
+  TH2I th2i("th2i", "th2i", 17, 0, 100, 33, 0, 100);
+  compareWithRoot(th2i);
+
+  VectorHistogram vector("vector", 10, 0, 10);
+  TH1D same("same", "same", 10, 0, 10);
+  for (int bin = 0; bin <= 11; bin++) {
+    vector.SetBinContent(bin, bin % 4);
+    same.SetBinContent(bin, bin % 4);
+  }
+  const TH1& base = vector;
+  BOOST_CHECK_EQUAL(integral(base), same.Integral());
+  BOOST_CHECK_EQUAL(integral(base, 2, 5), same.Integral(2, 5));
+  BOOST_CHECK_EQUAL(countEmptyBins(base), 2u);
+  BOOST_CHECK_EQUAL(countBinsAbove(base, 2.5), 2u);
+  BOOST_CHECK_EQUAL(maximumBin(base), same.GetMaximumBin());
+  BOOST_CHECK_SMALL(chi2Test(base, same).chi2, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(binned_moments)
+{
+  TH1F fixed("fixed", "fixed", 100, -5, 5);
+  fixed.FillRandom("gaus", 10000);
+  Moments m = binnedMoments(fixed);
+  fixed.ResetStats(); // GetMean() and GetRMS() now compute from the bins as well
+  BOOST_CHECK_CLOSE(m.mean(), fixed.GetMean(), 1e-6);
+  BOOST_CHECK_CLOSE(m.rms(), fixed.GetRMS(), 1e-6);
+
+  double edges[] = { 0, 1, 3, 6, 10 };
+  TH1D variable("variable", "variable", 4, edges);
+  variable.Fill(0.5, 2);
+  variable.Fill(4, 3);
+  variable.ResetStats();
+  Moments mv = binnedMoments(variable);
+  BOOST_CHECK_CLOSE(mv.mean(), variable.GetMean(), 1e-9);
+  BOOST_CHECK_CLOSE(mv.rms(), variable.GetRMS(), 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(comparisons)
+{
+  TH1F histo("histo", "histo", 100, -5, 5);
+  TH1D reference("reference", "reference", 100, -5, 5);
+  TRandom3 random(42);
+  for (int i = 0; i < 5000; i++) {
+    histo.Fill(random.Gaus(0, 1));
+    reference.Fill(random.Gaus(0.1, 1));
+  }
+  BOOST_CHECK(sameBinning(histo, reference));
+  TH1F other("other", "other", 50, -5, 5);
+  BOOST_CHECK(!sameBinning(histo, other));
+  // the same number of bins and range, other edges
+  double edges[] = { -5, -4.5, -4, -3.5, -3, 0, 3, 3.5, 4, 4.5, 5 };
+  double moved[] = { -5, -4.5, -4, -3.5, -3, 1, 3, 3.5, 4, 4.5, 5 };
+  TH1F variable("variable", "variable", 10, edges);
+  TH1F movedEdges("movedEdges", "movedEdges", 10, moved);
+  TH1F fixed("fixed", "fixed", 10, -5, 5);
+  BOOST_CHECK(sameBinning(variable, TH1F(variable)));
+  BOOST_CHECK(!sameBinning(variable, movedEdges));
+  BOOST_CHECK(!sameBinning(variable, fixed));
+
+  auto result = chi2Test(histo, reference);
+  int ndf = 0, igood = 0;
+  double chi2 = 0;
+  double pValue = histo.Chi2TestX(&reference, chi2, ndf, igood, "UU");
+  BOOST_CHECK_CLOSE(result.chi2, chi2, 1e-6);
+  BOOST_CHECK_EQUAL(result.ndf, ndf);
+  BOOST_CHECK_CLOSE(result.pValue, pValue, 1e-6);
+
+  BOOST_CHECK_CLOSE(kolmogorovTest(histo, reference), histo.KolmogorovTest(&reference), 1e-6);
+
+  // same shape, twice the statistics: all the ratios are 1
+  TH1F doubled(histo);
+  doubled.Scale(2);
+  auto counts = binRatioTest(doubled, histo, 0.99, 1.01, 0);
+  BOOST_CHECK_EQUAL(counts.outside, 0u);
+  BOOST_CHECK_EQUAL(counts.compared, static_cast<size_t>(histo.GetNbinsX() - countEmptyBins(histo)));
+  counts = binRatioTest(histo, reference, 0.99, 1.01, 50);
+  BOOST_CHECK_GT(counts.outside, 0u);
+  BOOST_CHECK_LT(counts.compared, static_cast<size_t>(histo.GetNbinsX()));
+}
+
+} // namespace o2::quality_control_modules::common::kernels
@@ -20,6 +20,7 @@
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 #include <TH1F.h>
+#include <TLine.h>
 #include <TList.h>
 #include <boost/test/unit_test.hpp>
 
@@ -51,9 +52,12 @@ BOOST_AUTO_TEST_CASE(test_checks)
   check.beautify(&mo, Quality::Null); // add a line
   BOOST_CHECK_EQUAL(1, th1f.GetListOfFunctions()->GetEntries());
 
-  check.beautify(&mo, Quality::Null);
-  // Should update the line, not add one --> TODO THIS FAILS
-  //  BOOST_CHECK_EQUAL(numberFunctions, th1f.GetListOfFunctions()->GetEntries()); // no modifications to the plot
+  check.beautify(&mo, Quality::Good);
+  // Should update the line, not add one
+  BOOST_CHECK_EQUAL(1, th1f.GetListOfFunctions()->GetEntries());
+  auto* line = dynamic_cast<TLine*>(th1f.GetListOfFunctions()->First());
+  BOOST_REQUIRE(line != nullptr);
+  BOOST_CHECK_EQUAL(line->GetLineColor(), kGreen);
 }
 
 BOOST_AUTO_TEST_CASE(test_types)
@@ -0,0 +1,155 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testReferenceComparison.cxx
+///
+
+#include "Common/ReferenceBinRatio.h"
+#include "Common/ReferenceChi2.h"
+#include "Common/ReferenceKolmogorov.h"
+#include "QualityControl/FileDatabase.h"
+#include "TestTemporaryDirectory.h"
+
+#define BOOST_TEST_MODULE ReferenceComparison test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <thread>
+#include <TH1.h>
+#include <TList.h>
+#include <TRandom3.h>
+
+namespace o2::quality_control_modules::common
+{
+
+std::shared_ptr<TH1> makeHistogram(const char* name, double mean, int entries)
+{
+  auto histo = std::make_shared<TH1F>(name, name, 100, -5, 5);
+  histo->SetDirectory(nullptr);
+  TRandom3 random(entries);
+  for (int i = 0; i < entries; i++) {
+    histo->Fill(random.Gaus(mean, 1));
+  }
+  return histo;
+}
+
+void checkComparison(ReferenceComparison& check)
+{
+  check.setCustomParameters(
+    { { "minPValue", "0.01" }, { "minRatio", "0.5" }, { "maxRatio", "1.5" }, { "minReferenceContent", "100" } });
+  check.configure("test");
+
+  auto compatible = makeHistogram("compatible", 0, 100000);
+  auto shifted = makeHistogram("shifted", 1, 100000);
+  MonitorObject mo(compatible.get(), "task");
+  mo.setIsOwner(false);
+
+  // no reference
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Null);
+
+  check.setReference(&mo, makeHistogram("reference", 0, 200000));
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Good);
+  check.beautify(&mo, Quality::Good);
+  check.beautify(&mo, Quality::Good);
+  BOOST_CHECK_EQUAL(compatible->GetListOfFunctions()->GetEntries(), 1);
+
+  mo.setObject(shifted.get());
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Bad);
+
+  TH1F otherBinning("otherBinning", "otherBinning", 10, -5, 5);
+  mo.setObject(&otherBinning);
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Null);
+
+  // the references are cached per activity
+  check.setActivity(Activity(2, 1));
+  mo.setObject(compatible.get());
+  check.setCcdbUrl("");
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Null);
+}
+
+BOOST_AUTO_TEST_CASE(chi2)
+{
+  ReferenceChi2 check;
+  checkComparison(check);
+}
+
+BOOST_AUTO_TEST_CASE(kolmogorov)
+{
+  ReferenceKolmogorov check;
+  checkComparison(check);
+}
+
+BOOST_AUTO_TEST_CASE(bin_ratio)
+{
+  ReferenceBinRatio check;
+  checkComparison(check);
+}
+
+BOOST_AUTO_TEST_CASE(decorations_of_several_comparisons)
+{
+  auto histo = makeHistogram("histo", 0, 100000);
+  MonitorObject mo(histo.get(), "task");
+  mo.setIsOwner(false);
+
+  // each comparison of the object displays its own result
+  ReferenceChi2 chi2;
+  ReferenceKolmogorov kolmogorov;
+  chi2.configure("chi2Check");
+  kolmogorov.configure("kolmogorovCheck");
+  chi2.beautify(&mo, Quality::Good);
+  kolmogorov.beautify(&mo, Quality::Bad);
+  chi2.beautify(&mo, Quality::Good);
+  BOOST_CHECK_EQUAL(histo->GetListOfFunctions()->GetEntries(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(reference_stored_by_qc)
+{
+  using namespace o2::quality_control::repository;
+  TestTemporaryDirectory directory("qc_references");
+  auto database = std::make_shared<FileDatabase>();
+  database->connect(directory.path, "", "", "");
+
+  // the references of two runs, stored as the Checker stores the objects
+  for (const auto& [run, mean] : { std::pair{ "1", 0.0 }, std::pair{ "2", 1.0 } }) {
+    auto histo = makeHistogram("histo", mean, 200000);
+    auto reference = std::make_shared<MonitorObject>(histo.get(), "task", "TST");
+    reference->setIsOwner(false);
+    reference->addMetadata(runMetadataKey, run);
+    database->store(reference);
+    // the versions stored within the same millisecond replace each other
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  auto compatible = makeHistogram("histo", 0, 100000);
+  MonitorObject mo(compatible.get(), "task", "TST");
+  mo.setIsOwner(false);
+  auto checkWith = [&](const std::string& referenceRun) {
+    ReferenceChi2 check;
+    check.setDatabase(database);
+    check.setCustomParameters({ { "minPValue", "0.01" }, { "referenceRun", referenceRun } });
+    check.configure("test");
+    return check.check(&mo);
+  };
+  BOOST_CHECK_EQUAL(checkWith("1"), Quality::Good);
+  BOOST_CHECK_EQUAL(checkWith("2"), Quality::Bad);
+  BOOST_CHECK_EQUAL(checkWith("3"), Quality::Null);
+
+  // the latest reference without a run
+  ReferenceChi2 latest;
+  latest.setDatabase(database);
+  latest.setCustomParameters({ { "minPValue", "0.01" } });
+  latest.configure("test");
+  BOOST_CHECK_EQUAL(latest.check(&mo), Quality::Bad);
+}
+
+} // namespace o2::quality_control_modules::common
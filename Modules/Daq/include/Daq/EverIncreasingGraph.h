@@ -19,11 +19,15 @@
 #include <Common/DataBlock.h>
 
 #include "QualityControl/CheckInterface.h"
+#include "QualityControl/ObjectStates.h"
 
 namespace o2::quality_control_modules::daq
 {
 
-/// \brief  Check whether a plot is empty or not.
+/// \brief  Check that the points of a graph are always increasing.
+///
+/// The graphs only grow during a run, thus the check only looks at the points added since the previous cycle.
+/// It starts over when the graph shrinks or was reset.
 ///
 /// \author Barthelemy von Haller
 class EverIncreasingGraph : public o2::quality_control::checker::CheckInterface
@@ -40,7 +44,15 @@ class EverIncreasingGraph : public o2::quality_control::checker::CheckInterface
   std::string getAcceptedType() override;
 
  private:
+  /// What is known about a graph after the previous cycles.
+  struct GraphState {
+    int validated = 0;       ///< number of points already checked
+    double lastY = 0;        ///< Y of the last point checked
+    bool decreasing = false; ///< a decrease was found among the checked points
+  };
+
   DataBlockId mLastId;
+  o2::quality_control::checker::ObjectStates<GraphState> mStates; //!
 
   ClassDefOverride(EverIncreasingGraph, 1);
 };
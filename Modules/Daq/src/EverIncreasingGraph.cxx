@@ -15,9 +15,11 @@
 
 #include "Daq/EverIncreasingGraph.h"
 
+#include "QualityControl/Decorations.h"
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/Quality.h"
 
+#include <algorithm>
 #include <iostream>
 // ROOT
 #include <TGraph.h>
@@ -26,6 +28,7 @@
 #include <TPaveText.h>
 
 using namespace std;
+using o2::quality_control::checker::getDecoration;
 
 ClassImp(o2::quality_control_modules::daq::EverIncreasingGraph)
 
@@ -36,23 +39,32 @@ ClassImp(o2::quality_control_modules::daq::EverIncreasingGraph)
 
   Quality EverIncreasingGraph::check(const MonitorObject* mo)
   {
-    Quality result = Quality::Good;
     auto* g = dynamic_cast<TGraph*>(mo->getObject());
+    const int nbPoints = g->GetN();
+    const double* ys = g->GetY();
+    GraphState& state = mStates.get(mo);
 
-    // simplistic and inefficient way to check that points are always increasing
-    int nbPoints = g->GetN();
-    double lastY = -DBL_MAX;
-    for (int i = 1; i < nbPoints; i++) {
-      double x, y;
-      g->GetPoint(i, x, y);
-      if (y < lastY) {
-        result = Quality::Bad;
-        break;
+    // the graph was reset (or replaced) since the previous cycle, check all its points again
+    if (state.validated > 0 && (nbPoints < state.validated || ys[state.validated - 1] != state.lastY)) {
+      state = GraphState{};
+    }
+
+    // only the points added since the previous cycle are checked, the first point of the graph is not considered
+    const int first = std::max(state.validated, 1);
+    double lastY = first > 1 ? state.lastY : -DBL_MAX;
+    int i = first;
+    for (; i < nbPoints && !state.decreasing; i++) {
+      if (ys[i] < lastY) {
+        state.decreasing = true;
       }
-      lastY = y;
+      lastY = ys[i];
+    }
+    if (i > first) {
+      state.validated = i;
+      state.lastY = ys[i - 1];
     }
 
-    return result;
+    return state.decreasing ? Quality::Bad : Quality::Good;
   }
 
   std::string EverIncreasingGraph::getAcceptedType() { return "TGraph"; }
@@ -71,7 +83,8 @@ ClassImp(o2::quality_control_modules::daq::EverIncreasingGraph)
       return;
     }
 
-    auto* paveText = new TPaveText(0.3, 0.8, 0.7, 0.95, "NDC");
+    auto* paveText = getDecoration<TPaveText>(mo, "message", 0.3, 0.8, 0.7, 0.95, "NDC");
+    paveText->Clear();
     if (checkResult == Quality::Good) {
       paveText->SetFillColor(kGreen);
       paveText->AddText("No anomalies");
@@ -79,7 +92,6 @@ ClassImp(o2::quality_control_modules::daq::EverIncreasingGraph)
       paveText->SetFillColor(kRed);
       paveText->AddText("Block IDs are not always increasing");
     }
-    g->GetListOfFunctions()->AddLast(paveText);
   }
 
 } // namespace daq::quality_control_modules::daq
@@ -4,6 +4,7 @@
 ///
 
 #include "Daq/DaqTask.h"
+#include "Daq/EverIncreasingGraph.h"
 //#include "QualityControl/TaskFactory.h"
 //#include <TSystem.h>
 
@@ -13,6 +14,7 @@
 
 //#include <TH1.h>
 #include <boost/test/unit_test.hpp>
+#include <TGraph.h>
 
 using namespace std;
 
@@ -44,4 +46,40 @@ BOOST_AUTO_TEST_CASE(instantiate_task)
   //  task.endOfActivity(activity);
 }
 
+BOOST_AUTO_TEST_CASE(ever_increasing_graph)
+{
+  auto* graph = new TGraph();
+  MonitorObject mo(graph, "task");
+  EverIncreasingGraph check;
+  check.configure("test");
+
+  for (int i = 0; i < 10; i++) {
+    graph->SetPoint(i, i, i);
+  }
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Good);
+
+  // only the new points are checked
+  for (int i = 10; i < 20; i++) {
+    graph->SetPoint(i, i, i);
+  }
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Good);
+  graph->SetPoint(20, 20, 5);
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Bad);
+  graph->SetPoint(21, 21, 30);
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Bad);
+
+  // reset and refilled, the decrease is forgotten
+  graph->Set(0);
+  for (int i = 0; i < 30; i++) {
+    graph->SetPoint(i, i, 100 + i);
+  }
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Good);
+
+  // a decrease among the old points is found after a reset
+  graph->SetPoint(5, 5, 0);
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Good); // not visible, point 5 was already checked
+  graph->Set(10);
+  BOOST_CHECK_EQUAL(check.check(&mo), Quality::Bad); // shrunk, all the points are checked again
+}
+
 } // namespace o2::quality_control_modules::daq
@@ -36,6 +36,9 @@ void DigitsQcTask::initialize(o2::framework::InitContext& /*ctx*/)
   mDigitTime = new TH2F("digitTime", "Digit Time", 1000, 0, 1000, 20000, 0., 20000.);
   getObjectsManager()->startPublishing(mDigitAmplitude);
   getObjectsManager()->startPublishing(mDigitTime);
+  // the maps of all the cells are mostly empty, only their filled bins are published
+  getObjectsManager()->setSparse(mDigitAmplitude->GetName());
+  getObjectsManager()->setSparse(mDigitTime->GetName());
   //getObjectsManager()->addCheck(mDigitAmplitude, "checkFromEMCAL", "o2::quality_control_modules::emcal::EMCALCheck",
   //                              "QcEMCAL");
 }
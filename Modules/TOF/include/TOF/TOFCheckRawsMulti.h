@@ -16,7 +16,7 @@
 #ifndef QC_MODULE_TOF_TOFCHECKRAWSMULTI_H
 #define QC_MODULE_TOF_TOFCHECKRAWSMULTI_H
 
-#include "QualityControl/CheckInterface.h"
+#include "QualityControl/TypedCheck.h"
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/Quality.h"
 
@@ -26,7 +26,7 @@ namespace o2::quality_control_modules::tof
 /// \brief  Check whether a plot is empty or not.
 ///
 /// \author Nicolo' Jacazio
-class TOFCheckRawsMulti : public o2::quality_control::checker::CheckInterface
+class TOFCheckRawsMulti : public o2::quality_control::checker::TypedCheck<TH1I>
 {
  public:
   /// Default constructor
@@ -36,9 +36,8 @@ class TOFCheckRawsMulti : public o2::quality_control::checker::CheckInterface
 
   // Override interface
   void configure(std::string name) override;
-  Quality check(const MonitorObject* mo) override;
-  void beautify(MonitorObject* mo, Quality checkResult = Quality::Null) override;
-  std::string getAcceptedType() override;
+  Quality checkObject(const MonitorObject* mo, const TH1I& histo) override;
+  void beautifyObject(MonitorObject* mo, TH1I& histo, Quality checkResult) override;
 
   /// Minumum value of TOF raw hit multiplicity
   Float_t minTOFrawhits;
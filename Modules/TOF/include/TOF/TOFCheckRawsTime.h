@@ -16,7 +16,7 @@
 #ifndef QC_MODULE_TOF_TOFCHECKRAWSTIME_H
 #define QC_MODULE_TOF_TOFCHECKRAWSTIME_H
 
-#include "QualityControl/CheckInterface.h"
+#include "QualityControl/TypedCheck.h"
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/Quality.h"
 
@@ -26,7 +26,7 @@ namespace o2::quality_control_modules::tof
 /// \brief  Check whether a plot is empty or not.
 ///
 /// \author Barthelemy von Haller
-class TOFCheckRawsTime : public o2::quality_control::checker::CheckInterface
+class TOFCheckRawsTime : public o2::quality_control::checker::TypedCheck<TH1F>
 {
  public:
   /// Default constructor
@@ -36,9 +36,8 @@ class TOFCheckRawsTime : public o2::quality_control::checker::CheckInterface
 
   // Override interface
   void configure(std::string name) override;
-  Quality check(const MonitorObject* mo) override;
-  void beautify(MonitorObject* mo, Quality checkResult = Quality::Null) override;
-  std::string getAcceptedType() override;
+  Quality checkObject(const MonitorObject* mo, const TH1F& histo) override;
+  void beautifyObject(MonitorObject* mo, TH1F& histo, Quality checkResult) override;
 
   /// Minimum value for TOF raw time
   Float_t minTOFrawTime;
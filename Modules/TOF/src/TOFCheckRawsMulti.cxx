@@ -14,14 +14,18 @@
 ///
 
 #include "TOF/TOFCheckRawsMulti.h"
+#include "Common/HistogramKernels.h"
 
 // ROOT
 #include <fairlogger/Logger.h>
 #include <TH1.h>
 #include <TList.h>
 #include <TPaveText.h>
+// QC
+#include "QualityControl/Decorations.h"
 
 using namespace std;
+using o2::quality_control::checker::getDecoration;
 
 namespace o2::quality_control_modules::tof
 {
@@ -39,7 +43,7 @@ TOFCheckRawsMulti::~TOFCheckRawsMulti() {}
 
 void TOFCheckRawsMulti::configure(std::string) {}
 
-Quality TOFCheckRawsMulti::check(const MonitorObject* mo)
+Quality TOFCheckRawsMulti::checkObject(const MonitorObject* mo, const TH1I& histo)
 {
   Quality result = Quality::Null;
 
@@ -63,7 +67,6 @@ Quality TOFCheckRawsMulti::check(const MonitorObject* mo)
   //     suffixTrgCl = kTRUE;
   // if ((histname.EndsWith("TOFRawsMulti")) || (histname.Contains("TOFRawsMulti") && suffixTrgCl)) {
   if (mo->getName().find("TOFRawsMulti") != std::string::npos) {
-    auto* h = dynamic_cast<TH1I*>(mo->getObject());
     // if (!suffixTrgCl)
     //   h->SetBit(AliQAv1::GetImageBit(), drawRawsSumImage);
     // if (suffixTrgCl) {
@@ -73,17 +76,18 @@ Quality TOFCheckRawsMulti::check(const MonitorObject* mo)
     //       h->SetBit(AliQAv1::GetImageBit(), kTRUE);
     //   }
     // }
-    if (h->GetEntries() == 0) {
+    if (histo.GetEntries() == 0) {
       result = Quality::Medium;
       // flag = AliQAv1::kWARNING;
     } else {
-      multiMean = h->GetMean();
-      zeroBinIntegral = h->Integral(1, 1);
-      lowMIntegral = h->Integral(1, 10);
-      totIntegral = h->Integral(2, h->GetNbinsX());
+      multiMean = histo.GetMean();
+      // sums run directly over the bins of the TH1I
+      zeroBinIntegral = common::kernels::integral(histo, 1, 1);
+      lowMIntegral = common::kernels::integral(histo, 1, 10);
+      totIntegral = common::kernels::integral(histo, 2, histo.GetNbinsX());
 
       if (totIntegral == 0) { //if only "0 hits per event" bin is filled -> error
-        if (h->GetBinContent(1) > 0) {
+        if (histo.GetBinContent(1) > 0) {
           result = Quality::Medium;
           // flag = AliQAv1::kERROR;
         }
@@ -149,15 +153,13 @@ Quality TOFCheckRawsMulti::check(const MonitorObject* mo)
   return result;
 }
 
-std::string TOFCheckRawsMulti::getAcceptedType() { return "TH1"; }
-
-void TOFCheckRawsMulti::beautify(MonitorObject* mo, Quality checkResult)
+void TOFCheckRawsMulti::beautifyObject(MonitorObject* mo, TH1I& histo, Quality checkResult)
 {
   if (mo->getName().find("TOFRawsMulti") != std::string::npos) {
-    auto* h = dynamic_cast<TH1I*>(mo->getObject());
-    TPaveText* msg = new TPaveText(0.5, 0.5, 0.9, 0.75, "NDC");
-    h->GetListOfFunctions()->Add(msg);
+    // reuse the message of the previous cycles, if any
+    auto* msg = getDecoration<TPaveText>(mo, "msg", 0.5, 0.5, 0.9, 0.75, "NDC");
     msg->SetName(Form("%s_msg", mo->GetName()));
+    msg->Clear();
 
     if (checkResult == Quality::Good) {
       msg->Clear();
@@ -167,7 +169,7 @@ void TOFCheckRawsMulti::beautify(MonitorObject* mo, Quality checkResult)
       msg->AddText("OK!");
       msg->SetFillColor(kGreen);
       //
-      h->SetFillColor(kGreen);
+      histo.SetFillColor(kGreen);
     } else if (checkResult == Quality::Bad) {
       LOG(INFO) << "Quality::Bad, setting to red";
       //
@@ -176,7 +178,7 @@ void TOFCheckRawsMulti::beautify(MonitorObject* mo, Quality checkResult)
       msg->AddText("Call TOF on-call.");
       msg->SetFillColor(kRed);
       //
-      h->SetFillColor(kRed);
+      histo.SetFillColor(kRed);
     } else if (checkResult == Quality::Medium) {
       LOG(INFO) << "Quality::medium, setting to orange";
       //
@@ -185,9 +187,9 @@ void TOFCheckRawsMulti::beautify(MonitorObject* mo, Quality checkResult)
       msg->AddText("check the TOF TWiki");
       msg->SetFillColor(kYellow);
       //
-      h->SetFillColor(kOrange);
+      histo.SetFillColor(kOrange);
     }
-    h->SetLineColor(kBlack);
+    histo.SetLineColor(kBlack);
   }
 }
 
@@ -14,6 +14,7 @@
 ///
 
 #include "TOF/TOFCheckRawsTime.h"
+#include "Common/HistogramKernels.h"
 
 // ROOT
 #include <fairlogger/Logger.h>
@@ -21,8 +22,11 @@
 #include <TList.h>
 #include <TMath.h>
 #include <TPaveText.h>
+// QC
+#include "QualityControl/Decorations.h"
 
 using namespace std;
+using o2::quality_control::checker::getDecoration;
 
 namespace o2::quality_control_modules::tof
 {
@@ -45,7 +49,7 @@ void TOFCheckRawsTime::configure(std::string)
   // }
 }
 
-Quality TOFCheckRawsTime::check(const MonitorObject* mo)
+Quality TOFCheckRawsTime::checkObject(const MonitorObject* mo, const TH1F& histo)
 {
   Quality result = Quality::Null;
 
@@ -53,7 +57,6 @@ Quality TOFCheckRawsTime::check(const MonitorObject* mo)
 
   // if ((histname.EndsWith("RawsTime")) || (histname.Contains("RawsTime") && suffixTrgCl)) {
   if (mo->getName().find("RawsTime") != std::string::npos) {
-    auto* h = dynamic_cast<TH1F*>(mo->getObject());
     // if (!suffixTrgCl)
     //   h->SetBit(AliQAv1::GetImageBit(), drawRawsTimeSumImage);
     // if (suffixTrgCl) {
@@ -63,15 +66,15 @@ Quality TOFCheckRawsTime::check(const MonitorObject* mo)
     //       h->SetBit(AliQAv1::GetImageBit(), kTRUE);
     //   }
     // }
-    if (h->GetEntries() == 0) {
+    if (histo.GetEntries() == 0) {
       result = Quality::Medium;
       // flag = AliQAv1::kWARNING;
     } else {
-      timeMean = h->GetMean();
-      Int_t lowBinId = h->GetXaxis()->FindBin(minTOFrawTime);
-      Int_t highBinId = h->GetXaxis()->FindBin(maxTOFrawTime);
-      peakIntegral = h->Integral(lowBinId, highBinId);
-      totIntegral = h->Integral(1, h->GetNbinsX());
+      timeMean = histo.GetMean();
+      Int_t lowBinId = histo.GetXaxis()->FindFixBin(minTOFrawTime);
+      Int_t highBinId = histo.GetXaxis()->FindFixBin(maxTOFrawTime);
+      peakIntegral = common::kernels::integral(histo, lowBinId, highBinId);
+      totIntegral = common::kernels::integral(histo);
       if ((timeMean > minTOFrawTime) && (timeMean < maxTOFrawTime)) {
 
         result = Quality::Good;
@@ -92,15 +95,13 @@ Quality TOFCheckRawsTime::check(const MonitorObject* mo)
   return result;
 }
 
-std::string TOFCheckRawsTime::getAcceptedType() { return "TH1"; }
-
-void TOFCheckRawsTime::beautify(MonitorObject* mo, Quality checkResult)
+void TOFCheckRawsTime::beautifyObject(MonitorObject* mo, TH1F& histo, Quality checkResult)
 {
   if (mo->getName().find("RawsTime") != std::string::npos) {
-    auto* h = dynamic_cast<TH1F*>(mo->getObject());
-    TPaveText* msg = new TPaveText(0.5, 0.5, 0.9, 0.75, "NDC");
-    h->GetListOfFunctions()->Add(msg);
+    // reuse the message of the previous cycles, if any
+    auto* msg = getDecoration<TPaveText>(mo, "msg", 0.5, 0.5, 0.9, 0.75, "NDC");
     msg->SetName(Form("%s_msg", mo->GetName()));
+    msg->Clear();
 
     if (checkResult == Quality::Good) {
       msg->Clear();
@@ -108,7 +109,7 @@ void TOFCheckRawsTime::beautify(MonitorObject* mo, Quality checkResult)
       msg->AddText(Form("Allowed range: %3.0f-%3.0f ns", minTOFrawTime, maxTOFrawTime));
       msg->SetFillColor(kGreen);
       //
-      h->SetFillColor(kGreen);
+      histo.SetFillColor(kGreen);
     } else if (checkResult == Quality::Bad) {
       LOG(INFO) << "Quality::Bad, setting to red";
       //
@@ -119,7 +120,7 @@ void TOFCheckRawsTime::beautify(MonitorObject* mo, Quality checkResult)
       msg->AddText(Form("Mean = %5.2f ns", timeMean));
       msg->SetFillColor(kRed);
       //
-      h->SetFillColor(kRed);
+      histo.SetFillColor(kRed);
     } else if (checkResult == Quality::Medium) {
       LOG(INFO) << "Quality::medium, setting to orange";
       //
@@ -135,9 +136,9 @@ void TOFCheckRawsTime::beautify(MonitorObject* mo, Quality checkResult)
       // text->AddText("See TOF TWiki.");
       // text->SetFillColor(kYellow);
       //
-      h->SetFillColor(kOrange);
+      histo.SetFillColor(kOrange);
     }
-    h->SetLineColor(kBlack);
+    histo.SetLineColor(kBlack);
   }
 }
 
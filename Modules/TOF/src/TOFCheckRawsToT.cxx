@@ -20,8 +20,11 @@
 #include <TH1.h>
 #include <TList.h>
 #include <TPaveText.h>
+// QC
+#include "QualityControl/Decorations.h"
 
 using namespace std;
+using o2::quality_control::checker::getDecoration;
 
 namespace o2::quality_control_modules::tof
 {
@@ -35,13 +38,12 @@ TOFCheckRawsToT::~TOFCheckRawsToT() {}
 
 void TOFCheckRawsToT::configure(std::string) {}
 
-Quality TOFCheckRawsToT::check(const MonitorObject* mo)
+Quality TOFCheckRawsToT::checkObject(const MonitorObject* mo, const TH1F& histo)
 {
   Quality result = Quality::Null;
 
   // if ((histname.EndsWith("RawsToT")) || (histname.Contains("RawsToT") && suffixTrgCl)) {
   if (mo->getName().find("RawsToT") != std::string::npos) {
-    auto* h = dynamic_cast<TH1F*>(mo->getObject());
     // if (!suffixTrgCl)
     //   h->SetBit(AliQAv1::GetImageBit(), drawRawsToTSumImage);
     // if (suffixTrgCl) {
@@ -51,11 +53,11 @@ Quality TOFCheckRawsToT::check(const MonitorObject* mo)
     //       h->SetBit(AliQAv1::GetImageBit(), kTRUE);
     //   }
     // }
-    if (h->GetEntries() == 0) {
+    if (histo.GetEntries() == 0) {
       result = Quality::Medium;
       // flag = AliQAv1::kWARNING;
     } else {
-      Float_t timeMean = h->GetMean();
+      Float_t timeMean = histo.GetMean();
       if ((timeMean > minTOFrawTot) && (timeMean < maxTOFrawTot)) {
         result = Quality::Good;
         // flag = AliQAv1::kINFO;
@@ -69,15 +71,13 @@ Quality TOFCheckRawsToT::check(const MonitorObject* mo)
   return result;
 }
 
-std::string TOFCheckRawsToT::getAcceptedType() { return "TH1"; }
-
-void TOFCheckRawsToT::beautify(MonitorObject* mo, Quality checkResult)
+void TOFCheckRawsToT::beautifyObject(MonitorObject* mo, TH1F& histo, Quality checkResult)
 {
   if (mo->getName().find("RawsToT") != std::string::npos) {
-    auto* h = dynamic_cast<TH1F*>(mo->getObject());
-    TPaveText* msg = new TPaveText(0.5, 0.5, 0.9, 0.75, "NDC");
-    h->GetListOfFunctions()->Add(msg);
+    // reuse the message of the previous cycles, if any
+    auto* msg = getDecoration<TPaveText>(mo, "msg", 0.5, 0.5, 0.9, 0.75, "NDC");
     msg->SetName(Form("%s_msg", mo->GetName()));
+    msg->Clear();
 
     if (checkResult == Quality::Good) {
       LOG(INFO) << "Quality::Good, setting to green";
@@ -87,7 +87,7 @@ void TOFCheckRawsToT::beautify(MonitorObject* mo, Quality checkResult)
       msg->AddText(Form("Allowed range: %3.1f-%3.1f ns", minTOFrawTot, maxTOFrawTot));
       msg->SetFillColor(kGreen);
       //
-      h->SetFillColor(kGreen);
+      histo.SetFillColor(kGreen);
     } else if (checkResult == Quality::Bad) {
       LOG(INFO) << "Quality::Bad, setting to red";
       //
@@ -97,7 +97,7 @@ void TOFCheckRawsToT::beautify(MonitorObject* mo, Quality checkResult)
       msg->AddText("call TOF on-call.");
       msg->SetFillColor(kRed);
       //
-      h->SetFillColor(kRed);
+      histo.SetFillColor(kRed);
     } else if (checkResult == Quality::Medium) {
       LOG(INFO) << "Quality::medium, setting to orange";
       //
@@ -105,9 +105,9 @@ void TOFCheckRawsToT::beautify(MonitorObject* mo, Quality checkResult)
       msg->AddText("No entries. Check TOF TWiki");
       msg->SetFillColor(kYellow);
       //
-      h->SetFillColor(kOrange);
+      histo.SetFillColor(kOrange);
     }
-    h->SetLineColor(kBlack);
+    histo.SetLineColor(kBlack);
   }
 }
 
@@ -0,0 +1,25 @@
+#ifndef QC_TEST_TESTTEMPORARYDIRECTORY_H
+#define QC_TEST_TESTTEMPORARYDIRECTORY_H
+
+#include <string>
+#include <boost/filesystem.hpp>
+
+/// \brief A new directory for the files of a test, removed with its content at the end of the scope.
+struct TestTemporaryDirectory {
+  explicit TestTemporaryDirectory(const std::string& prefix = "qc_test")
+    : path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path(prefix + "_%%%%%%%%")).string())
+  {
+    boost::filesystem::create_directories(path);
+  }
+  ~TestTemporaryDirectory()
+  {
+    boost::system::error_code error; // a directory left behind does not fail the test
+    boost::filesystem::remove_all(path, error);
+  }
+  TestTemporaryDirectory(const TestTemporaryDirectory&) = delete;
+  TestTemporaryDirectory& operator=(const TestTemporaryDirectory&) = delete;
+
+  std::string path;
+};
+
+#endif